@@ -0,0 +1,67 @@
+/** Algebra plugins, part of the ACTS project
+ *
+ * (c) 2020 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+namespace algebra
+{
+    // Size of a cache line, the default alignment of the containers
+    constexpr std::size_t cache_line_size = 64;
+
+    /** Minimal allocator for over-aligned contiguous storage, e.g. to start
+     *  std::vector data on a cache line boundary
+     *
+     * @tparam value_t the allocated type
+     * @tparam kALIGNMENT the requested alignment, at least alignof(value_t) is used
+     **/
+    template <typename value_t, std::size_t kALIGNMENT = cache_line_size>
+    struct aligned_allocator
+    {
+        using value_type = value_t;
+
+        static constexpr std::size_t alignment = kALIGNMENT > alignof(value_t) ? kALIGNMENT : alignof(value_t);
+
+        template <typename other_t>
+        struct rebind
+        {
+            using other = aligned_allocator<other_t, kALIGNMENT>;
+        };
+
+        aligned_allocator() noexcept = default;
+
+        template <typename other_t>
+        aligned_allocator(const aligned_allocator<other_t, kALIGNMENT> &) noexcept {}
+
+        /** Allocate aligned memory for n objects */
+        value_t *allocate(std::size_t n)
+        {
+            return static_cast<value_t *>(::operator new(n * sizeof(value_t), std::align_val_t(alignment)));
+        }
+
+        /** Release memory that was obtained by allocate() */
+        void deallocate(value_t *p, std::size_t) noexcept
+        {
+            ::operator delete(p, std::align_val_t(alignment));
+        }
+
+        template <typename other_t>
+        bool operator==(const aligned_allocator<other_t, kALIGNMENT> &) const noexcept
+        {
+            return true;
+        }
+
+        template <typename other_t>
+        bool operator!=(const aligned_allocator<other_t, kALIGNMENT> &) const noexcept
+        {
+            return false;
+        }
+    };
+
+} // namespace algebra
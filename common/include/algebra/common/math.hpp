@@ -0,0 +1,366 @@
+/** Algebra plugins, part of the ACTS project
+ *
+ * (c) 2020 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+namespace algebra
+{
+    /** Elementary functions with selectable accuracy for the getters and projections.
+     *
+     *  Every function is a template on the value type, so that the same code serves
+     *  plain scalars (and auto-vectorized loops over them) as well as simd types,
+     *  e.g. Vc::double_v, Vc::float_v or simd::scalar_v. The simd types are reached
+     *  through argument dependent lookup and must provide abs, floor, round, sqrt,
+     *  rsqrt, log, atan2, sincos and iif.
+     *
+     *  The fast approximations are branch-free polynomials with a bounded error:
+     *  - atan2: absolute error < 5e-8
+     *  - atanh: relative error of the logarithm < 1e-10 (scalars)
+     *  - sincos: absolute error < 1e-11 for |x| < 1e5
+     **/
+    namespace math
+    {
+        /// Use the standard library (or the simd library) implementation
+        struct full_precision
+        {
+        };
+
+        /// Use the bounded-error approximations
+        struct fast_precision
+        {
+        };
+
+        /// Whether a type is one of the precision tags
+        template <typename precision_t>
+        inline constexpr bool is_precision_v = std::is_same_v<precision_t, full_precision> or
+                                               std::is_same_v<precision_t, fast_precision>;
+
+#ifdef ALGEBRA_PLUGIN_FAST_MATH
+        using default_precision = fast_precision;
+#else
+        using default_precision = full_precision;
+#endif
+
+        namespace detail
+        {
+            /** Branch-free selection between two values
+             *
+             * @param c the condition, a bool or a simd mask
+             * @param a the value for a true condition
+             * @param b the value for a false condition
+             **/
+            template <typename value_t>
+            inline value_t select(bool c, const value_t &a, const value_t &b)
+            {
+                return c ? a : b;
+            }
+
+            template <typename mask_t, typename value_t,
+                      std::enable_if_t<not std::is_same_v<mask_t, bool>, bool> = true>
+            inline value_t select(const mask_t &c, const value_t &a, const value_t &b)
+            {
+                return iif(c, a, b);
+            }
+
+            /** Natural logarithm of a positive scalar from its exponent and a
+             *  polynomial in the reduced mantissa
+             *
+             * @param x the input value
+             **/
+            template <typename value_t>
+            inline value_t log(const value_t &x)
+            {
+                static_assert(std::is_floating_point_v<value_t>, "Only for scalar types");
+
+                constexpr bool is_double = sizeof(value_t) == sizeof(std::uint64_t);
+                using bits_t = std::conditional_t<is_double, std::uint64_t, std::uint32_t>;
+                constexpr int n_mantissa = std::numeric_limits<value_t>::digits - 1;
+                constexpr bits_t mantissa_mask = (bits_t(1) << n_mantissa) - 1;
+                constexpr bits_t exponent_bias = (bits_t(1) << (sizeof(value_t) * 8 - n_mantissa - 2)) - 1;
+
+                // Split x = 2^e * m with m in [1, 2)
+                bits_t bits;
+                std::memcpy(&bits, &x, sizeof(value_t));
+                value_t e = value_t(static_cast<int>(bits >> n_mantissa) - static_cast<int>(exponent_bias));
+                bits = (bits & mantissa_mask) | (exponent_bias << n_mantissa);
+                value_t m;
+                std::memcpy(&m, &bits, sizeof(value_t));
+
+                // Center the mantissa around 1: m in [sqrt(1/2), sqrt(2))
+                const bool shift = m > value_t(1.4142135623730951);
+                m = shift ? m * value_t(0.5) : m;
+                e = shift ? e + value_t(1.) : e;
+
+                // log(m) = 2 atanh(f) with |f| < 0.172
+                const value_t f = (m - value_t(1.)) / (m + value_t(1.));
+                const value_t s = f * f;
+                const value_t p = value_t(1.) +
+                                  s * (value_t(1. / 3.) +
+                                       s * (value_t(1. / 5.) +
+                                            s * (value_t(1. / 7.) +
+                                                 s * (value_t(1. / 9.) + s * value_t(1. / 11.)))));
+                const value_t r = e * value_t(0.6931471805599453) + value_t(2.) * f * p;
+
+                // The bit manipulation does not cover zero and infinity
+                const value_t inf = std::numeric_limits<value_t>::infinity();
+                return x == value_t(0.) ? -inf : (x == inf ? inf : r);
+            }
+
+        } // namespace detail
+
+        /** Arc tangent of y/x in the range [-pi, pi]
+         *
+         * @param y the ordinate
+         * @param x the abscissa
+         **/
+        template <typename value_t>
+        inline value_t atan2(const value_t &y, const value_t &x, full_precision)
+        {
+            using std::atan2;
+            return atan2(y, x);
+        }
+
+        /** Arc tangent of y/x in the range [-pi, pi]: octant reduction and a minimax
+         *  polynomial of degree 17 (Abramowitz-Stegun 4.4.49)
+         *
+         * @param y the ordinate
+         * @param x the abscissa
+         *
+         * @note atan2(-0, x < 0) yields pi instead of -pi
+         **/
+        template <typename value_t>
+        inline value_t atan2(const value_t &y, const value_t &x, fast_precision)
+        {
+            using std::abs;
+
+            const value_t zero(0.);
+            const value_t ax = abs(x);
+            const value_t ay = abs(y);
+            const auto swap = ay > ax;
+            const value_t num = detail::select(swap, ax, ay);
+            const value_t den = detail::select(swap, ay, ax);
+
+            // a in [0, 1], atan2(0, 0) = 0
+            const value_t a = num / detail::select(den == zero, value_t(1.), den);
+            const value_t s = a * a;
+            value_t r = value_t(0.0028662257);
+            r = r * s + value_t(-0.0161657367);
+            r = r * s + value_t(0.0429096138);
+            r = r * s + value_t(-0.0752896400);
+            r = r * s + value_t(0.1065626393);
+            r = r * s + value_t(-0.1420889944);
+            r = r * s + value_t(0.1999355085);
+            r = r * s + value_t(-0.3333314528);
+            r = a + a * s * r;
+
+            r = detail::select(swap, value_t(1.5707963267948966) - r, r);
+            r = detail::select(x < zero, value_t(3.1415926535897932) - r, r);
+            return detail::select(y < zero, -r, r);
+        }
+
+        template <typename value_t>
+        inline value_t atan2(const value_t &y, const value_t &x)
+        {
+            return atan2(y, x, default_precision{});
+        }
+
+        /** Inverse hyperbolic tangent
+         *
+         * @param x the input value in [-1, 1]
+         **/
+        template <typename value_t>
+        inline value_t atanh(const value_t &x, full_precision)
+        {
+            if constexpr (std::is_floating_point_v<value_t>)
+            {
+                return std::atanh(x);
+            }
+            else
+            {
+                // Not all simd libraries provide atanh, but all of them provide log
+                using std::log;
+                return value_t(0.5) * log((value_t(1.) + x) / (value_t(1.) - x));
+            }
+        }
+
+        /** Inverse hyperbolic tangent, through a fast logarithm for scalars
+         *
+         * @param x the input value in [-1, 1]
+         *
+         * @note simd types use the vectorized logarithm of their library
+         **/
+        template <typename value_t>
+        inline value_t atanh(const value_t &x, fast_precision)
+        {
+            const value_t y = (value_t(1.) + x) / (value_t(1.) - x);
+            if constexpr (std::is_floating_point_v<value_t>)
+            {
+                return value_t(0.5) * detail::log(y);
+            }
+            else
+            {
+                using std::log;
+                return value_t(0.5) * log(y);
+            }
+        }
+
+        template <typename value_t>
+        inline value_t atanh(const value_t &x)
+        {
+            return atanh(x, default_precision{});
+        }
+
+        /** Inverse square root
+         *
+         * @param x the input value
+         **/
+        template <typename value_t>
+        inline value_t rsqrt(const value_t &x, full_precision)
+        {
+            using std::sqrt;
+            return value_t(1.) / sqrt(x);
+        }
+
+        /** Inverse square root: hardware estimate and one Newton-Raphson step for simd
+         *  types. Scalars keep the hardware square root, which is faster than any
+         *  portable software estimate.
+         *
+         * @param x the input value
+         **/
+        template <typename value_t>
+        inline value_t rsqrt(const value_t &x, fast_precision)
+        {
+            if constexpr (std::is_floating_point_v<value_t>)
+            {
+                return value_t(1.) / std::sqrt(x);
+            }
+            else
+            {
+                const value_t y = rsqrt(x);
+                return y * (value_t(1.5) - value_t(0.5) * x * y * y);
+            }
+        }
+
+        template <typename value_t>
+        inline value_t rsqrt(const value_t &x)
+        {
+            return rsqrt(x, default_precision{});
+        }
+
+        /** Square root
+         *
+         * @param x the input value
+         **/
+        template <typename value_t>
+        inline value_t sqrt(const value_t &x, full_precision)
+        {
+            using std::sqrt;
+            return sqrt(x);
+        }
+
+        /** Square root from the fast inverse square root for simd types
+         *
+         * @param x the input value
+         **/
+        template <typename value_t>
+        inline value_t sqrt(const value_t &x, fast_precision)
+        {
+            if constexpr (std::is_floating_point_v<value_t>)
+            {
+                return std::sqrt(x);
+            }
+            else
+            {
+                const value_t zero(0.);
+                return detail::select(x == zero, zero, x * rsqrt(x, fast_precision{}));
+            }
+        }
+
+        template <typename value_t>
+        inline value_t sqrt(const value_t &x)
+        {
+            return sqrt(x, default_precision{});
+        }
+
+        /** Sine and cosine of the same argument
+         *
+         * @param x the input angle
+         * @param s the sine of x
+         * @param c the cosine of x
+         **/
+        template <typename value_t>
+        inline void sincos(const value_t &x, value_t &s, value_t &c, full_precision)
+        {
+            if constexpr (std::is_floating_point_v<value_t>)
+            {
+                s = std::sin(x);
+                c = std::cos(x);
+            }
+            else
+            {
+                sincos(x, &s, &c);
+            }
+        }
+
+        /** Sine and cosine of the same argument: reduction to [-pi/4, pi/4] and
+         *  Taylor polynomials of degree 11 and 12
+         *
+         * @param x the input angle, |x| < 1e5
+         * @param s the sine of x
+         * @param c the cosine of x
+         **/
+        template <typename value_t>
+        inline void sincos(const value_t &x, value_t &s, value_t &c, fast_precision)
+        {
+            using std::abs;
+            using std::floor;
+            using std::round;
+
+            // x = q pi/2 + r, with pi/2 split in two parts for an exact product
+            const value_t q = round(x * value_t(0.6366197723675814));
+            const value_t r = (x - q * value_t(1.5707963267341256)) - q * value_t(6.077100506506192e-11);
+            const value_t r2 = r * r;
+
+            value_t sr = value_t(-2.5052108385441720e-08);
+            sr = sr * r2 + value_t(2.7557319223985893e-06);
+            sr = sr * r2 + value_t(-1.9841269841269841e-04);
+            sr = sr * r2 + value_t(8.3333333333333333e-03);
+            sr = sr * r2 + value_t(-1.6666666666666667e-01);
+            sr = r + r * r2 * sr;
+
+            value_t cr = value_t(2.0876756987868099e-09);
+            cr = cr * r2 + value_t(-2.7557319223985891e-07);
+            cr = cr * r2 + value_t(2.4801587301587302e-05);
+            cr = cr * r2 + value_t(-1.3888888888888889e-03);
+            cr = cr * r2 + value_t(4.1666666666666667e-02);
+            cr = cr * r2 + value_t(-0.5);
+            cr = value_t(1.) + r2 * cr;
+
+            // Quadrant n = q mod 4 in {0, 1, 2, 3}
+            const value_t n = q - value_t(4.) * floor(q * value_t(0.25));
+            const auto odd = abs(n - value_t(2.)) == value_t(1.);
+            const value_t sv = detail::select(odd, cr, sr);
+            const value_t cv = detail::select(odd, sr, cr);
+            s = detail::select(n > value_t(1.5), -sv, sv);
+            c = detail::select(abs(n - value_t(1.5)) < value_t(1.), -cv, cv);
+        }
+
+        template <typename value_t>
+        inline void sincos(const value_t &x, value_t &s, value_t &c)
+        {
+            sincos(x, s, c, default_precision{});
+        }
+
+    } // namespace math
+
+} // namespace algebra
@@ -0,0 +1,109 @@
+/** Algebra plugins, part of the ACTS project
+ *
+ * (c) 2020 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#pragma once
+
+#include "common/transform_kind.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace algebra
+{
+    namespace detail
+    {
+        /** Whether a transform type has a kind and kind-templated kernels, like the plugin
+         *  transform3. Compact transforms have a single kernel.
+         **/
+        template <typename transform_type, typename = void>
+        struct has_transform_kind : std::false_type
+        {
+        };
+
+        template <typename transform_type>
+        struct has_transform_kind<transform_type, std::void_t<decltype(std::declval<const transform_type &>().kind())>>
+            : std::true_type
+        {
+        };
+
+        /** Transform a point into the local 3D frame with the kernel of a given kind, if the
+         *  transform has kind-templated kernels
+         *
+         * @tparam kKIND the kind of the transform, or a more general one
+         **/
+        template <transform_kind kKIND, typename transform_type, typename point_type>
+        inline auto point_to_local(const transform_type &trf, const point_type &p)
+        {
+            if constexpr (has_transform_kind<transform_type>::value)
+            {
+                return trf.template point_to_local<kKIND>(p);
+            }
+            else
+            {
+                return trf.point_to_local(p);
+            }
+        }
+
+        /** Transform a point into the first two coordinates of the local 3D frame with the
+         *  kernel of a given kind, if the transform has kind-templated kernels
+         *
+         * @tparam kKIND the kind of the transform, or a more general one
+         **/
+        template <transform_kind kKIND, typename transform_type, typename point_type>
+        inline auto point_to_local2(const transform_type &trf, const point_type &p)
+        {
+            if constexpr (has_transform_kind<transform_type>::value)
+            {
+                return trf.template point_to_local2<kKIND>(p);
+            }
+            else
+            {
+                return trf.point_to_local2(p);
+            }
+        }
+
+        /** Project a range of points from the global 3D cartesian frame into the local 2D
+         *  frame of a projection. The kind of the transform is dispatched and the (lazy)
+         *  inverse is set up once, outside of the loop.
+         *
+         * @tparam transform_type transform3 or compact_transform3
+         *
+         * @param trf the transform from the global to the local three-dimensional frame
+         * @param points the points in global frame
+         * @param results the local point2s, at least of the size of the input
+         * @param kernel the projection of a single point, called with a transform_kind_constant
+         *        and the point, see detail::point_to_local2 and detail::point_to_local
+         **/
+        template <typename transform_type, typename input_type, typename output_type, typename kernel_type>
+        inline void project_range(const transform_type &trf, const input_type &points, output_type &&results,
+                                  const kernel_type &kernel)
+        {
+            assert(results.size() >= points.size());
+
+            const std::size_t n = points.size();
+            const auto loop = [&](auto kind) {
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    results[i] = kernel(kind, points[i]);
+                }
+            };
+            if constexpr (has_transform_kind<transform_type>::value)
+            {
+                // Computes a lazy inverse before the loop
+                trf.inverse();
+                dispatch_kind(trf.kind(), loop);
+            }
+            else
+            {
+                loop(transform_kind_constant<transform_kind::general>{});
+            }
+        }
+    } // namespace detail
+
+} // namespace algebra
@@ -0,0 +1,231 @@
+/** Algebra plugins, part of the ACTS project
+ *
+ * (c) 2020 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#pragma once
+
+#include "common/math.hpp"
+
+#include <array>
+#include <cmath>
+
+namespace algebra
+{
+    /** Unit quaternion w + x i + y j + z k as a rotation: 4 instead of 9 scalars, and the
+     *  composition of two rotations takes 16 instead of 27 multiplications
+     *
+     * @tparam scalar_t the scalar type
+     **/
+    template <typename scalar_t>
+    struct quaternion
+    {
+        scalar_t w = 1.;
+        scalar_t x = 0.;
+        scalar_t y = 0.;
+        scalar_t z = 0.;
+
+        /** The rotation around an axis
+         *
+         * @param axis the rotation axis, normalized
+         * @param angle the rotation angle
+         **/
+        template <typename vector3_t>
+        static quaternion from_axis_angle(const vector3_t &axis, scalar_t angle)
+        {
+            scalar_t s, c;
+            math::sincos(scalar_t(0.5) * angle, s, c, math::full_precision{});
+            return {c, s * axis[0], s * axis[1], s * axis[2]};
+        }
+
+        /** The quaternion of an orthonormal rotation matrix (Shepperd's method): the
+         *  largest of the four components is computed from the diagonal and the other
+         *  three are derived from it, which keeps the division well conditioned
+         *
+         * @param r the 3x3 rotation in column major order
+         **/
+        static quaternion from_rotation_matrix(const std::array<scalar_t, 9> &r)
+        {
+            // r[3 * c + r] is the element in row r and column c
+            const scalar_t trace = r[0] + r[4] + r[8];
+            quaternion q;
+            if (trace > r[0] and trace > r[4] and trace > r[8])
+            {
+                const scalar_t s = scalar_t(2.) * std::sqrt(scalar_t(1.) + trace);
+                q = {scalar_t(0.25) * s, (r[5] - r[7]) / s, (r[6] - r[2]) / s, (r[1] - r[3]) / s};
+            }
+            else if (r[0] >= r[4] and r[0] >= r[8])
+            {
+                const scalar_t s = scalar_t(2.) * std::sqrt(scalar_t(1.) + r[0] - r[4] - r[8]);
+                q = {(r[5] - r[7]) / s, scalar_t(0.25) * s, (r[3] + r[1]) / s, (r[6] + r[2]) / s};
+            }
+            else if (r[4] >= r[8])
+            {
+                const scalar_t s = scalar_t(2.) * std::sqrt(scalar_t(1.) + r[4] - r[0] - r[8]);
+                q = {(r[6] - r[2]) / s, (r[3] + r[1]) / s, scalar_t(0.25) * s, (r[7] + r[5]) / s};
+            }
+            else
+            {
+                const scalar_t s = scalar_t(2.) * std::sqrt(scalar_t(1.) + r[8] - r[0] - r[4]);
+                q = {(r[1] - r[3]) / s, (r[6] + r[2]) / s, (r[7] + r[5]) / s, scalar_t(0.25) * s};
+            }
+            return q;
+        }
+
+        /** Composition: the result rotates by rhs first and by this quaternion second */
+        quaternion operator*(const quaternion &rhs) const
+        {
+            return {w * rhs.w - x * rhs.x - y * rhs.y - z * rhs.z,
+                    w * rhs.x + x * rhs.w + y * rhs.z - z * rhs.y,
+                    w * rhs.y - x * rhs.z + y * rhs.w + z * rhs.x,
+                    w * rhs.z + x * rhs.y - y * rhs.x + z * rhs.w};
+        }
+
+        /** The inverse rotation */
+        quaternion conjugate() const
+        {
+            return {w, -x, -y, -z};
+        }
+
+        /** The quaternion scaled to unit norm, e.g. to remove the rounding errors
+         *  that accumulate over many compositions
+         **/
+        quaternion normalized() const
+        {
+            const scalar_t n = scalar_t(1.) / std::sqrt(w * w + x * x + y * y + z * z);
+            return {w * n, x * n, y * n, z * n};
+        }
+
+        /** Rotate a vector, as v + w t + (x, y, z) x t with t = 2 (x, y, z) x v
+         *
+         * @param v the vector, needs operator[] and construction from three scalars
+         **/
+        template <typename vector3_t>
+        vector3_t rotate(const vector3_t &v) const
+        {
+            const scalar_t tx = scalar_t(2.) * (y * v[2] - z * v[1]);
+            const scalar_t ty = scalar_t(2.) * (z * v[0] - x * v[2]);
+            const scalar_t tz = scalar_t(2.) * (x * v[1] - y * v[0]);
+            return vector3_t{v[0] + w * tx + y * tz - z * ty,
+                             v[1] + w * ty + z * tx - x * tz,
+                             v[2] + w * tz + x * ty - y * tx};
+        }
+
+        /** @return the 3x3 rotation in column major order */
+        std::array<scalar_t, 9> rotation_matrix() const
+        {
+            const scalar_t xx = x * x, yy = y * y, zz = z * z;
+            const scalar_t xy = x * y, xz = x * z, yz = y * z;
+            const scalar_t wx = w * x, wy = w * y, wz = w * z;
+            return {scalar_t(1.) - scalar_t(2.) * (yy + zz), scalar_t(2.) * (xy + wz), scalar_t(2.) * (xz - wy),
+                    scalar_t(2.) * (xy - wz), scalar_t(1.) - scalar_t(2.) * (xx + zz), scalar_t(2.) * (yz + wx),
+                    scalar_t(2.) * (xz + wy), scalar_t(2.) * (yz - wx), scalar_t(1.) - scalar_t(2.) * (xx + yy)};
+        }
+    };
+
+    /** Spherical linear interpolation between two rotations, along the shorter arc
+     *
+     * @param a the rotation at t = 0
+     * @param b the rotation at t = 1
+     * @param t the interpolation parameter
+     **/
+    template <typename scalar_t>
+    inline quaternion<scalar_t> slerp(const quaternion<scalar_t> &a, const quaternion<scalar_t> &b, scalar_t t)
+    {
+        scalar_t c = a.w * b.w + a.x * b.x + a.y * b.y + a.z * b.z;
+        // q and -q are the same rotation
+        const scalar_t sign = c < scalar_t(0.) ? scalar_t(-1.) : scalar_t(1.);
+        c *= sign;
+
+        scalar_t wa = scalar_t(1.) - t, wb = sign * t;
+        // Close rotations are interpolated linearly, the angle is not resolved
+        if (c < scalar_t(1.) - scalar_t(1e-6))
+        {
+            const scalar_t angle = std::acos(c);
+            const scalar_t s = scalar_t(1.) / std::sin(angle);
+            wa = std::sin(wa * angle) * s;
+            wb = sign * std::sin(t * angle) * s;
+        }
+        return quaternion<scalar_t>{wa * a.w + wb * b.w, wa * a.x + wb * b.x, wa * a.y + wb * b.y,
+                                    wa * a.z + wb * b.z}
+            .normalized();
+    }
+
+    /** Rigid body transform with a quaternion rotation and a translation: 7 scalars
+     *  and no stored inverse. Points are transformed without a rotation matrix.
+     *
+     * @tparam scalar_t the scalar type
+     * @tparam vector3_t the plugin vector type, needs operator[] and construction
+     *         from three scalars
+     **/
+    template <typename scalar_t, typename vector3_t>
+    struct quaternion_transform3
+    {
+        quaternion<scalar_t> _rotation;
+        vector3_t _translation{scalar_t(0.), scalar_t(0.), scalar_t(0.)};
+
+        /** Constructor with arguments: translation and rotation */
+        quaternion_transform3(const vector3_t &t, const quaternion<scalar_t> &q) : _rotation(q), _translation(t) {}
+
+        /** Default contructors: identity */
+        quaternion_transform3() = default;
+
+        /** Composition: the result applies rhs first and this transform second */
+        quaternion_transform3 operator*(const quaternion_transform3 &rhs) const
+        {
+            const vector3_t rt = _rotation.rotate(rhs._translation);
+            return quaternion_transform3(vector3_t{rt[0] + _translation[0], rt[1] + _translation[1],
+                                                   rt[2] + _translation[2]},
+                                         _rotation * rhs._rotation);
+        }
+
+        /** @return the inverse transform */
+        quaternion_transform3 inverse() const
+        {
+            const quaternion<scalar_t> q_inv = _rotation.conjugate();
+            const vector3_t t = q_inv.rotate(_translation);
+            return quaternion_transform3(vector3_t{-t[0], -t[1], -t[2]}, q_inv);
+        }
+
+        /** This method retrieves the rotation of a transform */
+        const quaternion<scalar_t> &rotation() const
+        {
+            return _rotation;
+        }
+
+        /** This method retrieves the translation of a transform */
+        const vector3_t &translation() const
+        {
+            return _translation;
+        }
+
+        /** This method transform from a point from the local 3D cartesian frame to the global 3D cartesian frame */
+        vector3_t point_to_global(const vector3_t &v) const
+        {
+            const vector3_t r = _rotation.rotate(v);
+            return vector3_t{r[0] + _translation[0], r[1] + _translation[1], r[2] + _translation[2]};
+        }
+
+        /** This method transform from a point from the global 3D cartesian frame into the local 3D cartesian frame */
+        vector3_t point_to_local(const vector3_t &v) const
+        {
+            return _rotation.conjugate().rotate(
+                vector3_t{v[0] - _translation[0], v[1] - _translation[1], v[2] - _translation[2]});
+        }
+
+        /** This method transform from a vector from the local 3D cartesian frame to the global 3D cartesian frame */
+        vector3_t vector_to_global(const vector3_t &v) const
+        {
+            return _rotation.rotate(v);
+        }
+
+        /** This method transform from a vector from the global 3D cartesian frame into the local 3D cartesian frame */
+        vector3_t vector_to_local(const vector3_t &v) const
+        {
+            return _rotation.conjugate().rotate(v);
+        }
+    };
+
+} // namespace algebra
@@ -0,0 +1,62 @@
+/** Algebra plugins, part of the ACTS project
+ *
+ * (c) 2020 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#pragma once
+
+#include "common/math.hpp"
+
+#include <array>
+#include <cmath>
+
+namespace algebra
+{
+    /** The rotation matrix of a rotation vector, i.e. of the rotation axis scaled by the
+     *  rotation angle (Rodrigues' formula). This is the usual parametrization of small
+     *  alignment corrections, the result is orthonormal for any angle.
+     *
+     * @param wx the first component of the rotation vector
+     * @param wy the second component of the rotation vector
+     * @param wz the third component of the rotation vector
+     *
+     * @return the 3x3 rotation in column major order
+     **/
+    template <typename scalar_t>
+    inline std::array<scalar_t, 9> rotation_matrix(scalar_t wx, scalar_t wy, scalar_t wz)
+    {
+        const scalar_t angle2 = wx * wx + wy * wy + wz * wz;
+
+        // R = 1 + a [w]x + b [w]x^2 with a = sin(angle)/angle and b = (1 - cos(angle))/angle^2.
+        // Below 0.1 rad, i.e. for all alignment corrections, the Taylor series is exact to
+        // double precision and saves the square root and the trigonometric functions.
+        scalar_t a, b;
+        if (angle2 < scalar_t(1e-2))
+        {
+            a = scalar_t(1.) -
+                angle2 * (scalar_t(1. / 6.) -
+                          angle2 * (scalar_t(1. / 120.) -
+                                    angle2 * (scalar_t(1. / 5040.) - angle2 * scalar_t(1. / 362880.))));
+            b = scalar_t(0.5) -
+                angle2 * (scalar_t(1. / 24.) -
+                          angle2 * (scalar_t(1. / 720.) -
+                                    angle2 * (scalar_t(1. / 40320.) - angle2 * scalar_t(1. / 3628800.))));
+        }
+        else
+        {
+            const scalar_t angle = std::sqrt(angle2);
+            scalar_t s, c;
+            math::sincos(angle, s, c, math::full_precision{});
+            a = s / angle;
+            b = (scalar_t(1.) - c) / angle2;
+        }
+
+        const scalar_t bxy = b * wx * wy, bxz = b * wx * wz, byz = b * wy * wz;
+        return {scalar_t(1.) - b * (wy * wy + wz * wz), bxy + a * wz, bxz - a * wy,
+                bxy - a * wz, scalar_t(1.) - b * (wx * wx + wz * wz), byz + a * wx,
+                bxz + a * wy, byz - a * wx, scalar_t(1.) - b * (wx * wx + wy * wy)};
+    }
+
+} // namespace algebra
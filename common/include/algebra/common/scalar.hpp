@@ -0,0 +1,41 @@
+/** Algebra plugins, part of the ACTS project
+ *
+ * (c) 2020 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#pragma once
+
+/** The scalar type of the stored data, common to all plugins:
+ *  - ALGEBRA_PLUGIN_CUSTOM_SCALARTYPE sets it explicitly
+ *  - ALGEBRA_CUSTOM_SCALARTYPE is the deprecated name of the same setting
+ *  - ALGEBRA_PLUGIN_MIXED_PRECISION defaults it to float
+ *  - double otherwise
+ **/
+#if defined(ALGEBRA_PLUGIN_CUSTOM_SCALARTYPE)
+using algebra_scalar = ALGEBRA_PLUGIN_CUSTOM_SCALARTYPE;
+#elif defined(ALGEBRA_CUSTOM_SCALARTYPE)
+using algebra_scalar = ALGEBRA_CUSTOM_SCALARTYPE;
+#elif defined(ALGEBRA_PLUGIN_MIXED_PRECISION)
+using algebra_scalar = float;
+#else
+using algebra_scalar = double;
+#endif
+
+/** The type in which dot products, determinants and inversions are accumulated
+ *  before the result is rounded back to the scalar type: double in the mixed
+ *  precision mode, the scalar type otherwise.
+ **/
+#ifdef ALGEBRA_PLUGIN_MIXED_PRECISION
+using algebra_accumulator = double;
+#else
+using algebra_accumulator = algebra_scalar;
+#endif
+
+namespace algebra
+{
+    using scalar = algebra_scalar;
+    using accumulator = algebra_accumulator;
+
+} // namespace algebra
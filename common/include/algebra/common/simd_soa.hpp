@@ -0,0 +1,412 @@
+/** Algebra plugins, part of the ACTS project
+ *
+ * (c) 2020 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+#pragma once
+
+#include "common/math.hpp"
+#include "common/simd_types.hpp"
+#include "common/small_matrix.hpp"
+#include "common/spherical.hpp"
+#include "common/symmetric_matrix.hpp"
+
+#include <Vc/Vc>
+
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+namespace algebra {
+
+namespace simd {
+
+  /** Structure-of-arrays vector types for horizontal vectorization: every
+   *  coordinate holds the values of scalar_v::Size vectors, so that one
+   *  operation processes scalar_v::Size points at full lane utilisation.
+   */
+  using vector2_v = Vector2<scalar_v>;
+  using point2_v  = vector2_v;
+  using vector3_v = Vector3<scalar_v>;
+  using point3_v  = vector3_v;
+
+  /** Restricts the structured vector operators to factors that are either
+   *  the coordinate data type itself or a plain arithmetic type (broadcast).
+   */
+  template<typename data_t, typename factor_t>
+  using enable_if_factor_t = std::enable_if_t<std::is_arithmetic_v<factor_t> or
+                                              std::is_same_v<factor_t, data_t>, bool>;
+
+  /** Operator overloads for the structured vector types.
+   *
+   * @tparam data_t the coordinate data type, e.g. scalar_v
+   *
+   * @return a structured vector of the same type
+   */
+  template<typename data_t>
+  inline Vector2<data_t> operator+(const Vector2<data_t> &a, const Vector2<data_t> &b)
+  {
+    return {a.x + b.x, a.y + b.y};
+  }
+
+  template<typename data_t>
+  inline Vector2<data_t> operator-(const Vector2<data_t> &a, const Vector2<data_t> &b)
+  {
+    return {a.x - b.x, a.y - b.y};
+  }
+
+  template<typename data_t, typename factor_t, enable_if_factor_t<data_t, factor_t> = true>
+  inline Vector2<data_t> operator*(const Vector2<data_t> &a, const factor_t &s)
+  {
+    return {a.x * s, a.y * s};
+  }
+
+  template<typename data_t, typename factor_t, enable_if_factor_t<data_t, factor_t> = true>
+  inline Vector2<data_t> operator*(const factor_t &s, const Vector2<data_t> &a)
+  {
+    return {s * a.x, s * a.y};
+  }
+
+  template<typename data_t>
+  inline Vector3<data_t> operator+(const Vector3<data_t> &a, const Vector3<data_t> &b)
+  {
+    return {a.x + b.x, a.y + b.y, a.z + b.z};
+  }
+
+  template<typename data_t>
+  inline Vector3<data_t> operator-(const Vector3<data_t> &a, const Vector3<data_t> &b)
+  {
+    return {a.x - b.x, a.y - b.y, a.z - b.z};
+  }
+
+  template<typename data_t>
+  inline Vector3<data_t> operator-(const Vector3<data_t> &a)
+  {
+    return {-a.x, -a.y, -a.z};
+  }
+
+  template<typename data_t, typename factor_t, enable_if_factor_t<data_t, factor_t> = true>
+  inline Vector3<data_t> operator*(const Vector3<data_t> &a, const factor_t &s)
+  {
+    return {a.x * s, a.y * s, a.z * s};
+  }
+
+  template<typename data_t, typename factor_t, enable_if_factor_t<data_t, factor_t> = true>
+  inline Vector3<data_t> operator*(const factor_t &s, const Vector3<data_t> &a)
+  {
+    return {s * a.x, s * a.y, s * a.z};
+  }
+
+  template<typename data_t, typename factor_t, enable_if_factor_t<data_t, factor_t> = true>
+  inline Vector3<data_t> operator/(const Vector3<data_t> &a, const factor_t &s)
+  {
+    return {a.x / s, a.y / s, a.z / s};
+  }
+
+  /** Load up to scalar_v::Size points from an array-of-structures container into
+   *  a structure-of-arrays vector. Unused lanes are set to zero.
+   *
+   * @tparam container_t random access container of 3D points
+   *
+   * @param points the input points
+   * @param offset index of the first point to be loaded
+   * @param n number of points to be loaded, at most scalar_v::Size
+   *
+   * @return the points in structure-of-arrays layout
+   */
+  template<typename container_t>
+  inline vector3_v load3(const container_t &points, std::size_t offset,
+                         std::size_t n = scalar_v::size())
+  {
+    return {scalar_v::generate([&](auto i) { return static_cast<std::size_t>(i) < n ? scalar(points[offset + i][0]) : scalar(0); }),
+            scalar_v::generate([&](auto i) { return static_cast<std::size_t>(i) < n ? scalar(points[offset + i][1]) : scalar(0); }),
+            scalar_v::generate([&](auto i) { return static_cast<std::size_t>(i) < n ? scalar(points[offset + i][2]) : scalar(0); })};
+  }
+
+  /** Store up to scalar_v::Size points from a structure-of-arrays vector into
+   *  an array-of-structures container.
+   *
+   * @tparam container_t random access container of 3D points
+   *
+   * @param v the structure-of-arrays points
+   * @param points the output container
+   * @param offset index of the first point to be written
+   * @param n number of points to be written, at most scalar_v::Size
+   */
+  template<typename container_t>
+  inline void store3(const vector3_v &v, container_t &points, std::size_t offset,
+                     std::size_t n = scalar_v::size())
+  {
+    using point_t = typename container_t::value_type;
+    for (std::size_t i = 0; i < n; ++i) {
+      points[offset + i] = point_t{v.x[i], v.y[i], v.z[i]};
+    }
+  }
+
+  /** Matrices of scalar_v::Size tracks, e.g. for the Kalman filter: every element holds
+   *  the same element of all tracks, so that one operation updates scalar_v::Size tracks.
+   *  The products, the inversions (matrix::invert, matrix::solve) and the similarity
+   *  transforms (matrix::similarity) of the fixed size matrices apply lane by lane.
+   */
+  template<unsigned int kROWS, unsigned int kCOLS>
+  using matrix_v = small_matrix<scalar_v, kROWS, kCOLS>;
+  template<unsigned int kN>
+  using symmetric_matrix_v = symmetric_matrix<scalar_v, kN>;
+
+  // The mask of the tracks of a batch
+  using mask_v = scalar_v::mask_type;
+
+  /** The batch type of a matrix type, matrix_v or symmetric_matrix_v */
+  template<typename matrix_t>
+  struct batch_of;
+
+  template<unsigned int kROWS, unsigned int kCOLS>
+  struct batch_of<small_matrix<scalar, kROWS, kCOLS>>
+  {
+    using type = matrix_v<kROWS, kCOLS>;
+  };
+
+  template<unsigned int kN>
+  struct batch_of<symmetric_matrix<scalar, kN>>
+  {
+    using type = symmetric_matrix_v<kN>;
+  };
+
+  /** Load up to scalar_v::Size matrices of single tracks into a batch. Unused lanes hold
+   *  the identity, so that the batch can be inverted.
+   *
+   * @tparam container_t random access container of small_matrix or symmetric_matrix
+   *
+   * @param matrices the input matrices
+   * @param offset index of the first matrix to be loaded
+   * @param n number of matrices to be loaded, at most scalar_v::Size
+   *
+   * @return the matrices as one batch
+   */
+  template<typename container_t>
+  inline auto load_matrix(const container_t &matrices, std::size_t offset,
+                          std::size_t n = scalar_v::size())
+  {
+    using matrix_t = typename container_t::value_type;
+    const matrix_t identity = matrix_t::identity();
+    typename batch_of<matrix_t>::type m;
+    for (unsigned int k = 0; k < matrix_t::size; ++k) {
+      m._data[k] = scalar_v::generate([&](auto i) {
+        return static_cast<std::size_t>(i) < n ? matrices[offset + i]._data[k] : identity._data[k]; });
+    }
+    return m;
+  }
+
+  /** Store up to scalar_v::Size matrices of a batch into the matrices of single tracks
+   *
+   * @tparam matrix_v_t the batch type, matrix_v or symmetric_matrix_v
+   * @tparam container_t random access container of small_matrix or symmetric_matrix
+   *
+   * @param m the batch
+   * @param matrices the output container
+   * @param offset index of the first matrix to be written
+   * @param n number of matrices to be written, at most scalar_v::Size
+   */
+  template<typename matrix_v_t, typename container_t>
+  inline void store_matrix(const matrix_v_t &m, container_t &matrices, std::size_t offset,
+                           std::size_t n = scalar_v::size())
+  {
+    for (std::size_t i = 0; i < n; ++i) {
+      for (unsigned int k = 0; k < matrix_v_t::size; ++k) {
+        matrices[offset + i]._data[k] = m._data[k][i];
+      }
+    }
+  }
+
+  /** Lane wise selection between two batches, e.g. to keep the matrices of the tracks
+   *  that have finished: select(active, updated, m)
+   *
+   * @tparam matrix_v_t the batch type, matrix_v or symmetric_matrix_v
+   *
+   * @param mask the lanes that take the first batch
+   * @param a the batch of the selected lanes
+   * @param b the batch of the other lanes
+   */
+  template<typename matrix_v_t>
+  inline matrix_v_t select(const mask_v &mask, const matrix_v_t &a, const matrix_v_t &b)
+  {
+    matrix_v_t m;
+    for (unsigned int k = 0; k < matrix_v_t::size; ++k) {
+      m._data[k] = Vc::iif(mask, a._data[k], b._data[k]);
+    }
+    return m;
+  }
+
+  /** Masked assignment: only the lanes of the mask are written, e.g. the update of the
+   *  tracks that are still active
+   *
+   * @tparam matrix_v_t the batch type, matrix_v or symmetric_matrix_v
+   *
+   * @param mask the lanes to be written
+   * @param m the batch to be written
+   * @param value the new values
+   */
+  template<typename matrix_v_t>
+  inline void assign(const mask_v &mask, matrix_v_t &m, const matrix_v_t &value)
+  {
+    for (unsigned int k = 0; k < matrix_v_t::size; ++k) {
+      m._data[k](mask) = value._data[k];
+    }
+  }
+
+} // namespace simd
+
+namespace vector
+{
+  /** Dot product between two structure-of-arrays vectors
+   *
+   * @tparam data_t the coordinate data type
+   *
+   * @param a the first input vector
+   * @param b the second input vector
+   *
+   * @return the dot products of all lanes
+   **/
+  template <typename data_t>
+  inline data_t dot(const simd::Vector2<data_t> &a, const simd::Vector2<data_t> &b)
+  {
+    return a.x * b.x + a.y * b.y;
+  }
+
+  template <typename data_t>
+  inline data_t dot(const simd::Vector3<data_t> &a, const simd::Vector3<data_t> &b)
+  {
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+  }
+
+  /** Cross product between two structure-of-arrays vectors
+   *
+   * @tparam data_t the coordinate data type
+   *
+   * @param a the first input vector
+   * @param b the second input vector
+   *
+   * @return the cross products of all lanes
+   **/
+  template <typename data_t>
+  inline simd::Vector3<data_t> cross(const simd::Vector3<data_t> &a, const simd::Vector3<data_t> &b)
+  {
+    return {a.y * b.z - b.y * a.z, a.z * b.x - b.z * a.x, a.x * b.y - b.x * a.y};
+  }
+
+  /** Get a normalized version of the input structure-of-arrays vectors
+   *
+   * @tparam data_t the coordinate data type
+   *
+   * @param v the input vector
+   **/
+  template <typename data_t>
+  inline simd::Vector2<data_t> normalize(const simd::Vector2<data_t> &v)
+  {
+    using std::sqrt;
+    const data_t oon = data_t(1.) / sqrt(dot(v, v));
+    return {v.x * oon, v.y * oon};
+  }
+
+  template <typename data_t>
+  inline simd::Vector3<data_t> normalize(const simd::Vector3<data_t> &v)
+  {
+    using std::sqrt;
+    const data_t oon = data_t(1.) / sqrt(dot(v, v));
+    return {v.x * oon, v.y * oon, v.z * oon};
+  }
+
+} // namespace vector
+
+namespace getter
+{
+  /** This method retrieves phi from structure-of-arrays vectors
+   *
+   * @param v the input vector
+   * @param precision the accuracy of the elementary functions
+   **/
+  template <typename data_t, typename precision_t = math::default_precision>
+  inline data_t phi(const simd::Vector2<data_t> &v, precision_t precision = {}) noexcept
+  {
+    return math::atan2(v.y, v.x, precision);
+  }
+
+  template <typename data_t, typename precision_t = math::default_precision>
+  inline data_t phi(const simd::Vector3<data_t> &v, precision_t precision = {}) noexcept
+  {
+    return math::atan2(v.y, v.x, precision);
+  }
+
+  /** This method retrieves the perpendicular magnitude from structure-of-arrays vectors
+   *
+   * @param v the input vector
+   **/
+  template <typename data_t>
+  inline data_t perp(const simd::Vector2<data_t> &v) noexcept
+  {
+    using std::sqrt;
+    return sqrt(v.x * v.x + v.y * v.y);
+  }
+
+  template <typename data_t>
+  inline data_t perp(const simd::Vector3<data_t> &v) noexcept
+  {
+    using std::sqrt;
+    return sqrt(v.x * v.x + v.y * v.y);
+  }
+
+  /** This method retrieves theta from structure-of-arrays vectors
+   *
+   * @param v the input vector
+   * @param precision the accuracy of the elementary functions
+   **/
+  template <typename data_t, typename precision_t = math::default_precision>
+  inline data_t theta(const simd::Vector3<data_t> &v, precision_t precision = {}) noexcept
+  {
+    return math::atan2(perp(v), v.z, precision);
+  }
+
+  /** This method retrieves the norm from structure-of-arrays vectors
+   *
+   * @param v the input vector
+   **/
+  template <typename data_t>
+  inline data_t norm(const simd::Vector2<data_t> &v)
+  {
+    return perp(v);
+  }
+
+  template <typename data_t>
+  inline data_t norm(const simd::Vector3<data_t> &v)
+  {
+    using std::sqrt;
+    return sqrt(vector::dot(v, v));
+  }
+
+  /** This method retrieves the pseudo-rapidity from structure-of-arrays vectors
+   *
+   * @param v the input vector
+   * @param precision the accuracy of the elementary functions
+   **/
+  template <typename data_t, typename precision_t = math::default_precision>
+  inline data_t eta(const simd::Vector3<data_t> &v, precision_t precision = {}) noexcept
+  {
+    return math::atanh(v.z / norm(v), precision);
+  }
+
+  /** This method retrieves phi, theta, eta, perp and norm from structure-of-arrays
+   *  vectors in one pass
+   *
+   * @param v the input vector
+   * @param precision the accuracy of the elementary functions
+   **/
+  template <typename data_t, typename precision_t = math::default_precision>
+  inline spherical_coordinates<data_t> spherical(const simd::Vector3<data_t> &v, precision_t precision = {}) noexcept
+  {
+    return spherical<data_t>(v.x, v.y, v.z, precision);
+  }
+
+} // namespace getter
+
+} // namespace algebra
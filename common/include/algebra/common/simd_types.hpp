@@ -12,17 +12,11 @@
 //#include <vecmem/containers/Vector.hpp>
 //#include <vecmem/memory/host_memory_resource.hpp>
 
-#ifdef ALGEBRA_CUSTOM_SCALARTYPE
-using algebra_scalar = ALGEBRA_CUSTOM_SCALARTYPE;
-using algebra_scalar_v = Vc::Vector<ALGEBRA_CUSTOM_SCALARTYPE>;
-#else
-using algebra_scalar = double;
-using algebra_scalar_v = Vc::double_v;
-#endif
+#include "common/scalar.hpp"
 
-namespace algebra {
+using algebra_scalar_v = Vc::Vector<algebra_scalar>;
 
-using scalar   = algebra_scalar;
+namespace algebra {
 
 // Namespace for simd types
 namespace simd {
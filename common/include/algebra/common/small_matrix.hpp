@@ -0,0 +1,494 @@
+/** Algebra plugins, part of the ACTS project
+ *
+ * (c) 2020 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#pragma once
+
+#include "common/scalar.hpp"
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+
+namespace algebra
+{
+    /** Fixed size matrix for the track parameters and their covariances, e.g. 6x6 bound or
+     *  8x8 free. The elements are stored in one flat column major array: the columns are
+     *  contiguous and the loops over the rows of a column are vectorized.
+     *
+     * @tparam scalar_t the scalar type
+     * @tparam kROWS the number of rows
+     * @tparam kCOLS the number of columns, vectors are kROWS x 1 matrices
+     **/
+    template <typename scalar_t, unsigned int kROWS, unsigned int kCOLS>
+    struct small_matrix
+    {
+        using scalar_type = scalar_t;
+
+        static constexpr unsigned int rows = kROWS;
+        static constexpr unsigned int cols = kCOLS;
+        static constexpr unsigned int size = kROWS * kCOLS;
+
+        std::array<scalar_t, size> _data;
+
+        /** @return the matrix with all elements zero */
+        static constexpr small_matrix zero()
+        {
+            small_matrix m{};
+            return m;
+        }
+
+        /** @return the identity matrix, ones on the diagonal of non-square matrices */
+        static constexpr small_matrix identity()
+        {
+            small_matrix m{};
+            for (unsigned int i = 0; i < kROWS and i < kCOLS; ++i)
+            {
+                m(i, i) = scalar_t(1);
+            }
+            return m;
+        }
+
+        /** Element access
+         *
+         * @param row the row index
+         * @param col the column index
+         **/
+        constexpr scalar_t &operator()(unsigned int row, unsigned int col)
+        {
+            assert(row < kROWS and col < kCOLS);
+            return _data[col * kROWS + row];
+        }
+
+        constexpr const scalar_t &operator()(unsigned int row, unsigned int col) const
+        {
+            assert(row < kROWS and col < kCOLS);
+            return _data[col * kROWS + row];
+        }
+
+        /** Element access of vectors
+         *
+         * @param i the row index
+         **/
+        constexpr scalar_t &operator[](unsigned int i)
+        {
+            static_assert(kCOLS == 1, "Only vectors have a single index");
+            return _data[i];
+        }
+
+        constexpr const scalar_t &operator[](unsigned int i) const
+        {
+            static_assert(kCOLS == 1, "Only vectors have a single index");
+            return _data[i];
+        }
+
+        /** @return a pointer to the first element of a column, the column is contiguous */
+        const scalar_t *column(unsigned int col) const
+        {
+            return _data.data() + col * kROWS;
+        }
+
+        /** @return the transposed matrix */
+        constexpr small_matrix<scalar_t, kCOLS, kROWS> transpose() const
+        {
+            small_matrix<scalar_t, kCOLS, kROWS> t{};
+            for (unsigned int c = 0; c < kCOLS; ++c)
+            {
+                for (unsigned int r = 0; r < kROWS; ++r)
+                {
+                    t._data[r * kCOLS + c] = _data[c * kROWS + r];
+                }
+            }
+            return t;
+        }
+
+        /** Extract a block
+         *
+         * @tparam kBLOCK_ROWS the number of rows of the block
+         * @tparam kBLOCK_COLS the number of columns of the block
+         *
+         * @param row the first row of the block
+         * @param col the first column of the block
+         **/
+        template <unsigned int kBLOCK_ROWS, unsigned int kBLOCK_COLS>
+        constexpr small_matrix<scalar_t, kBLOCK_ROWS, kBLOCK_COLS> block(unsigned int row, unsigned int col) const
+        {
+            static_assert(kBLOCK_ROWS <= kROWS and kBLOCK_COLS <= kCOLS, "The block does not fit");
+            assert(row + kBLOCK_ROWS <= kROWS and col + kBLOCK_COLS <= kCOLS);
+            small_matrix<scalar_t, kBLOCK_ROWS, kBLOCK_COLS> b{};
+            for (unsigned int c = 0; c < kBLOCK_COLS; ++c)
+            {
+                for (unsigned int r = 0; r < kBLOCK_ROWS; ++r)
+                {
+                    b._data[c * kBLOCK_ROWS + r] = _data[(col + c) * kROWS + row + r];
+                }
+            }
+            return b;
+        }
+
+        /** Overwrite a block
+         *
+         * @param row the first row of the block
+         * @param col the first column of the block
+         * @param b the block
+         **/
+        template <unsigned int kBLOCK_ROWS, unsigned int kBLOCK_COLS>
+        constexpr void set_block(unsigned int row, unsigned int col,
+                                 const small_matrix<scalar_t, kBLOCK_ROWS, kBLOCK_COLS> &b)
+        {
+            static_assert(kBLOCK_ROWS <= kROWS and kBLOCK_COLS <= kCOLS, "The block does not fit");
+            assert(row + kBLOCK_ROWS <= kROWS and col + kBLOCK_COLS <= kCOLS);
+            for (unsigned int c = 0; c < kBLOCK_COLS; ++c)
+            {
+                for (unsigned int r = 0; r < kBLOCK_ROWS; ++r)
+                {
+                    _data[(col + c) * kROWS + row + r] = b._data[c * kBLOCK_ROWS + r];
+                }
+            }
+        }
+
+        constexpr small_matrix &operator+=(const small_matrix &rhs)
+        {
+            for (unsigned int i = 0; i < size; ++i)
+            {
+                _data[i] += rhs._data[i];
+            }
+            return *this;
+        }
+
+        constexpr small_matrix &operator-=(const small_matrix &rhs)
+        {
+            for (unsigned int i = 0; i < size; ++i)
+            {
+                _data[i] -= rhs._data[i];
+            }
+            return *this;
+        }
+
+        constexpr small_matrix &operator*=(scalar_t s)
+        {
+            for (unsigned int i = 0; i < size; ++i)
+            {
+                _data[i] *= s;
+            }
+            return *this;
+        }
+
+        constexpr small_matrix &operator/=(scalar_t s)
+        {
+            return *this *= scalar_t(1) / s;
+        }
+
+        constexpr bool operator==(const small_matrix &rhs) const
+        {
+            return _data == rhs._data;
+        }
+
+        constexpr bool operator!=(const small_matrix &rhs) const
+        {
+            return _data != rhs._data;
+        }
+    };
+
+    template <typename scalar_t, unsigned int kROWS, unsigned int kCOLS>
+    constexpr small_matrix<scalar_t, kROWS, kCOLS> operator+(small_matrix<scalar_t, kROWS, kCOLS> a,
+                                                             const small_matrix<scalar_t, kROWS, kCOLS> &b)
+    {
+        return a += b;
+    }
+
+    template <typename scalar_t, unsigned int kROWS, unsigned int kCOLS>
+    constexpr small_matrix<scalar_t, kROWS, kCOLS> operator-(small_matrix<scalar_t, kROWS, kCOLS> a,
+                                                             const small_matrix<scalar_t, kROWS, kCOLS> &b)
+    {
+        return a -= b;
+    }
+
+    template <typename scalar_t, unsigned int kROWS, unsigned int kCOLS>
+    constexpr small_matrix<scalar_t, kROWS, kCOLS> operator-(small_matrix<scalar_t, kROWS, kCOLS> a)
+    {
+        return a *= scalar_t(-1);
+    }
+
+    template <typename scalar_t, unsigned int kROWS, unsigned int kCOLS>
+    constexpr small_matrix<scalar_t, kROWS, kCOLS> operator*(small_matrix<scalar_t, kROWS, kCOLS> a,
+                                                             std::common_type_t<scalar_t> s)
+    {
+        return a *= s;
+    }
+
+    template <typename scalar_t, unsigned int kROWS, unsigned int kCOLS>
+    constexpr small_matrix<scalar_t, kROWS, kCOLS> operator*(std::common_type_t<scalar_t> s,
+                                                             small_matrix<scalar_t, kROWS, kCOLS> a)
+    {
+        return a *= s;
+    }
+
+    template <typename scalar_t, unsigned int kROWS, unsigned int kCOLS>
+    constexpr small_matrix<scalar_t, kROWS, kCOLS> operator/(small_matrix<scalar_t, kROWS, kCOLS> a,
+                                                             std::common_type_t<scalar_t> s)
+    {
+        return a /= s;
+    }
+
+    /** Matrix product: every column of the result is accumulated from the columns of a,
+     *  scaled by the elements of the column of b. All loop bounds are compile time constants,
+     *  the loops are unrolled and the loop over the rows is vectorized.
+     *
+     * @param a the left matrix
+     * @param b the right matrix
+     **/
+    template <typename scalar_t, unsigned int kROWS, unsigned int kINNER, unsigned int kCOLS>
+    constexpr small_matrix<scalar_t, kROWS, kCOLS> operator*(const small_matrix<scalar_t, kROWS, kINNER> &a,
+                                                             const small_matrix<scalar_t, kINNER, kCOLS> &b)
+    {
+        small_matrix<scalar_t, kROWS, kCOLS> m{};
+        for (unsigned int c = 0; c < kCOLS; ++c)
+        {
+            // The column is accumulated in registers and stored once
+            std::array<scalar_t, kROWS> column{};
+            for (unsigned int k = 0; k < kINNER; ++k)
+            {
+                const scalar_t bkc = b._data[c * kINNER + k];
+                for (unsigned int r = 0; r < kROWS; ++r)
+                {
+                    column[r] += a._data[k * kROWS + r] * bkc;
+                }
+            }
+            for (unsigned int r = 0; r < kROWS; ++r)
+            {
+                m._data[c * kROWS + r] = column[r];
+            }
+        }
+        return m;
+    }
+
+    namespace detail
+    {
+        /** The accumulation type of a matrix element type: the accumulator precision for
+         *  arithmetic types, the type itself for simd types, e.g. matrices of simd::scalar_v
+         **/
+        template <typename scalar_t, typename = void>
+        struct accumulator_of
+        {
+            using type = scalar_t;
+        };
+
+        template <typename scalar_t>
+        struct accumulator_of<scalar_t, std::enable_if_t<std::is_arithmetic_v<scalar_t>>>
+        {
+            using type = std::common_type_t<scalar_t, accumulator>;
+        };
+
+        template <typename scalar_t>
+        using accumulator_of_t = typename accumulator_of<scalar_t>::type;
+
+        /** LDL^T decomposition of a symmetric positive definite matrix: L is unit lower
+         *  triangular and D diagonal, no square roots are taken. Only the lower triangle of
+         *  the matrix is read. The decomposition is accumulated in accumulator precision.
+         *
+         * @tparam scalar_t the scalar type of the matrix
+         * @tparam kN the matrix size
+         **/
+        template <typename scalar_t, unsigned int kN>
+        struct ldlt
+        {
+            using accumulator_t = detail::accumulator_of_t<scalar_t>;
+
+            // _l[i][j] for j < i, the unit diagonal is not stored
+            std::array<std::array<accumulator_t, kN>, kN> _l{};
+            std::array<accumulator_t, kN> _d{};
+
+            /** Constructor with arguments: the matrix, e.g. a small_matrix or a symmetric_matrix
+             *
+             * @param a the matrix, accessed as a(row, col)
+             **/
+            template <typename matrix_t>
+            constexpr explicit ldlt(const matrix_t &a)
+            {
+                for (unsigned int j = 0; j < kN; ++j)
+                {
+                    // _l[j][k] * _d[k], reused for the column below the diagonal
+                    std::array<accumulator_t, kN> ld{};
+                    accumulator_t d = a(j, j);
+                    for (unsigned int k = 0; k < j; ++k)
+                    {
+                        ld[k] = _l[j][k] * _d[k];
+                        d -= _l[j][k] * ld[k];
+                    }
+                    _d[j] = d;
+                    const accumulator_t d_inv = accumulator_t(1) / d;
+                    for (unsigned int i = j + 1; i < kN; ++i)
+                    {
+                        accumulator_t l = a(i, j);
+                        for (unsigned int k = 0; k < j; ++k)
+                        {
+                            l -= _l[i][k] * ld[k];
+                        }
+                        _l[i][j] = l * d_inv;
+                    }
+                }
+            }
+
+            /** @return the inverse, A^-1 = L^-T D^-1 L^-1, as a small_matrix or a symmetric_matrix */
+            template <typename matrix_t = small_matrix<scalar_t, kN, kN>>
+            constexpr matrix_t inverse() const
+            {
+                // Inverse of the unit lower triangular matrix, by forward substitution
+                std::array<std::array<accumulator_t, kN>, kN> l_inv{};
+                for (unsigned int j = 0; j < kN; ++j)
+                {
+                    l_inv[j][j] = accumulator_t(1);
+                    for (unsigned int i = j + 1; i < kN; ++i)
+                    {
+                        accumulator_t v = -_l[i][j];
+                        for (unsigned int k = j + 1; k < i; ++k)
+                        {
+                            v -= _l[i][k] * l_inv[k][j];
+                        }
+                        l_inv[i][j] = v;
+                    }
+                }
+
+                matrix_t inv{};
+                for (unsigned int j = 0; j < kN; ++j)
+                {
+                    for (unsigned int i = j; i < kN; ++i)
+                    {
+                        accumulator_t v = 0;
+                        for (unsigned int k = i; k < kN; ++k)
+                        {
+                            v += l_inv[k][i] * l_inv[k][j] / _d[k];
+                        }
+                        inv(i, j) = inv(j, i) = static_cast<scalar_t>(v);
+                    }
+                }
+                return inv;
+            }
+
+            /** @return the solution x of A x = b, for every column of b */
+            template <unsigned int kCOLS>
+            constexpr small_matrix<scalar_t, kN, kCOLS> solve(const small_matrix<scalar_t, kN, kCOLS> &b) const
+            {
+                small_matrix<scalar_t, kN, kCOLS> x{};
+                for (unsigned int c = 0; c < kCOLS; ++c)
+                {
+                    // L y = b, D z = y and L^T x = z
+                    std::array<accumulator_t, kN> y{};
+                    for (unsigned int i = 0; i < kN; ++i)
+                    {
+                        accumulator_t v = b(i, c);
+                        for (unsigned int k = 0; k < i; ++k)
+                        {
+                            v -= _l[i][k] * y[k];
+                        }
+                        y[i] = v;
+                    }
+                    for (unsigned int i = 0; i < kN; ++i)
+                    {
+                        y[i] /= _d[i];
+                    }
+                    for (unsigned int i = kN; i-- > 0;)
+                    {
+                        accumulator_t v = y[i];
+                        for (unsigned int k = i + 1; k < kN; ++k)
+                        {
+                            v -= _l[k][i] * y[k];
+                        }
+                        y[i] = v;
+                        x(i, c) = static_cast<scalar_t>(v);
+                    }
+                }
+                return x;
+            }
+        };
+    } // namespace detail
+
+    // small matrix operations
+    namespace matrix
+    {
+        /** Inverse of a symmetric positive definite matrix, e.g. of a covariance. Up to 3x3
+         *  the inverse is computed in closed form from the cofactors, which also holds for
+         *  any invertible matrix. Larger matrices are inverted with an LDL^T decomposition.
+         *  The result is not finite if the matrix is singular (or not positive definite).
+         *
+         * @param a the matrix
+         **/
+        template <typename scalar_t, unsigned int kN>
+        constexpr small_matrix<scalar_t, kN, kN> invert(const small_matrix<scalar_t, kN, kN> &a)
+        {
+            using accumulator_t = detail::accumulator_of_t<scalar_t>;
+
+            small_matrix<scalar_t, kN, kN> inv{};
+            if constexpr (kN == 1)
+            {
+                inv(0, 0) = scalar_t(1) / a(0, 0);
+            }
+            else if constexpr (kN == 2)
+            {
+                const accumulator_t det_inv =
+                    accumulator_t(1) / (accumulator_t(a(0, 0)) * a(1, 1) - accumulator_t(a(0, 1)) * a(1, 0));
+                inv(0, 0) = static_cast<scalar_t>(a(1, 1) * det_inv);
+                inv(0, 1) = static_cast<scalar_t>(-a(0, 1) * det_inv);
+                inv(1, 0) = static_cast<scalar_t>(-a(1, 0) * det_inv);
+                inv(1, 1) = static_cast<scalar_t>(a(0, 0) * det_inv);
+            }
+            else if constexpr (kN == 3)
+            {
+                // Cofactor of the element (r, c), with the cyclic index permutations
+                const auto cofactor = [&a](unsigned int r, unsigned int c) {
+                    const unsigned int r1 = (r + 1) % 3, r2 = (r + 2) % 3;
+                    const unsigned int c1 = (c + 1) % 3, c2 = (c + 2) % 3;
+                    return accumulator_t(a(r1, c1)) * a(r2, c2) - accumulator_t(a(r1, c2)) * a(r2, c1);
+                };
+                std::array<accumulator_t, 9> cof{};
+                for (unsigned int r = 0; r < 3; ++r)
+                {
+                    for (unsigned int c = 0; c < 3; ++c)
+                    {
+                        cof[3 * r + c] = cofactor(r, c);
+                    }
+                }
+                const accumulator_t det_inv =
+                    accumulator_t(1) / (a(0, 0) * cof[0] + a(0, 1) * cof[1] + a(0, 2) * cof[2]);
+                for (unsigned int r = 0; r < 3; ++r)
+                {
+                    for (unsigned int c = 0; c < 3; ++c)
+                    {
+                        inv(r, c) = static_cast<scalar_t>(cof[3 * c + r] * det_inv);
+                    }
+                }
+            }
+            else
+            {
+                inv = detail::ldlt<scalar_t, kN>(a).inverse();
+            }
+            return inv;
+        }
+
+        /** Solve A x = b for a symmetric positive definite matrix A, without forming the
+         *  inverse from 4x4 on
+         *
+         * @param a the matrix
+         * @param b the right hand side, one system per column
+         **/
+        template <typename scalar_t, unsigned int kN, unsigned int kCOLS>
+        constexpr small_matrix<scalar_t, kN, kCOLS> solve(const small_matrix<scalar_t, kN, kN> &a,
+                                                          const small_matrix<scalar_t, kN, kCOLS> &b)
+        {
+            if constexpr (kN <= 3)
+            {
+                return invert(a) * b;
+            }
+            else
+            {
+                return detail::ldlt<scalar_t, kN>(a).solve(b);
+            }
+        }
+    } // namespace matrix
+
+} // namespace algebra
@@ -0,0 +1,218 @@
+/** Algebra plugins, part of the ACTS project
+ *
+ * (c) 2020 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#pragma once
+
+#include "common/small_matrix.hpp"
+#include "common/symmetric_matrix.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace algebra
+{
+    /** Mask of a block of a kROWS x kCOLS matrix, to compose sparsity patterns
+     *
+     * @param row the first row of the block
+     * @param col the first column of the block
+     * @param n_rows the number of rows of the block
+     * @param n_cols the number of columns of the block
+     **/
+    template <unsigned int kROWS, unsigned int kCOLS>
+    constexpr std::uint64_t block_mask(unsigned int row, unsigned int col, unsigned int n_rows = 1,
+                                       unsigned int n_cols = 1)
+    {
+        static_assert(kROWS * kCOLS <= 64, "The mask has one bit per element");
+        std::uint64_t mask = 0;
+        for (unsigned int r = row; r < row + n_rows and r < kROWS; ++r)
+        {
+            for (unsigned int c = col; c < col + n_cols and c < kCOLS; ++c)
+            {
+                mask |= std::uint64_t(1) << (r * kCOLS + c);
+            }
+        }
+        return mask;
+    }
+
+    /** Compile time sparsity pattern of a matrix, e.g. of the bound to free or the free to
+     *  bound Jacobian: the elements that can be non-zero and, among them, the elements that
+     *  are always one. All other elements are zero and are neither read nor multiplied.
+     *
+     * @tparam kROWS the number of rows
+     * @tparam kCOLS the number of columns
+     * @tparam kNONZERO the mask of the elements that can be non-zero, bit row * kCOLS + col
+     * @tparam kUNIT the mask of the elements that are one, a subset of kNONZERO
+     **/
+    template <unsigned int kROWS, unsigned int kCOLS, std::uint64_t kNONZERO, std::uint64_t kUNIT = 0>
+    struct sparsity_pattern
+    {
+        static_assert(kROWS * kCOLS <= 64, "The mask has one bit per element");
+        static_assert((kUNIT & ~kNONZERO) == 0, "The unit elements have to be non-zero elements");
+
+        static constexpr unsigned int rows = kROWS;
+        static constexpr unsigned int cols = kCOLS;
+
+        /** An element of the pattern */
+        struct entry
+        {
+            unsigned int row;
+            unsigned int col;
+        };
+
+        /** @return whether the element (row, col) can be non-zero */
+        static constexpr bool is_nonzero(unsigned int row, unsigned int col)
+        {
+            return (kNONZERO >> (row * kCOLS + col)) & 1;
+        }
+
+        /** @return whether the element (row, col) is one */
+        static constexpr bool is_unit(unsigned int row, unsigned int col)
+        {
+            return (kUNIT >> (row * kCOLS + col)) & 1;
+        }
+
+        /** @return the elements of a mask, row by row */
+        template <std::uint64_t kMASK>
+        static constexpr auto make_entries()
+        {
+            constexpr unsigned int n = [] {
+                unsigned int count = 0;
+                for (unsigned int i = 0; i < kROWS * kCOLS; ++i)
+                {
+                    count += (kMASK >> i) & 1;
+                }
+                return count;
+            }();
+            std::array<entry, n> e{};
+            unsigned int at = 0;
+            for (unsigned int i = 0; i < kROWS * kCOLS; ++i)
+            {
+                if ((kMASK >> i) & 1)
+                {
+                    e[at++] = entry{i / kCOLS, i % kCOLS};
+                }
+            }
+            return e;
+        }
+
+        // The elements to multiply and the elements that are one
+        static constexpr auto entries = make_entries<kNONZERO & ~kUNIT>();
+        static constexpr auto unit_entries = make_entries<kUNIT>();
+    };
+
+    namespace detail
+    {
+        /** Call a function for every element of a compile time list, with the index of the
+         *  element as std::integral_constant: the calls are unrolled and the element is a
+         *  constant expression in the function
+         **/
+        template <typename function_t, std::size_t... kI>
+        constexpr void unroll(function_t &&f, std::index_sequence<kI...>)
+        {
+            (f(std::integral_constant<std::size_t, kI>{}), ...);
+        }
+
+        /** Similarity transform J C J^T for a Jacobian with a sparsity pattern: the products
+         *  are unrolled over the compile time lists of the pattern elements, so that the
+         *  zero elements are not read and the unit elements are not multiplied. Of J C J^T
+         *  only the lower triangle is computed.
+         *
+         * @tparam pattern_t the sparsity pattern of J
+         * @tparam result_t the symmetric result type, written as result(row, col)
+         *
+         * @param j the matrix J, accessed as j(row, col)
+         * @param c the symmetric matrix C, accessed as c(row, col)
+         **/
+        template <typename pattern_t, typename result_t, typename jacobian_t, typename covariance_t>
+        constexpr result_t sparse_similarity(const jacobian_t &j, const covariance_t &c)
+        {
+            constexpr unsigned int kM = pattern_t::rows;
+            constexpr unsigned int kN = pattern_t::cols;
+            using scalar_t = std::decay_t<decltype(c(0, 0))>;
+            constexpr auto n_entries = std::make_index_sequence<pattern_t::entries.size()>{};
+            constexpr auto n_unit_entries = std::make_index_sequence<pattern_t::unit_entries.size()>{};
+
+            // J C, column major
+            std::array<std::array<scalar_t, kM>, kN> jc{};
+            unroll(
+                [&](auto i) {
+                    constexpr auto e = pattern_t::unit_entries[i];
+                    for (unsigned int col = 0; col < kN; ++col)
+                    {
+                        jc[col][e.row] += c(e.col, col);
+                    }
+                },
+                n_unit_entries);
+            unroll(
+                [&](auto i) {
+                    constexpr auto e = pattern_t::entries[i];
+                    const scalar_t jv = j(e.row, e.col);
+                    for (unsigned int col = 0; col < kN; ++col)
+                    {
+                        jc[col][e.row] += jv * c(e.col, col);
+                    }
+                },
+                n_entries);
+
+            // (J C) J^T, the lower triangle column by column
+            std::array<std::array<scalar_t, kM>, kM> s{};
+            unroll(
+                [&](auto i) {
+                    constexpr auto e = pattern_t::unit_entries[i];
+                    for (unsigned int r = e.row; r < kM; ++r)
+                    {
+                        s[e.row][r] += jc[e.col][r];
+                    }
+                },
+                n_unit_entries);
+            unroll(
+                [&](auto i) {
+                    constexpr auto e = pattern_t::entries[i];
+                    const scalar_t jv = j(e.row, e.col);
+                    for (unsigned int r = e.row; r < kM; ++r)
+                    {
+                        s[e.row][r] += jc[e.col][r] * jv;
+                    }
+                },
+                n_entries);
+
+            result_t result{};
+            for (unsigned int col = 0; col < kM; ++col)
+            {
+                for (unsigned int r = col; r < kM; ++r)
+                {
+                    result(r, col) = s[col][r];
+                }
+            }
+            return result;
+        }
+    } // namespace detail
+
+    // sparse matrix operations
+    namespace matrix
+    {
+        /** Similarity transform J C J^T, e.g. the covariance transport with the bound to free
+         *  Jacobian, that skips the zero elements of J
+         *
+         * @tparam pattern_t the sparsity pattern of J, a sparsity_pattern
+         *
+         * @param j the matrix J, the elements outside of the pattern are not read
+         * @param c the symmetric matrix C
+         **/
+        template <typename pattern_t, typename scalar_t, unsigned int kM, unsigned int kN>
+        constexpr symmetric_matrix<scalar_t, kM> similarity(const small_matrix<scalar_t, kM, kN> &j,
+                                                            const symmetric_matrix<scalar_t, kN> &c)
+        {
+            static_assert(pattern_t::rows == kM and pattern_t::cols == kN, "The pattern does not match the matrix");
+            return detail::sparse_similarity<pattern_t, symmetric_matrix<scalar_t, kM>>(j, c);
+        }
+    } // namespace matrix
+
+} // namespace algebra
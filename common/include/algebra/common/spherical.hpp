@@ -0,0 +1,90 @@
+/** Algebra plugins, part of the ACTS project
+ *
+ * (c) 2020 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#pragma once
+
+#include "common/math.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+
+namespace algebra
+{
+    /** The spherical coordinates of a vector together with its transverse component
+     *
+     * @tparam scalar_t the coordinate type, a scalar or a simd type
+     **/
+    template <typename scalar_t>
+    struct spherical_coordinates
+    {
+        scalar_t phi;
+        scalar_t theta;
+        scalar_t eta;
+        scalar_t perp;
+        scalar_t norm;
+    };
+
+    namespace getter
+    {
+        /** This method retrieves phi, theta, eta, perp and norm from the cartesian
+         *  components in one pass: the transverse and full sums of squares and their
+         *  square roots are computed once and shared
+         *
+         * @param x the first component
+         * @param y the second component
+         * @param z the third component
+         * @param precision the accuracy of the elementary functions
+         **/
+        template <typename scalar_t, typename precision_t = math::default_precision>
+        inline spherical_coordinates<scalar_t> spherical(const scalar_t &x, const scalar_t &y, const scalar_t &z,
+                                                         precision_t precision = {}) noexcept
+        {
+            const scalar_t perp2 = x * x + y * y;
+            const scalar_t perp = math::sqrt(perp2, precision);
+            const scalar_t norm = math::sqrt(perp2 + z * z, precision);
+
+            return {math::atan2(y, x, precision), math::atan2(perp, z, precision),
+                    math::atanh(z / norm, precision), perp, norm};
+        }
+
+        /** This method retrieves phi, theta, eta, perp and norm from a vector with rows >= 3
+         *
+         * @param v the input vector
+         * @param precision the accuracy of the elementary functions
+         **/
+        template <typename vector_type, typename precision_t = math::default_precision,
+                  std::enable_if_t<math::is_precision_v<precision_t>, bool> = true>
+        inline auto spherical(const vector_type &v, precision_t precision = {}) noexcept
+        {
+            using scalar_t = std::decay_t<decltype(v[0] * v[0])>;
+            return spherical<scalar_t>(v[0], v[1], v[2], precision);
+        }
+
+        /** This method retrieves phi, theta, eta, perp and norm from a range of vectors
+         *
+         * @param vectors the input vectors
+         * @param results the output coordinates, at least of the size of the input
+         * @param precision the accuracy of the elementary functions
+         **/
+        template <typename input_type, typename output_type, typename precision_t = math::default_precision,
+                  std::enable_if_t<math::is_precision_v<precision_t> and
+                                       not math::is_precision_v<std::decay_t<output_type>>, bool> = true>
+        inline void spherical(const input_type &vectors, output_type &&results, precision_t precision = {}) noexcept
+        {
+            assert(results.size() >= vectors.size());
+
+            const std::size_t n = vectors.size();
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                results[i] = spherical(vectors[i], precision);
+            }
+        }
+
+    } // namespace getter
+
+} // namespace algebra
@@ -0,0 +1,277 @@
+/** Algebra plugins, part of the ACTS project
+ *
+ * (c) 2020 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#pragma once
+
+#include "common/scalar.hpp"
+#include "common/small_matrix.hpp"
+
+#include <array>
+#include <cassert>
+#include <type_traits>
+
+namespace algebra
+{
+    /** Symmetric matrix with packed storage, e.g. for covariances: only the lower triangle
+     *  is stored, row by row, i.e. 21 instead of 36 scalars for a 6x6 matrix. The elements
+     *  (row, col) and (col, row) are the same element.
+     *
+     * @tparam scalar_t the scalar type
+     * @tparam kN the matrix size
+     **/
+    template <typename scalar_t, unsigned int kN>
+    struct symmetric_matrix
+    {
+        using scalar_type = scalar_t;
+
+        static constexpr unsigned int rows = kN;
+        static constexpr unsigned int cols = kN;
+        static constexpr unsigned int size = kN * (kN + 1) / 2;
+
+        std::array<scalar_t, size> _data;
+
+        /** @return the position of the element (row, col) in the packed storage */
+        static constexpr unsigned int index(unsigned int row, unsigned int col)
+        {
+            assert(row < kN and col < kN);
+            return row >= col ? row * (row + 1) / 2 + col : col * (col + 1) / 2 + row;
+        }
+
+        /** @return the matrix with all elements zero */
+        static constexpr symmetric_matrix zero()
+        {
+            symmetric_matrix m{};
+            return m;
+        }
+
+        /** @return the identity matrix */
+        static constexpr symmetric_matrix identity()
+        {
+            symmetric_matrix m{};
+            for (unsigned int i = 0; i < kN; ++i)
+            {
+                m(i, i) = scalar_t(1);
+            }
+            return m;
+        }
+
+        /** The symmetric matrix of the lower triangle of a square matrix
+         *
+         * @param m the matrix, the upper triangle is not read
+         **/
+        static constexpr symmetric_matrix from_lower(const small_matrix<scalar_t, kN, kN> &m)
+        {
+            symmetric_matrix s{};
+            for (unsigned int r = 0; r < kN; ++r)
+            {
+                for (unsigned int c = 0; c <= r; ++c)
+                {
+                    s._data[r * (r + 1) / 2 + c] = m(r, c);
+                }
+            }
+            return s;
+        }
+
+        /** Element access, symmetric
+         *
+         * @param row the row index
+         * @param col the column index
+         **/
+        constexpr scalar_t &operator()(unsigned int row, unsigned int col)
+        {
+            return _data[index(row, col)];
+        }
+
+        constexpr const scalar_t &operator()(unsigned int row, unsigned int col) const
+        {
+            return _data[index(row, col)];
+        }
+
+        /** @return the matrix with both triangles stored */
+        constexpr small_matrix<scalar_t, kN, kN> full() const
+        {
+            small_matrix<scalar_t, kN, kN> m{};
+            for (unsigned int r = 0; r < kN; ++r)
+            {
+                for (unsigned int c = 0; c <= r; ++c)
+                {
+                    m(r, c) = m(c, r) = _data[r * (r + 1) / 2 + c];
+                }
+            }
+            return m;
+        }
+
+        /** Element wise operations, on the packed storage */
+        constexpr symmetric_matrix &operator+=(const symmetric_matrix &rhs)
+        {
+            for (unsigned int i = 0; i < size; ++i)
+            {
+                _data[i] += rhs._data[i];
+            }
+            return *this;
+        }
+
+        constexpr symmetric_matrix &operator-=(const symmetric_matrix &rhs)
+        {
+            for (unsigned int i = 0; i < size; ++i)
+            {
+                _data[i] -= rhs._data[i];
+            }
+            return *this;
+        }
+
+        constexpr symmetric_matrix &operator*=(scalar_t s)
+        {
+            for (unsigned int i = 0; i < size; ++i)
+            {
+                _data[i] *= s;
+            }
+            return *this;
+        }
+
+        constexpr symmetric_matrix &operator/=(scalar_t s)
+        {
+            return *this *= scalar_t(1) / s;
+        }
+
+        constexpr bool operator==(const symmetric_matrix &rhs) const
+        {
+            return _data == rhs._data;
+        }
+
+        constexpr bool operator!=(const symmetric_matrix &rhs) const
+        {
+            return not(*this == rhs);
+        }
+    };
+
+    template <typename scalar_t, unsigned int kN>
+    constexpr symmetric_matrix<scalar_t, kN> operator+(symmetric_matrix<scalar_t, kN> a,
+                                                       const symmetric_matrix<scalar_t, kN> &b)
+    {
+        return a += b;
+    }
+
+    template <typename scalar_t, unsigned int kN>
+    constexpr symmetric_matrix<scalar_t, kN> operator-(symmetric_matrix<scalar_t, kN> a,
+                                                       const symmetric_matrix<scalar_t, kN> &b)
+    {
+        return a -= b;
+    }
+
+    template <typename scalar_t, unsigned int kN>
+    constexpr symmetric_matrix<scalar_t, kN> operator*(std::common_type_t<scalar_t> s,
+                                                       symmetric_matrix<scalar_t, kN> a)
+    {
+        return a *= s;
+    }
+
+    template <typename scalar_t, unsigned int kN>
+    constexpr symmetric_matrix<scalar_t, kN> operator*(symmetric_matrix<scalar_t, kN> a,
+                                                       std::common_type_t<scalar_t> s)
+    {
+        return a *= s;
+    }
+
+    template <typename scalar_t, unsigned int kN>
+    constexpr symmetric_matrix<scalar_t, kN> operator/(symmetric_matrix<scalar_t, kN> a,
+                                                       std::common_type_t<scalar_t> s)
+    {
+        return a /= s;
+    }
+
+    namespace detail
+    {
+        /** Similarity transform J C J^T of a symmetric matrix: J C is computed column by
+         *  column from the packed C, and of J C J^T only the lower triangle is computed.
+         *
+         * @tparam kM the number of rows of J
+         *
+         * @param j the matrix J, any kM x kN matrix accessed as j(row, col)
+         * @param c the symmetric matrix C
+         **/
+        template <unsigned int kM, typename jacobian_t, typename scalar_t, unsigned int kN>
+        constexpr symmetric_matrix<scalar_t, kM> similarity(const jacobian_t &j, const symmetric_matrix<scalar_t, kN> &c)
+        {
+            // J C, column major
+            std::array<std::array<scalar_t, kM>, kN> jc{};
+            for (unsigned int col = 0; col < kN; ++col)
+            {
+                for (unsigned int k = 0; k < kN; ++k)
+                {
+                    const scalar_t ckc = c(k, col);
+                    for (unsigned int r = 0; r < kM; ++r)
+                    {
+                        jc[col][r] += j(r, k) * ckc;
+                    }
+                }
+            }
+
+            symmetric_matrix<scalar_t, kM> s{};
+            for (unsigned int r = 0; r < kM; ++r)
+            {
+                for (unsigned int col = 0; col <= r; ++col)
+                {
+                    scalar_t v = 0;
+                    for (unsigned int k = 0; k < kN; ++k)
+                    {
+                        v += jc[k][r] * j(col, k);
+                    }
+                    s._data[r * (r + 1) / 2 + col] = v;
+                }
+            }
+            return s;
+        }
+    } // namespace detail
+
+    // symmetric matrix operations
+    namespace matrix
+    {
+        /** Similarity transform J C J^T, e.g. the transport of a covariance with the Jacobian J
+         *
+         * @param j the matrix J
+         * @param c the symmetric matrix C
+         **/
+        template <typename scalar_t, unsigned int kM, unsigned int kN>
+        constexpr symmetric_matrix<scalar_t, kM> similarity(const small_matrix<scalar_t, kM, kN> &j,
+                                                            const symmetric_matrix<scalar_t, kN> &c)
+        {
+            return detail::similarity<kM>(j, c);
+        }
+
+        /** Inverse of a symmetric positive definite matrix, only the lower triangle is
+         *  computed: in closed form up to 2x2 and with an LDL^T decomposition above
+         *
+         * @param a the matrix
+         **/
+        template <typename scalar_t, unsigned int kN>
+        constexpr symmetric_matrix<scalar_t, kN> invert(const symmetric_matrix<scalar_t, kN> &a)
+        {
+            using accumulator_t = detail::accumulator_of_t<scalar_t>;
+
+            symmetric_matrix<scalar_t, kN> inv{};
+            if constexpr (kN == 1)
+            {
+                inv(0, 0) = scalar_t(1) / a(0, 0);
+            }
+            else if constexpr (kN == 2)
+            {
+                const accumulator_t det_inv =
+                    accumulator_t(1) / (accumulator_t(a(0, 0)) * a(1, 1) - accumulator_t(a(1, 0)) * a(1, 0));
+                inv(0, 0) = static_cast<scalar_t>(a(1, 1) * det_inv);
+                inv(1, 0) = static_cast<scalar_t>(-a(1, 0) * det_inv);
+                inv(1, 1) = static_cast<scalar_t>(a(0, 0) * det_inv);
+            }
+            else
+            {
+                inv = detail::ldlt<scalar_t, kN>(a).template inverse<symmetric_matrix<scalar_t, kN>>();
+            }
+            return inv;
+        }
+    } // namespace matrix
+
+} // namespace algebra
@@ -0,0 +1,273 @@
+/** Algebra plugins, part of the ACTS project
+ *
+ * (c) 2020 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#pragma once
+
+#include "common/quaternion.hpp"
+#include "common/scalar.hpp"
+#include "common/types.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace algebra
+{
+    /** Compact encoding of rigid body transforms for storage and transfer: the rotation as
+     *  a unit quaternion and the translation, i.e. 7 values per transform instead of the 16
+     *  of a 4x4 matrix. The values are stored as float or double.
+     *
+     *  With a nominal geometry, the correction of every transform with respect to its
+     *  nominal transform is encoded instead, see apply_delta. Corrections are close to the
+     *  identity, so float storage keeps their absolute precision.
+     *
+     * @tparam transform_t the plugin transform type
+     * @tparam vector3_t the plugin 3D vector type
+     **/
+    template <typename transform_t, typename vector3_t>
+    struct transform_codec
+    {
+        using transform_type = transform_t;
+        using scalar_t = std::decay_t<decltype(std::declval<const vector3_t &>()[0])>;
+
+        // Encoded values per transform: quaternion (w, x, y, z) and translation
+        static constexpr unsigned int n_values = 7;
+
+        // Number of transforms that are decoded together
+        static constexpr std::size_t lanes = 8;
+
+        /** The rotation (column major) and the translation of a transform, read through the
+         *  transform interface so that any plugin transform can be encoded
+         *
+         * @param trf the transform
+         **/
+        static std::pair<std::array<scalar_t, 9>, std::array<scalar_t, 3>> components(const transform_t &trf)
+        {
+            const std::array<vector3_t, 3> axes = {vector3_t{scalar_t(1), scalar_t(0), scalar_t(0)},
+                                                   vector3_t{scalar_t(0), scalar_t(1), scalar_t(0)},
+                                                   vector3_t{scalar_t(0), scalar_t(0), scalar_t(1)}};
+            std::array<scalar_t, 9> r;
+            for (unsigned int c = 0; c < 3; ++c)
+            {
+                const vector3_t column = trf.vector_to_global(axes[c]);
+                r[3 * c] = column[0];
+                r[3 * c + 1] = column[1];
+                r[3 * c + 2] = column[2];
+            }
+            const vector3_t t = trf.point_to_global(vector3_t{scalar_t(0), scalar_t(0), scalar_t(0)});
+            return {r, {t[0], t[1], t[2]}};
+        }
+
+        /** Encode a collection of transforms
+         *
+         * @tparam storage_t the type of the encoded values, float or double
+         *
+         * @param transforms the transforms
+         *
+         * @return n_values values per transform
+         **/
+        template <typename storage_t, typename range_t>
+        static std::vector<storage_t> encode(const range_t &transforms)
+        {
+            return encode_impl<storage_t>(transforms, nullptr);
+        }
+
+        /** Encode the corrections of a collection of transforms with respect to the nominal ones
+         *
+         * @tparam storage_t the type of the encoded values, float or double
+         *
+         * @param transforms the transforms
+         * @param nominal the nominal transforms, at least as many as transforms
+         *
+         * @return n_values values per transform
+         **/
+        template <typename storage_t, typename range_t, typename nominal_range_t>
+        static std::vector<storage_t> encode(const range_t &transforms, const nominal_range_t &nominal)
+        {
+            assert(nominal.size() >= transforms.size());
+            return encode_impl<storage_t>(transforms, nominal);
+        }
+
+        /** Decode a collection of transforms
+         *
+         * @param data the encoded values
+         * @param n the number of transforms
+         * @param out the output iterator, receives n transforms
+         **/
+        template <typename storage_t, typename output_t>
+        static output_t decode(const storage_t *data, std::size_t n, output_t out)
+        {
+            return decode_impl(data, n, nullptr, out);
+        }
+
+        /** Decode a collection of transforms that was encoded with respect to nominal transforms
+         *
+         * @param data the encoded values
+         * @param n the number of transforms
+         * @param nominal the nominal transforms the data was encoded with
+         * @param out the output iterator, receives n transforms
+         **/
+        template <typename storage_t, typename nominal_range_t, typename output_t>
+        static output_t decode(const storage_t *data, std::size_t n, const nominal_range_t &nominal, output_t out)
+        {
+            assert(nominal.size() >= n);
+            return decode_impl(data, n, nominal, out);
+        }
+
+        /** Encode without (nominal_t = std::nullptr_t) or with nominal transforms */
+        template <typename storage_t, typename range_t, typename nominal_t>
+        static std::vector<storage_t> encode_impl(const range_t &transforms, const nominal_t &nominal)
+        {
+            std::vector<storage_t> data;
+            data.reserve(n_values * transforms.size());
+            for (std::size_t i = 0; i < transforms.size(); ++i)
+            {
+                auto [r, t] = components(transforms[i]);
+                if constexpr (not std::is_same_v<nominal_t, std::nullptr_t>)
+                {
+                    // Correction in the nominal frame: R_n^T R and R_n^T (t - t_n)
+                    const auto [rn, tn] = components(nominal[i]);
+                    std::array<scalar_t, 9> rd;
+                    std::array<scalar_t, 3> td;
+                    for (unsigned int a = 0; a < 3; ++a)
+                    {
+                        for (unsigned int c = 0; c < 3; ++c)
+                        {
+                            rd[3 * c + a] = rn[3 * a] * r[3 * c] + rn[3 * a + 1] * r[3 * c + 1] +
+                                            rn[3 * a + 2] * r[3 * c + 2];
+                        }
+                        td[a] = rn[3 * a] * (t[0] - tn[0]) + rn[3 * a + 1] * (t[1] - tn[1]) +
+                                rn[3 * a + 2] * (t[2] - tn[2]);
+                    }
+                    r = rd;
+                    t = td;
+                }
+
+                quaternion<scalar_t> q = quaternion<scalar_t>::from_rotation_matrix(r);
+                // q and -q are the same rotation, w >= 0 keeps corrections close to (1, 0, 0, 0)
+                if (q.w < scalar_t(0))
+                {
+                    q = {-q.w, -q.x, -q.y, -q.z};
+                }
+                for (scalar_t value : {q.w, q.x, q.y, q.z, t[0], t[1], t[2]})
+                {
+                    data.push_back(static_cast<storage_t>(value));
+                }
+            }
+            return data;
+        }
+
+        /** Decode blocks of transforms: the rotation matrices of a block are computed in loops
+         *  over the lanes, which the compiler vectorizes. The quaternions are normalized again,
+         *  so that float values give orthonormal rotations, and the inverses are set up from
+         *  the transposed rotations. Without nominal transforms, nominal_t is std::nullptr_t.
+         **/
+        template <typename storage_t, typename nominal_t, typename output_t>
+        static output_t decode_impl(const storage_t *data, std::size_t n, const nominal_t &nominal, output_t out)
+        {
+            using lane_type = std::array<scalar_t, lanes>;
+            using array16 = array_s<scalar_t, 16>;
+            using accumulator_t = std::common_type_t<scalar_t, accumulator>;
+
+            std::array<lane_type, n_values> v;
+            // Rotation (column major) and translation
+            std::array<lane_type, 12> m;
+            for (std::size_t b = 0; b < n; b += lanes)
+            {
+                const std::size_t count = std::min(lanes, n - b);
+                for (unsigned int k = 0; k < n_values; ++k)
+                {
+                    // Unused lanes hold the identity
+                    for (std::size_t l = 0; l < lanes; ++l)
+                    {
+                        v[k][l] = l < count ? static_cast<scalar_t>(data[(b + l) * n_values + k])
+                                            : scalar_t(k == 0 ? 1 : 0);
+                    }
+                }
+
+                for (std::size_t l = 0; l < lanes; ++l)
+                {
+                    const scalar_t norm =
+                        scalar_t(1) / std::sqrt(v[0][l] * v[0][l] + v[1][l] * v[1][l] + v[2][l] * v[2][l] +
+                                                v[3][l] * v[3][l]);
+                    const scalar_t w = v[0][l] * norm, x = v[1][l] * norm, y = v[2][l] * norm, z = v[3][l] * norm;
+                    const scalar_t xx = x * x, yy = y * y, zz = z * z;
+                    const scalar_t xy = x * y, xz = x * z, yz = y * z;
+                    const scalar_t wx = w * x, wy = w * y, wz = w * z;
+                    m[0][l] = scalar_t(1) - scalar_t(2) * (yy + zz);
+                    m[1][l] = scalar_t(2) * (xy + wz);
+                    m[2][l] = scalar_t(2) * (xz - wy);
+                    m[3][l] = scalar_t(2) * (xy - wz);
+                    m[4][l] = scalar_t(1) - scalar_t(2) * (xx + zz);
+                    m[5][l] = scalar_t(2) * (yz + wx);
+                    m[6][l] = scalar_t(2) * (xz + wy);
+                    m[7][l] = scalar_t(2) * (yz - wx);
+                    m[8][l] = scalar_t(1) - scalar_t(2) * (xx + yy);
+                    m[9][l] = v[4][l];
+                    m[10][l] = v[5][l];
+                    m[11][l] = v[6][l];
+                }
+
+                for (std::size_t l = 0; l < count; ++l)
+                {
+                    std::array<scalar_t, 12> c;
+                    for (unsigned int k = 0; k < 12; ++k)
+                    {
+                        c[k] = m[k][l];
+                    }
+                    if constexpr (not std::is_same_v<nominal_t, std::nullptr_t>)
+                    {
+                        // Apply the correction: R_n R_d and R_n t_d + t_n
+                        const auto [rn, tn] = components(nominal[b + l]);
+                        std::array<scalar_t, 12> g;
+                        for (unsigned int col = 0; col < 4; ++col)
+                        {
+                            for (unsigned int r = 0; r < 3; ++r)
+                            {
+                                g[3 * col + r] = rn[r] * c[3 * col] + rn[3 + r] * c[3 * col + 1] +
+                                                 rn[6 + r] * c[3 * col + 2] + (col == 3 ? tn[r] : scalar_t(0));
+                            }
+                        }
+                        c = g;
+                    }
+
+                    array16 ma, ma_inv;
+                    for (unsigned int r = 0; r < 3; ++r)
+                    {
+                        for (unsigned int col = 0; col < 3; ++col)
+                        {
+                            ma[4 * r + col] = c[3 * col + r];
+                            ma_inv[4 * r + col] = c[3 * r + col];
+                        }
+                        ma[4 * r + 3] = c[9 + r];
+                        ma_inv[4 * r + 3] = static_cast<scalar_t>(-(accumulator_t(c[3 * r]) * c[9] +
+                                                                     accumulator_t(c[3 * r + 1]) * c[10] +
+                                                                     accumulator_t(c[3 * r + 2]) * c[11]));
+                        ma[12 + r] = ma_inv[12 + r] = scalar_t(0);
+                    }
+                    ma[15] = ma_inv[15] = scalar_t(1);
+
+                    if constexpr (std::is_constructible_v<transform_t, const array16 &, const array16 &>)
+                    {
+                        *out++ = transform_t(ma, ma_inv);
+                    }
+                    else
+                    {
+                        *out++ = transform_t(ma);
+                    }
+                }
+            }
+            return out;
+        }
+    };
+
+} // namespace algebra
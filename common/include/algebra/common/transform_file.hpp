@@ -0,0 +1,388 @@
+/** Algebra plugins, part of the ACTS project
+ *
+ * (c) 2020 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#pragma once
+
+#include "common/aligned_allocator.hpp"
+#include "common/transform_store.hpp"
+#include "common/types.hpp"
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define ALGEBRA_PLUGIN_HAVE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace algebra
+{
+    /** Binary format of a transform collection, e.g. of the detector geometry. The file is a
+     *  64 byte header followed by the data, which starts on a cache line and can be used in
+     *  place after the file is memory mapped:
+     *
+     *  - aos: the rotations and translations as row major 3x4 matrices, back to back. With
+     *    inverses, the inverse matrices follow in the same form.
+     *  - soa: the 12 components of the transforms and, with inverses, the 12 components of
+     *    the inverses, in the order of the structure of arrays store. Every component array
+     *    has header.stride scalars, i.e. it is padded to whole cache lines.
+     *
+     *  The data is written in the byte order and the scalar type of the writer. Files of
+     *  another byte order, scalar size or format version are rejected by the reader.
+     **/
+    struct transform_file_header
+    {
+        static constexpr std::array<char, 8> file_magic = {'A', 'L', 'G', 'T', 'R', 'F', '\0', '\0'};
+        static constexpr std::uint32_t current_version = 1;
+        static constexpr std::uint32_t byte_order_mark = 0x01020304;
+
+        // Data layouts
+        static constexpr std::uint32_t aos = 0;
+        static constexpr std::uint32_t soa = 1;
+
+        // Flags
+        static constexpr std::uint32_t with_inverse = 1;
+
+        std::array<char, 8> magic = file_magic;
+        std::uint32_t version = current_version;
+        std::uint32_t byte_order = byte_order_mark;
+        // sizeof the scalar type
+        std::uint32_t scalar_size = 0;
+        std::uint32_t layout = aos;
+        std::uint32_t flags = 0;
+        std::uint32_t reserved = 0;
+        // Number of transforms
+        std::uint64_t size = 0;
+        // aos: scalars per matrix, soa: scalars per component array
+        std::uint64_t stride = 0;
+        // Offset of the data from the file start in bytes
+        std::uint64_t data_offset = 0;
+        std::uint64_t reserved_data = 0;
+
+        /** @return whether the header can be read with the given scalar type */
+        template <typename scalar_t>
+        bool is_compatible() const
+        {
+            return magic == file_magic and version == current_version and byte_order == byte_order_mark and
+                   scalar_size == sizeof(scalar_t) and (layout == aos or layout == soa);
+        }
+
+        /** Check the stride against the number of transforms and the data against the file
+         *  size. The size arithmetic is checked for overflows, so that a corrupted header
+         *  cannot pass the bounds check.
+         *
+         * @param file_size the size of the file in bytes
+         *
+         * @return whether all data described by the header lies within the file
+         **/
+        bool is_consistent(std::uint64_t file_size) const
+        {
+            if (layout == aos ? stride != 12 : stride < size)
+            {
+                return false;
+            }
+            constexpr std::uint64_t max = std::numeric_limits<std::uint64_t>::max();
+            const std::uint64_t n_matrices = (flags & with_inverse) ? 2 : 1;
+            if (size > max / n_matrices)
+            {
+                return false;
+            }
+            const std::uint64_t n_arrays = layout == aos ? n_matrices * size : n_matrices * 12;
+            if (scalar_size == 0 or (n_arrays != 0 and stride > max / n_arrays / scalar_size))
+            {
+                return false;
+            }
+            return data_offset <= file_size and data_size() <= file_size - data_offset;
+        }
+
+        /** @return the size of the data in bytes */
+        std::uint64_t data_size() const
+        {
+            const std::uint64_t n_matrices = (flags & with_inverse) ? 2 : 1;
+            return layout == aos ? n_matrices * size * stride * scalar_size
+                                 : n_matrices * 12 * stride * scalar_size;
+        }
+    };
+
+    static_assert(sizeof(transform_file_header) == 64, "The transform file header has a fixed size");
+
+    /** Write the transforms of a structure of arrays store or view to a binary file
+     *
+     * @param path the file path
+     * @param transforms the transforms, a transform_store<..., soa_layout> or a transform_view
+     * @param layout transform_file_header::aos or transform_file_header::soa
+     * @param with_inverse whether to write the inverse transforms, only done if the
+     *        transforms have them (see has_inverse())
+     *
+     * @return whether the file was written
+     **/
+    template <typename transforms_t>
+    inline bool write_transform_file(const std::string &path, const transforms_t &transforms,
+                                     std::uint32_t layout = transform_file_header::soa, bool with_inverse = true)
+    {
+        using scalar_t = typename transforms_t::scalar_t;
+        constexpr std::size_t scalars_per_line = cache_line_size / sizeof(scalar_t);
+        constexpr unsigned int inverse_offset = transforms_t::inverse_offset;
+
+        // A view of a file without inverses has no inverse components to read
+        with_inverse = with_inverse and transforms.has_inverse();
+
+        transform_file_header header;
+        header.scalar_size = sizeof(scalar_t);
+        header.layout = layout;
+        header.flags = with_inverse ? transform_file_header::with_inverse : 0;
+        header.size = transforms.size();
+        header.stride = layout == transform_file_header::aos
+                            ? 12
+                            : (transforms.size() + scalars_per_line - 1) / scalars_per_line * scalars_per_line;
+        header.data_offset = cache_line_size;
+
+        std::vector<scalar_t> data(header.data_size() / sizeof(scalar_t), scalar_t(0));
+        const std::size_t n = transforms.size();
+        for (unsigned int m = 0; m < (with_inverse ? 2u : 1u); ++m)
+        {
+            const unsigned int offset = m * inverse_offset;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                const auto ma = transforms.matrix(i, offset);
+                for (unsigned int r = 0; r < 3; ++r)
+                {
+                    for (unsigned int c = 0; c < 4; ++c)
+                    {
+                        // The soa component index is 3 * c + r, as in the store
+                        const std::size_t at = layout == transform_file_header::aos
+                                                   ? (m * n + i) * 12 + 4 * r + c
+                                                   : (12 * m + 3 * c + r) * header.stride + i;
+                        data[at] = ma[4 * r + c];
+                    }
+                }
+            }
+        }
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(header.data_size()));
+        return static_cast<bool>(file);
+    }
+
+    /** Read-only access to a binary transform file. The file is memory mapped where this is
+     *  supported and read into memory otherwise. The transforms are used in place: no
+     *  transform is constructed when the file is opened.
+     *
+     * @tparam scalar_t the scalar type of the file
+     **/
+    template <typename scalar_t>
+    struct transform_file
+    {
+        transform_file_header _header;
+        // Start of the mapped (or read) file and of the data
+        const unsigned char *_begin = nullptr;
+        const scalar_t *_data = nullptr;
+        std::size_t _file_size = 0;
+        // The file content if it is not memory mapped
+        std::vector<unsigned char, aligned_allocator<unsigned char>> _buffer;
+
+        /** Default contructors: no file */
+        transform_file() = default;
+
+        /** Constructor with arguments: the file path, see is_open() */
+        explicit transform_file(const std::string &path)
+        {
+            open(path);
+        }
+
+        transform_file(const transform_file &) = delete;
+        transform_file &operator=(const transform_file &) = delete;
+        ~transform_file()
+        {
+            close();
+        }
+
+        /** Open a file, any open file is closed before
+         *
+         * @param path the file path
+         *
+         * @return whether the file exists and has a compatible and consistent header and the
+         *         full data
+         **/
+        bool open(const std::string &path)
+        {
+            close();
+            if (not map(path))
+            {
+                return false;
+            }
+
+            std::memcpy(&_header, _begin, sizeof(_header));
+            if (not _header.template is_compatible<scalar_t>() or _header.data_offset % cache_line_size != 0 or
+                not _header.is_consistent(_file_size))
+            {
+                close();
+                return false;
+            }
+            _data = reinterpret_cast<const scalar_t *>(_begin + _header.data_offset);
+            return true;
+        }
+
+        /** Release the file */
+        void close()
+        {
+#ifdef ALGEBRA_PLUGIN_HAVE_MMAP
+            if (_begin != nullptr and _buffer.empty())
+            {
+                ::munmap(const_cast<unsigned char *>(_begin), _file_size);
+            }
+#endif
+            _buffer.clear();
+            _buffer.shrink_to_fit();
+            _begin = nullptr;
+            _data = nullptr;
+            _file_size = 0;
+            _header = transform_file_header{};
+        }
+
+        /** @return whether a file is open */
+        bool is_open() const
+        {
+            return _data != nullptr;
+        }
+
+        /** @return the file header */
+        const transform_file_header &header() const
+        {
+            return _header;
+        }
+
+        /** @return the number of transforms */
+        std::size_t size() const
+        {
+            return _header.size;
+        }
+
+        /** @return whether the file contains the inverse transforms */
+        bool has_inverse() const
+        {
+            return (_header.flags & transform_file_header::with_inverse) != 0;
+        }
+
+        /** The row major 3x4 matrices of an aos file, e.g. for transform_store::append
+         *
+         * @param inverse whether to return the inverse matrices
+         **/
+        const scalar_t *matrices(bool inverse = false) const
+        {
+            assert(_header.layout == transform_file_header::aos);
+            assert(not inverse or has_inverse());
+            return _data + (inverse ? _header.size * _header.stride : 0);
+        }
+
+        /** A component array of a soa file
+         *
+         * @param k the component, in the order of the structure of arrays store
+         **/
+        const scalar_t *component(unsigned int k) const
+        {
+            assert(_header.layout == transform_file_header::soa);
+            assert(k < 12 or has_inverse());
+            return _data + k * _header.stride;
+        }
+
+        /** @return a view of the transforms of a soa file, valid as long as the file is open.
+         *  Without the inverses in the file, the view takes the transforms to be rigid body
+         *  transforms in the global to local kernels.
+         **/
+        template <typename transform_t, typename vector3_t>
+        transform_view<transform_t, vector3_t> view() const
+        {
+            transform_view<transform_t, vector3_t> v;
+            for (unsigned int k = 0; k < (has_inverse() ? 24u : 12u); ++k)
+            {
+                v._components[k] = component(k);
+            }
+            v._size = size();
+            return v;
+        }
+
+        /** The 4x4 matrix of a transform, in any layout
+         *
+         * @param index the index of the transform
+         * @param inverse whether to return the inverse matrix
+         *
+         * @return the matrix as row major 16 array
+         **/
+        array_s<scalar_t, 16> matrix(std::size_t index, bool inverse = false) const
+        {
+            assert(index < size());
+            assert(not inverse or has_inverse());
+            array_s<scalar_t, 16> ma;
+            for (unsigned int r = 0; r < 3; ++r)
+            {
+                for (unsigned int c = 0; c < 4; ++c)
+                {
+                    ma[4 * r + c] = _header.layout == transform_file_header::aos
+                                        ? matrices(inverse)[index * 12 + 4 * r + c]
+                                        : component((inverse ? 12 : 0) + 3 * c + r)[index];
+                }
+                ma[12 + r] = scalar_t(0);
+            }
+            ma[15] = scalar_t(1);
+            return ma;
+        }
+
+        /** Make the file content available from _begin */
+        bool map(const std::string &path)
+        {
+#ifdef ALGEBRA_PLUGIN_HAVE_MMAP
+            const int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+            {
+                return false;
+            }
+            struct stat status;
+            if (::fstat(fd, &status) != 0 or static_cast<std::size_t>(status.st_size) < sizeof(_header))
+            {
+                ::close(fd);
+                return false;
+            }
+            _file_size = static_cast<std::size_t>(status.st_size);
+            void *address = ::mmap(nullptr, _file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            // The mapping stays valid after the descriptor is closed
+            ::close(fd);
+            if (address == MAP_FAILED)
+            {
+                _file_size = 0;
+                return false;
+            }
+            _begin = static_cast<const unsigned char *>(address);
+            return true;
+#else
+            std::ifstream file(path, std::ios::binary | std::ios::ate);
+            if (not file or static_cast<std::size_t>(file.tellg()) < sizeof(_header))
+            {
+                return false;
+            }
+            _file_size = static_cast<std::size_t>(file.tellg());
+            _buffer.resize(_file_size);
+            file.seekg(0);
+            file.read(reinterpret_cast<char *>(_buffer.data()), static_cast<std::streamsize>(_file_size));
+            _begin = _buffer.data();
+            return static_cast<bool>(file);
+#endif
+        }
+    };
+
+} // namespace algebra
@@ -0,0 +1,79 @@
+/** Algebra plugins, part of the ACTS project
+ *
+ * (c) 2020 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#pragma once
+
+#include <array>
+#include <type_traits>
+
+namespace algebra
+{
+    /** The form of a transform, from the cheapest to the most general one. Every kind has
+     *  a kernel that skips the parts of the transformation that are trivial.
+     **/
+    enum class transform_kind : unsigned char
+    {
+        identity = 0,
+        // Unit rotation and a translation
+        translation = 1,
+        // Diagonal rotation with entries +-1, i.e. the local axes are (anti-)parallel to
+        // the global ones, and a translation
+        axis_aligned = 2,
+        general = 3
+    };
+
+    /// Compile time transform kind, for the static dispatch to a kernel
+    template <transform_kind kKIND>
+    using transform_kind_constant = std::integral_constant<transform_kind, kKIND>;
+
+    /** Find the kind of a transform. The comparisons are exact, so that a fast kernel is
+     *  only selected if it gives the same result as the general one.
+     *
+     * @param r the 3x3 rotation in column major order
+     * @param t the translation
+     **/
+    template <typename scalar_t>
+    inline transform_kind classify_transform(const std::array<scalar_t, 9> &r, const std::array<scalar_t, 3> &t)
+    {
+        const scalar_t zero(0.), one(1.);
+        if (r[1] != zero or r[2] != zero or r[3] != zero or r[5] != zero or r[6] != zero or r[7] != zero)
+        {
+            return transform_kind::general;
+        }
+        if (r[0] == one and r[4] == one and r[8] == one)
+        {
+            return (t[0] == zero and t[1] == zero and t[2] == zero) ? transform_kind::identity
+                                                                     : transform_kind::translation;
+        }
+        const auto is_sign = [one](scalar_t d) { return d == one or d == -one; };
+        return (is_sign(r[0]) and is_sign(r[4]) and is_sign(r[8])) ? transform_kind::axis_aligned
+                                                                   : transform_kind::general;
+    }
+
+    /** Call a function with the kind of a transform as a compile time constant, i.e. turn
+     *  the dynamic kind into a static one with a single branch
+     *
+     * @param kind the transform kind
+     * @param function the function, called with a transform_kind_constant
+     **/
+    template <typename function_t>
+    inline decltype(auto) dispatch_kind(transform_kind kind, function_t &&function)
+    {
+        switch (kind)
+        {
+        case transform_kind::identity:
+            return function(transform_kind_constant<transform_kind::identity>{});
+        case transform_kind::translation:
+            return function(transform_kind_constant<transform_kind::translation>{});
+        case transform_kind::axis_aligned:
+            return function(transform_kind_constant<transform_kind::axis_aligned>{});
+        default:
+            return function(transform_kind_constant<transform_kind::general>{});
+        }
+    }
+
+} // namespace algebra
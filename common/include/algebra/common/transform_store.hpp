@@ -0,0 +1,1122 @@
+/** Algebra plugins, part of the ACTS project
+ *
+ * (c) 2020 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#pragma once
+
+#include "common/aligned_allocator.hpp"
+#include "common/rotation.hpp"
+#include "common/scalar.hpp"
+#include "common/types.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace algebra
+{
+    /** Layout tag: the transforms are stored back to back (array of structures) */
+    struct aos_layout
+    {
+    };
+
+    /** Layout tag: every matrix component of the transforms and their inverses is
+     *  stored in its own contiguous array (structure of arrays)
+     */
+    struct soa_layout
+    {
+    };
+
+    /** Hint the hardware to load the cache line of an address for reading
+     *
+     * @param ptr the address to be prefetched
+     **/
+    inline void prefetch_address(const void *ptr) noexcept
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(ptr, 0, 3);
+#else
+        (void)ptr;
+#endif
+    }
+
+    namespace detail
+    {
+        /** A block of rigid body transforms that are read from a buffer of row major 4x4 or
+         *  3x4 matrices, with one transform per lane: the inverses of all lanes are computed
+         *  together in loops over the lanes, which the compiler vectorizes.
+         *
+         * @tparam scalar_t the scalar type
+         **/
+        template <typename scalar_t>
+        struct isometry_block
+        {
+            // Number of transforms per block, one or two simd registers
+            static constexpr std::size_t lanes = 8;
+
+            using lane_type = std::array<scalar_t, lanes>;
+            using accumulator_t = std::common_type_t<scalar_t, accumulator>;
+
+            // Rotation (column major) and translation of the transforms and of their inverses
+            std::array<lane_type, 12> _m;
+            std::array<lane_type, 12> _m_inv;
+            // Last row of the matrices, only read for stride 16, (0, 0, 0, 1) otherwise
+            std::array<lane_type, 4> _row3;
+
+            /** Read the transforms of a block and invert them
+             *
+             * @param buffer the matrices of the block, row major
+             * @param stride the number of scalars per matrix, 16 or 12
+             * @param count the number of transforms in the block, at most lanes
+             **/
+            void load(const scalar_t *buffer, unsigned int stride, std::size_t count)
+            {
+                assert(stride == 16 or stride == 12);
+                assert(count <= lanes);
+
+                if (stride == 12 or count < lanes)
+                {
+                    for (unsigned int c = 0; c < 4; ++c)
+                    {
+                        _row3[c].fill(scalar_t(c == 3 ? 1 : 0));
+                    }
+                }
+
+                // A constant stride and a full block give the compiler fixed trip counts
+                if (count == lanes)
+                {
+                    stride == 16 ? gather<16>(buffer, lanes) : gather<12>(buffer, lanes);
+                }
+                else
+                {
+                    for (lane_type &component : _m)
+                    {
+                        component.fill(scalar_t(0));
+                    }
+                    stride == 16 ? gather<16>(buffer, count) : gather<12>(buffer, count);
+                }
+
+                // Inverse of a rigid body transform: R^T and -R^T t
+                for (unsigned int r = 0; r < 3; ++r)
+                {
+                    for (unsigned int c = 0; c < 3; ++c)
+                    {
+                        _m_inv[3 * c + r] = _m[3 * r + c];
+                    }
+                    for (std::size_t l = 0; l < lanes; ++l)
+                    {
+                        _m_inv[9 + r][l] = static_cast<scalar_t>(-(accumulator_t(_m[3 * r][l]) * _m[9][l] +
+                                                                   accumulator_t(_m[3 * r + 1][l]) * _m[10][l] +
+                                                                   accumulator_t(_m[3 * r + 2][l]) * _m[11][l]));
+                    }
+                }
+            }
+
+            /** Transpose the row major matrices of the buffer into the lanes
+             *
+             * @tparam kSTRIDE the number of scalars per matrix
+             * @param buffer the matrices of the block
+             * @param count the number of matrices
+             **/
+            template <unsigned int kSTRIDE>
+            void gather(const scalar_t *buffer, std::size_t count)
+            {
+                for (std::size_t l = 0; l < count; ++l)
+                {
+                    const scalar_t *ma = buffer + l * kSTRIDE;
+                    for (unsigned int r = 0; r < 3; ++r)
+                    {
+                        for (unsigned int c = 0; c < 4; ++c)
+                        {
+                            _m[3 * c + r][l] = ma[4 * r + c];
+                        }
+                    }
+                    if constexpr (kSTRIDE == 16)
+                    {
+                        for (unsigned int c = 0; c < 4; ++c)
+                        {
+                            _row3[c][l] = ma[12 + c];
+                        }
+                    }
+                }
+            }
+
+            /** Check whether the rotation of a lane is orthonormal and the last row is
+             *  (0, 0, 0, 1), the tolerance is the one of the plugin checks
+             *
+             * @param l the lane
+             **/
+            bool is_isometry(std::size_t l) const
+            {
+                constexpr scalar_t tolerance = 1e3 * std::numeric_limits<scalar_t>::epsilon();
+                for (unsigned int c = 0; c < 4; ++c)
+                {
+                    if (std::abs(_row3[c][l] - scalar_t(c == 3 ? 1 : 0)) > tolerance)
+                    {
+                        return false;
+                    }
+                }
+                for (unsigned int a = 0; a < 3; ++a)
+                {
+                    for (unsigned int b = 0; b <= a; ++b)
+                    {
+                        const accumulator_t d = accumulator_t(_m[3 * a][l]) * _m[3 * b][l] +
+                                                accumulator_t(_m[3 * a + 1][l]) * _m[3 * b + 1][l] +
+                                                accumulator_t(_m[3 * a + 2][l]) * _m[3 * b + 2][l];
+                        if (std::abs(d - (a == b ? 1. : 0.)) > tolerance)
+                        {
+                            return false;
+                        }
+                    }
+                }
+                return true;
+            }
+
+            /** The matrix of a lane as row major 16 array, with the last row as read
+             *
+             * @param l the lane
+             * @param inverse whether to return the inverse matrix
+             **/
+            array_s<scalar_t, 16> matrix(std::size_t l, bool inverse = false) const
+            {
+                const std::array<lane_type, 12> &m = inverse ? _m_inv : _m;
+                array_s<scalar_t, 16> ma;
+                for (unsigned int r = 0; r < 3; ++r)
+                {
+                    for (unsigned int c = 0; c < 4; ++c)
+                    {
+                        ma[4 * r + c] = m[3 * c + r][l];
+                    }
+                }
+                for (unsigned int c = 0; c < 4; ++c)
+                {
+                    ma[12 + c] = inverse ? scalar_t(c == 3 ? 1 : 0) : _row3[c][l];
+                }
+                return ma;
+            }
+        };
+
+        /** Whether the constructor of a transform type from a matrix takes the matrix to be
+         *  a rigid body transform, see the assumes_isometry member of the plugin transforms.
+         *  Types without the member are taken to compute a general inverse.
+         **/
+        template <typename transform_t, typename = void>
+        struct assumes_isometry : std::false_type
+        {
+        };
+
+        template <typename transform_t>
+        struct assumes_isometry<transform_t, std::void_t<decltype(transform_t::assumes_isometry)>>
+            : std::bool_constant<transform_t::assumes_isometry>
+        {
+        };
+
+        /** Split the transforms [0, n) into contiguous ranges of whole blocks and process
+         *  them on several threads
+         *
+         * @param n the number of transforms
+         * @param n_threads the number of threads, the calling thread is used for 0 and 1
+         * @param block_size the granularity of the ranges
+         * @param function the work, called with the begin and end of a range
+         **/
+        template <typename function_t>
+        inline void parallel_ranges(std::size_t n, unsigned int n_threads, std::size_t block_size, function_t function)
+        {
+            const std::size_t n_blocks = (n + block_size - 1) / block_size;
+            n_threads = static_cast<unsigned int>(std::min<std::size_t>(std::max(n_threads, 1u), n_blocks));
+            if (n_threads <= 1)
+            {
+                function(std::size_t(0), n);
+                return;
+            }
+
+            const std::size_t range = (n_blocks + n_threads - 1) / n_threads * block_size;
+            std::vector<std::thread> threads;
+            threads.reserve(n_threads);
+            for (std::size_t begin = 0; begin < n; begin += range)
+            {
+                threads.emplace_back(function, begin, std::min(begin + range, n));
+            }
+            for (std::thread &thread : threads)
+            {
+                thread.join();
+            }
+        }
+    } // namespace detail
+
+    /** Contiguous, cache line aligned container of transforms that is addressed by index.
+     *
+     *  The batched kernels apply transform[indices[i]] to the input element i and prefetch
+     *  the transforms that are used prefetch_distance iterations later.
+     *
+     * @tparam transform_t the plugin transform type, e.g. transform3 or compact_transform3
+     * @tparam vector3_t the plugin 3D vector type
+     * @tparam layout_t aos_layout or soa_layout
+     **/
+    template <typename transform_t, typename vector3_t, typename layout_t = aos_layout>
+    struct transform_store;
+
+    /** Array of structures layout: keeps the plugin transforms as they are */
+    template <typename transform_t, typename vector3_t>
+    struct transform_store<transform_t, vector3_t, aos_layout>
+    {
+        using transform_type = transform_t;
+        using container_type = std::vector<transform_t, aligned_allocator<transform_t>>;
+
+        // Number of iterations the batched kernels prefetch ahead
+        static constexpr std::size_t prefetch_distance = 8;
+
+        container_type _transforms;
+
+        /** @return the number of stored transforms */
+        std::size_t size() const
+        {
+            return _transforms.size();
+        }
+
+        /** @return whether the store is empty */
+        bool empty() const
+        {
+            return _transforms.empty();
+        }
+
+        /** Reserve memory for n transforms */
+        void reserve(std::size_t n)
+        {
+            _transforms.reserve(n);
+        }
+
+        /** Remove all transforms */
+        void clear()
+        {
+            _transforms.clear();
+        }
+
+        /** Add a transform to the store
+         *
+         * @param trf the transform
+         *
+         * @return the index of the transform
+         **/
+        std::size_t push_back(const transform_t &trf)
+        {
+            _transforms.push_back(trf);
+            return _transforms.size() - 1;
+        }
+
+        /** Construct a transform in place
+         *
+         * @param args the transform constructor arguments
+         *
+         * @return the index of the transform
+         **/
+        template <typename... args_t>
+        std::size_t emplace_back(args_t &&... args)
+        {
+            _transforms.emplace_back(std::forward<args_t>(args)...);
+            return _transforms.size() - 1;
+        }
+
+        /** Add the transforms of a contiguous buffer of matrices, e.g. of a detector description.
+         *  The inverses are computed for isometry_block::lanes transforms at once and the
+         *  transforms are constructed with them, if the transform type takes an inverse.
+         *  Unless the transform type assumes rigid body transforms itself, matrices that are
+         *  not rigid body transforms are inverted by the transform constructor.
+         *
+         * @param buffer the matrices, row major 4x4 (stride 16) or 3x4 (stride 12)
+         * @param n the number of matrices
+         * @param stride the number of scalars per matrix, 16 or 12
+         * @param n_threads the number of threads that construct the transforms
+         **/
+        template <typename scalar_t>
+        void append(const scalar_t *buffer, std::size_t n, unsigned int stride = 16, unsigned int n_threads = 1)
+        {
+            using block_type = detail::isometry_block<scalar_t>;
+            using array16 = array_s<scalar_t, 16>;
+            constexpr bool kTAKES_INVERSE = std::is_constructible_v<transform_t, const array16 &, const array16 &>;
+
+            const auto make_transform = [](const block_type &block, std::size_t l) {
+                if constexpr (kTAKES_INVERSE)
+                {
+                    if (not detail::assumes_isometry<transform_t>::value and not block.is_isometry(l))
+                    {
+                        return transform_t(block.matrix(l));
+                    }
+                    return transform_t(block.matrix(l), block.matrix(l, true));
+                }
+                else
+                {
+                    return transform_t(block.matrix(l));
+                }
+            };
+
+            const std::size_t offset = size();
+            block_type block;
+            if (n_threads <= 1)
+            {
+                // No default constructed transforms to overwrite
+                _transforms.reserve(offset + n);
+                for (std::size_t b = 0; b < n; b += block_type::lanes)
+                {
+                    const std::size_t count = std::min(block_type::lanes, n - b);
+                    block.load(buffer + b * stride, stride, count);
+                    for (std::size_t l = 0; l < count; ++l)
+                    {
+                        _transforms.push_back(make_transform(block, l));
+                    }
+                }
+                return;
+            }
+
+            _transforms.resize(offset + n);
+            detail::parallel_ranges(n, n_threads, block_type::lanes, [&](std::size_t begin, std::size_t end) {
+                block_type thread_block;
+                for (std::size_t b = begin; b < end; b += block_type::lanes)
+                {
+                    const std::size_t count = std::min(block_type::lanes, end - b);
+                    thread_block.load(buffer + b * stride, stride, count);
+                    for (std::size_t l = 0; l < count; ++l)
+                    {
+                        _transforms[offset + b + l] = make_transform(thread_block, l);
+                    }
+                }
+            });
+        }
+
+        /** @return the transform at the given index */
+        const transform_t &operator[](std::size_t index) const
+        {
+            return _transforms[index];
+        }
+
+        /** @return the transform at the given index, throws std::out_of_range for an invalid index */
+        const transform_t &at(std::size_t index) const
+        {
+            return _transforms.at(index);
+        }
+
+        /** Prefetch all cache lines of a transform
+         *
+         * @param index the index of the transform, needs to be valid
+         **/
+        void prefetch(std::size_t index) const
+        {
+            assert(index < size());
+            const char *begin = reinterpret_cast<const char *>(_transforms.data() + index);
+            for (std::size_t offset = 0; offset < sizeof(transform_t); offset += cache_line_size)
+            {
+                prefetch_address(begin + offset);
+            }
+        }
+
+        /** Apply a kernel to every input element and the transform it is indexed with
+         *
+         * @param indices the transform index of every input element
+         * @param in the input range of points/vectors
+         * @param out the output range, needs at least the size of the input range
+         * @param kernel the operation, called with a transform and an input element
+         **/
+        template <typename index_range_t, typename input_t, typename output_t, typename kernel_t>
+        void transform_indexed(const index_range_t &indices, const input_t &in, output_t &out, kernel_t kernel) const
+        {
+            assert(indices.size() >= in.size());
+            assert(out.size() >= in.size());
+
+            const std::size_t n = in.size();
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                if (i + prefetch_distance < n)
+                {
+                    prefetch(indices[i + prefetch_distance]);
+                }
+                out[i] = kernel(_transforms[indices[i]], in[i]);
+            }
+        }
+
+        /** This method transforms points[i] with transform[indices[i]] from the local 3D cartesian frame to the global 3D cartesian frame
+         *
+         * @param indices the transform indices
+         * @param points the input points in the local frames
+         * @param results the output points in the global frame, at least of the size of the input
+         */
+        template <typename index_range_t, typename input_t, typename output_t>
+        void point_to_global(const index_range_t &indices, const input_t &points, output_t &&results) const
+        {
+            transform_indexed(indices, points, results,
+                              [](const transform_t &trf, const auto &p) -> vector3_t { return trf.point_to_global(p); });
+        }
+
+        /** This method transforms points[i] with transform[indices[i]] from the global 3D cartesian frame into the local 3D cartesian frame
+         *
+         * @param indices the transform indices
+         * @param points the input points in the global frame
+         * @param results the output points in the local frames, at least of the size of the input
+         */
+        template <typename index_range_t, typename input_t, typename output_t>
+        void point_to_local(const index_range_t &indices, const input_t &points, output_t &&results) const
+        {
+            transform_indexed(indices, points, results,
+                              [](const transform_t &trf, const auto &p) -> vector3_t { return trf.point_to_local(p); });
+        }
+
+        /** This method transforms vectors[i] with transform[indices[i]] from the local 3D cartesian frame to the global 3D cartesian frame
+         *
+         * @param indices the transform indices
+         * @param vectors the input vectors in the local frames
+         * @param results the output vectors in the global frame, at least of the size of the input
+         */
+        template <typename index_range_t, typename input_t, typename output_t>
+        void vector_to_global(const index_range_t &indices, const input_t &vectors, output_t &&results) const
+        {
+            transform_indexed(indices, vectors, results,
+                              [](const transform_t &trf, const auto &v) -> vector3_t { return trf.vector_to_global(v); });
+        }
+
+        /** This method transforms vectors[i] with transform[indices[i]] from the global 3D cartesian frame into the local 3D cartesian frame
+         *
+         * @param indices the transform indices
+         * @param vectors the input vectors in the global frame
+         * @param results the output vectors in the local frames, at least of the size of the input
+         */
+        template <typename index_range_t, typename input_t, typename output_t>
+        void vector_to_local(const index_range_t &indices, const input_t &vectors, output_t &&results) const
+        {
+            transform_indexed(indices, vectors, results,
+                              [](const transform_t &trf, const auto &v) -> vector3_t { return trf.vector_to_local(v); });
+        }
+
+        /** Apply alignment corrections in the local frames of the transforms, see transform3::apply_delta
+         *
+         * @param indices the indices of the corrected transforms
+         * @param rotation_deltas the rotation vectors of the corrections, axis times angle
+         * @param translation_deltas the translations of the corrections
+         **/
+        template <typename index_range_t, typename rotation_range_t, typename translation_range_t>
+        void apply_delta(const index_range_t &indices, const rotation_range_t &rotation_deltas,
+                         const translation_range_t &translation_deltas)
+        {
+            assert(rotation_deltas.size() >= indices.size());
+            assert(translation_deltas.size() >= indices.size());
+
+            const std::size_t n = indices.size();
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                _transforms[indices[i]].apply_delta(rotation_deltas[i], translation_deltas[i]);
+            }
+        }
+    };
+
+    /** Read-only structure of arrays view of transforms whose components are owned elsewhere,
+     *  e.g. by a structure of arrays store or by a memory mapped transform file. It has the
+     *  component order and the batched kernels of the structure of arrays store.
+     *
+     * @tparam transform_t the plugin transform type that operator[] returns
+     * @tparam vector3_t the plugin 3D vector type
+     **/
+    template <typename transform_t, typename vector3_t>
+    struct transform_view
+    {
+        using transform_type = transform_t;
+        using scalar_t = std::decay_t<decltype(std::declval<const vector3_t &>()[0])>;
+
+        // Number of iterations the batched kernels prefetch ahead
+        static constexpr std::size_t prefetch_distance = 8;
+
+        // Components per transform: rotation (column major) and translation
+        static constexpr unsigned int n_components = 12;
+        // Offset of the components of the inverse transform
+        static constexpr unsigned int inverse_offset = n_components;
+
+        // The component arrays, the inverse ones are null if there are no inverses
+        std::array<const scalar_t *, 2 * n_components> _components = {};
+        std::size_t _size = 0;
+
+        /** @return the number of transforms */
+        std::size_t size() const
+        {
+            return _size;
+        }
+
+        /** @return whether the view is empty */
+        bool empty() const
+        {
+            return _size == 0;
+        }
+
+        /** @return whether the inverse transforms are available */
+        bool has_inverse() const
+        {
+            return _components[inverse_offset] != nullptr;
+        }
+
+        /** The 4x4 matrix of a transform
+         *
+         * @param index the index of the transform
+         * @param offset 0 for the transform, inverse_offset for its inverse
+         *
+         * @return the matrix as row major 16 array
+         **/
+        array_s<scalar_t, 16> matrix(std::size_t index, unsigned int offset = 0) const
+        {
+            assert(offset == 0 or has_inverse());
+            array_s<scalar_t, 16> ma;
+            for (unsigned int r = 0; r < 3; ++r)
+            {
+                for (unsigned int c = 0; c < 3; ++c)
+                {
+                    ma[4 * r + c] = _components[offset + 3 * c + r][index];
+                }
+                ma[4 * r + 3] = _components[offset + 9 + r][index];
+                ma[12 + r] = scalar_t(0);
+            }
+            ma[15] = scalar_t(1);
+            return ma;
+        }
+
+        /** @return a copy of the transform at the given index, the inverse is not recomputed if it is available */
+        transform_t operator[](std::size_t index) const
+        {
+            using array16 = array_s<scalar_t, 16>;
+            if constexpr (std::is_constructible_v<transform_t, const array16 &, const array16 &>)
+            {
+                if (has_inverse())
+                {
+                    return transform_t(matrix(index), matrix(index, inverse_offset));
+                }
+            }
+            return transform_t(matrix(index));
+        }
+
+        /** Prefetch the components of a transform or of its inverse
+         *
+         * @param index the index of the transform, needs to be valid
+         * @param offset 0 for the transform, inverse_offset for its inverse
+         **/
+        void prefetch_components(std::size_t index, unsigned int offset) const
+        {
+            assert(index < size());
+            for (unsigned int k = offset; k < offset + n_components; ++k)
+            {
+                prefetch_address(_components[k] + index);
+            }
+        }
+
+        /** Prefetch all components of a transform and its inverse
+         *
+         * @param index the index of the transform, needs to be valid
+         **/
+        void prefetch(std::size_t index) const
+        {
+            prefetch_components(index, 0);
+            if (has_inverse())
+            {
+                prefetch_components(index, inverse_offset);
+            }
+        }
+
+        /** Transform every input element with the transform it is indexed with, reading the
+         *  matrix components directly from the component arrays. Without the inverse components,
+         *  the inverse transforms are taken to be rigid body transforms, i.e. R^T (x - t).
+         *
+         * @tparam kINVERSE whether to use the inverse transforms
+         * @tparam kTRANSLATE whether to apply the translation (points) or not (vectors)
+         *
+         * @param indices the transform index of every input element
+         * @param in the input range of points/vectors
+         * @param out the output range, needs at least the size of the input range
+         **/
+        template <bool kINVERSE, bool kTRANSLATE, typename index_range_t, typename input_t, typename output_t>
+        void transform_indexed(const index_range_t &indices, const input_t &in, output_t &out) const
+        {
+            assert(indices.size() >= in.size());
+            assert(out.size() >= in.size());
+
+            if constexpr (kINVERSE)
+            {
+                if (not has_inverse())
+                {
+                    transform_rigid_inverse<kTRANSLATE>(indices, in, out);
+                    return;
+                }
+            }
+
+            constexpr unsigned int offset = kINVERSE ? inverse_offset : 0;
+            std::array<const scalar_t *, n_components> m;
+            for (unsigned int k = 0; k < n_components; ++k)
+            {
+                m[k] = _components[offset + k];
+            }
+
+            const std::size_t n = in.size();
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                if (i + prefetch_distance < n)
+                {
+                    prefetch_components(indices[i + prefetch_distance], offset);
+                }
+                const std::size_t j = indices[i];
+                const scalar_t x = in[i][0], y = in[i][1], z = in[i][2];
+                out[i] = vector3_t{m[0][j] * x + m[3][j] * y + m[6][j] * z + (kTRANSLATE ? m[9][j] : scalar_t(0)),
+                                   m[1][j] * x + m[4][j] * y + m[7][j] * z + (kTRANSLATE ? m[10][j] : scalar_t(0)),
+                                   m[2][j] * x + m[5][j] * y + m[8][j] * z + (kTRANSLATE ? m[11][j] : scalar_t(0))};
+            }
+        }
+
+        /** Transform every input element with the inverse of the transform it is indexed with,
+         *  computed from the forward components as for a rigid body transform
+         *
+         * @tparam kTRANSLATE whether to subtract the translation (points) or not (vectors)
+         *
+         * @param indices the transform index of every input element
+         * @param in the input range of points/vectors
+         * @param out the output range, needs at least the size of the input range
+         **/
+        template <bool kTRANSLATE, typename index_range_t, typename input_t, typename output_t>
+        void transform_rigid_inverse(const index_range_t &indices, const input_t &in, output_t &out) const
+        {
+            const auto &m = _components;
+            const std::size_t n = in.size();
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                if (i + prefetch_distance < n)
+                {
+                    prefetch_components(indices[i + prefetch_distance], 0);
+                }
+                const std::size_t j = indices[i];
+                const scalar_t x = in[i][0] - (kTRANSLATE ? m[9][j] : scalar_t(0));
+                const scalar_t y = in[i][1] - (kTRANSLATE ? m[10][j] : scalar_t(0));
+                const scalar_t z = in[i][2] - (kTRANSLATE ? m[11][j] : scalar_t(0));
+                out[i] = vector3_t{m[0][j] * x + m[1][j] * y + m[2][j] * z,
+                                   m[3][j] * x + m[4][j] * y + m[5][j] * z,
+                                   m[6][j] * x + m[7][j] * y + m[8][j] * z};
+            }
+        }
+
+        /** This method transforms points[i] with transform[indices[i]] from the local 3D cartesian frame to the global 3D cartesian frame
+         *
+         * @param indices the transform indices
+         * @param points the input points in the local frames
+         * @param results the output points in the global frame, at least of the size of the input
+         */
+        template <typename index_range_t, typename input_t, typename output_t>
+        void point_to_global(const index_range_t &indices, const input_t &points, output_t &&results) const
+        {
+            transform_indexed<false, true>(indices, points, results);
+        }
+
+        /** This method transforms points[i] with transform[indices[i]] from the global 3D cartesian frame into the local 3D cartesian frame
+         *
+         * @param indices the transform indices
+         * @param points the input points in the global frame
+         * @param results the output points in the local frames, at least of the size of the input
+         */
+        template <typename index_range_t, typename input_t, typename output_t>
+        void point_to_local(const index_range_t &indices, const input_t &points, output_t &&results) const
+        {
+            transform_indexed<true, true>(indices, points, results);
+        }
+
+        /** This method transforms vectors[i] with transform[indices[i]] from the local 3D cartesian frame to the global 3D cartesian frame
+         *
+         * @param indices the transform indices
+         * @param vectors the input vectors in the local frames
+         * @param results the output vectors in the global frame, at least of the size of the input
+         */
+        template <typename index_range_t, typename input_t, typename output_t>
+        void vector_to_global(const index_range_t &indices, const input_t &vectors, output_t &&results) const
+        {
+            transform_indexed<false, false>(indices, vectors, results);
+        }
+
+        /** This method transforms vectors[i] with transform[indices[i]] from the global 3D cartesian frame into the local 3D cartesian frame
+         *
+         * @param indices the transform indices
+         * @param vectors the input vectors in the global frame
+         * @param results the output vectors in the local frames, at least of the size of the input
+         */
+        template <typename index_range_t, typename input_t, typename output_t>
+        void vector_to_local(const index_range_t &indices, const input_t &vectors, output_t &&results) const
+        {
+            transform_indexed<true, false>(indices, vectors, results);
+        }
+    };
+
+    /** Structure of arrays layout: the 3x3 rotation and the translation of every transform and
+     *  of its inverse are stored component by component. The components are extracted through
+     *  the transform interface, so that any plugin transform can be stored.
+     */
+    template <typename transform_t, typename vector3_t>
+    struct transform_store<transform_t, vector3_t, soa_layout>
+    {
+        using transform_type = transform_t;
+        using scalar_t = std::decay_t<decltype(std::declval<const vector3_t &>()[0])>;
+        using component_type = std::vector<scalar_t, aligned_allocator<scalar_t>>;
+
+        // Number of iterations the batched kernels prefetch ahead
+        static constexpr std::size_t prefetch_distance = 8;
+
+        // Components per transform: rotation (column major) and translation
+        static constexpr unsigned int n_components = 12;
+        // Offset of the components of the inverse transform
+        static constexpr unsigned int inverse_offset = n_components;
+
+        std::array<component_type, 2 * n_components> _components;
+
+        /** @return the number of stored transforms */
+        std::size_t size() const
+        {
+            return _components[0].size();
+        }
+
+        /** @return whether the store is empty */
+        bool empty() const
+        {
+            return _components[0].empty();
+        }
+
+        /** Reserve memory for n transforms */
+        void reserve(std::size_t n)
+        {
+            for (auto &component : _components)
+            {
+                component.reserve(n);
+            }
+        }
+
+        /** Remove all transforms */
+        void clear()
+        {
+            for (auto &component : _components)
+            {
+                component.clear();
+            }
+        }
+
+        /** Add a transform to the store
+         *
+         * @param trf the transform
+         *
+         * @return the index of the transform
+         **/
+        std::size_t push_back(const transform_t &trf)
+        {
+            for (auto &component : _components)
+            {
+                component.emplace_back();
+            }
+            set(size() - 1, trf);
+            return size() - 1;
+        }
+
+        /** Overwrite a stored transform
+         *
+         * @param index the index of the transform, needs to be valid
+         * @param trf the transform
+         **/
+        void set(std::size_t index, const transform_t &trf)
+        {
+            assert(index < size());
+            const std::array<vector3_t, 3> axes = {vector3_t{scalar_t(1), scalar_t(0), scalar_t(0)},
+                                                   vector3_t{scalar_t(0), scalar_t(1), scalar_t(0)},
+                                                   vector3_t{scalar_t(0), scalar_t(0), scalar_t(1)}};
+            const vector3_t origin{scalar_t(0), scalar_t(0), scalar_t(0)};
+
+            for (unsigned int c = 0; c < 3; ++c)
+            {
+                const vector3_t column = trf.vector_to_global(axes[c]);
+                const vector3_t column_inv = trf.vector_to_local(axes[c]);
+                for (unsigned int r = 0; r < 3; ++r)
+                {
+                    _components[3 * c + r][index] = column[r];
+                    _components[inverse_offset + 3 * c + r][index] = column_inv[r];
+                }
+            }
+            const vector3_t translation = trf.point_to_global(origin);
+            const vector3_t translation_inv = trf.point_to_local(origin);
+            for (unsigned int r = 0; r < 3; ++r)
+            {
+                _components[9 + r][index] = translation[r];
+                _components[inverse_offset + 9 + r][index] = translation_inv[r];
+            }
+        }
+
+        /** Construct a transform and add it to the store
+         *
+         * @param args the transform constructor arguments
+         *
+         * @return the index of the transform
+         **/
+        template <typename... args_t>
+        std::size_t emplace_back(args_t &&... args)
+        {
+            return push_back(transform_t(std::forward<args_t>(args)...));
+        }
+
+        /** Add the transforms of a contiguous buffer of matrices, e.g. of a detector description.
+         *  The inverses are computed for isometry_block::lanes transforms at once and written
+         *  to the component arrays directly. Unless the transform type assumes rigid body
+         *  transforms itself, matrices that are not rigid body transforms are inverted by the
+         *  transform constructor.
+         *
+         * @param buffer the matrices, row major 4x4 (stride 16) or 3x4 (stride 12)
+         * @param n the number of matrices
+         * @param stride the number of scalars per matrix, 16 or 12
+         * @param n_threads the number of threads that fill the components
+         **/
+        void append(const scalar_t *buffer, std::size_t n, unsigned int stride = 16, unsigned int n_threads = 1)
+        {
+            using block_type = detail::isometry_block<scalar_t>;
+
+            const std::size_t offset = size();
+            for (auto &component : _components)
+            {
+                component.resize(offset + n);
+            }
+            detail::parallel_ranges(n, n_threads, block_type::lanes, [&](std::size_t begin, std::size_t end) {
+                block_type block;
+                for (std::size_t b = begin; b < end; b += block_type::lanes)
+                {
+                    const std::size_t count = std::min(block_type::lanes, end - b);
+                    block.load(buffer + b * stride, stride, count);
+                    for (unsigned int k = 0; k < n_components; ++k)
+                    {
+                        scalar_t *component = _components[k].data() + offset + b;
+                        scalar_t *component_inv = _components[inverse_offset + k].data() + offset + b;
+                        if (count == block_type::lanes)
+                        {
+                            std::copy_n(block._m[k].begin(), block_type::lanes, component);
+                            std::copy_n(block._m_inv[k].begin(), block_type::lanes, component_inv);
+                        }
+                        else
+                        {
+                            std::copy_n(block._m[k].begin(), count, component);
+                            std::copy_n(block._m_inv[k].begin(), count, component_inv);
+                        }
+                    }
+                    if constexpr (not detail::assumes_isometry<transform_t>::value)
+                    {
+                        for (std::size_t l = 0; l < count; ++l)
+                        {
+                            if (not block.is_isometry(l))
+                            {
+                                set(offset + b + l, transform_t(block.matrix(l)));
+                            }
+                        }
+                    }
+                }
+            });
+        }
+
+        /** @return whether the inverse transforms are available, which a store always has */
+        bool has_inverse() const
+        {
+            return true;
+        }
+
+        /** The 4x4 matrix of a stored transform
+         *
+         * @param index the index of the transform
+         * @param offset 0 for the transform, inverse_offset for its inverse
+         *
+         * @return the matrix as row major 16 array
+         **/
+        array_s<scalar_t, 16> matrix(std::size_t index, unsigned int offset = 0) const
+        {
+            array_s<scalar_t, 16> ma;
+            for (unsigned int r = 0; r < 3; ++r)
+            {
+                for (unsigned int c = 0; c < 3; ++c)
+                {
+                    ma[4 * r + c] = _components[offset + 3 * c + r][index];
+                }
+                ma[4 * r + 3] = _components[offset + 9 + r][index];
+                ma[12 + r] = scalar_t(0);
+            }
+            ma[15] = scalar_t(1);
+            return ma;
+        }
+
+        /** @return a read-only view of the component arrays, valid until the store is changed */
+        transform_view<transform_t, vector3_t> view() const
+        {
+            transform_view<transform_t, vector3_t> v;
+            for (unsigned int k = 0; k < 2 * n_components; ++k)
+            {
+                v._components[k] = _components[k].data();
+            }
+            v._size = size();
+            return v;
+        }
+
+        /** @return a copy of the transform at the given index, the inverse is not recomputed if the transform can take it */
+        transform_t operator[](std::size_t index) const
+        {
+            using array16 = array_s<scalar_t, 16>;
+            if constexpr (std::is_constructible_v<transform_t, const array16 &, const array16 &>)
+            {
+                return transform_t(matrix(index), matrix(index, inverse_offset));
+            }
+            else
+            {
+                return transform_t(matrix(index));
+            }
+        }
+
+        /** @return a copy of the transform at the given index, throws std::out_of_range for an invalid index */
+        transform_t at(std::size_t index) const
+        {
+            if (index >= size())
+            {
+                throw std::out_of_range("transform_store::at: index out of range");
+            }
+            return operator[](index);
+        }
+
+        /** Prefetch the components of a transform or of its inverse
+         *
+         * @param index the index of the transform, needs to be valid
+         * @param offset 0 for the transform, inverse_offset for its inverse
+         **/
+        void prefetch_components(std::size_t index, unsigned int offset) const
+        {
+            assert(index < size());
+            for (unsigned int k = offset; k < offset + n_components; ++k)
+            {
+                prefetch_address(_components[k].data() + index);
+            }
+        }
+
+        /** Prefetch all components of a transform and its inverse
+         *
+         * @param index the index of the transform, needs to be valid
+         **/
+        void prefetch(std::size_t index) const
+        {
+            prefetch_components(index, 0);
+            prefetch_components(index, inverse_offset);
+        }
+
+        /** Transform every input element with the transform it is indexed with, reading the
+         *  matrix components directly from the component arrays
+         *
+         * @tparam kINVERSE whether to use the inverse transforms
+         * @tparam kTRANSLATE whether to apply the translation (points) or not (vectors)
+         *
+         * @param indices the transform index of every input element
+         * @param in the input range of points/vectors
+         * @param out the output range, needs at least the size of the input range
+         **/
+        template <bool kINVERSE, bool kTRANSLATE, typename index_range_t, typename input_t, typename output_t>
+        void transform_indexed(const index_range_t &indices, const input_t &in, output_t &out) const
+        {
+            view().template transform_indexed<kINVERSE, kTRANSLATE>(indices, in, out);
+        }
+
+        /** This method transforms points[i] with transform[indices[i]] from the local 3D cartesian frame to the global 3D cartesian frame
+         *
+         * @param indices the transform indices
+         * @param points the input points in the local frames
+         * @param results the output points in the global frame, at least of the size of the input
+         */
+        template <typename index_range_t, typename input_t, typename output_t>
+        void point_to_global(const index_range_t &indices, const input_t &points, output_t &&results) const
+        {
+            transform_indexed<false, true>(indices, points, results);
+        }
+
+        /** This method transforms points[i] with transform[indices[i]] from the global 3D cartesian frame into the local 3D cartesian frame
+         *
+         * @param indices the transform indices
+         * @param points the input points in the global frame
+         * @param results the output points in the local frames, at least of the size of the input
+         */
+        template <typename index_range_t, typename input_t, typename output_t>
+        void point_to_local(const index_range_t &indices, const input_t &points, output_t &&results) const
+        {
+            transform_indexed<true, true>(indices, points, results);
+        }
+
+        /** This method transforms vectors[i] with transform[indices[i]] from the local 3D cartesian frame to the global 3D cartesian frame
+         *
+         * @param indices the transform indices
+         * @param vectors the input vectors in the local frames
+         * @param results the output vectors in the global frame, at least of the size of the input
+         */
+        template <typename index_range_t, typename input_t, typename output_t>
+        void vector_to_global(const index_range_t &indices, const input_t &vectors, output_t &&results) const
+        {
+            transform_indexed<false, false>(indices, vectors, results);
+        }
+
+        /** This method transforms vectors[i] with transform[indices[i]] from the global 3D cartesian frame into the local 3D cartesian frame
+         *
+         * @param indices the transform indices
+         * @param vectors the input vectors in the global frame
+         * @param results the output vectors in the local frames, at least of the size of the input
+         */
+        template <typename index_range_t, typename input_t, typename output_t>
+        void vector_to_local(const index_range_t &indices, const input_t &vectors, output_t &&results) const
+        {
+            transform_indexed<true, false>(indices, vectors, results);
+        }
+
+        /** Apply alignment corrections in the local frames of the transforms, see transform3::apply_delta.
+         *  With the correction (dR, dt) the components are updated as
+         *  R -> R dR, t -> t + R dt and R^-1 -> dR^T R^-1, t^-1 -> dR^T (t^-1 - dt)
+         *
+         * @param indices the indices of the corrected transforms
+         * @param rotation_deltas the rotation vectors of the corrections, axis times angle
+         * @param translation_deltas the translations of the corrections
+         **/
+        template <typename index_range_t, typename rotation_range_t, typename translation_range_t>
+        void apply_delta(const index_range_t &indices, const rotation_range_t &rotation_deltas,
+                         const translation_range_t &translation_deltas)
+        {
+            assert(rotation_deltas.size() >= indices.size());
+            assert(translation_deltas.size() >= indices.size());
+
+            const std::size_t n = indices.size();
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                const std::size_t j = indices[i];
+                const auto &w = rotation_deltas[i];
+                const auto &dt = translation_deltas[i];
+                const std::array<scalar_t, 9> d = rotation_matrix<scalar_t>(w[0], w[1], w[2]);
+
+                std::array<scalar_t, n_components> m, m_inv;
+                for (unsigned int k = 0; k < n_components; ++k)
+                {
+                    m[k] = _components[k][j];
+                    m_inv[k] = _components[inverse_offset + k][j];
+                }
+
+                for (unsigned int r = 0; r < 3; ++r)
+                {
+                    for (unsigned int c = 0; c < 3; ++c)
+                    {
+                        // (R dR)(r, c) and (dR^T R^-1)(r, c)
+                        _components[3 * c + r][j] = m[r] * d[3 * c] + m[3 + r] * d[3 * c + 1] + m[6 + r] * d[3 * c + 2];
+                        _components[inverse_offset + 3 * c + r][j] =
+                            d[3 * r] * m_inv[3 * c] + d[3 * r + 1] * m_inv[3 * c + 1] + d[3 * r + 2] * m_inv[3 * c + 2];
+                    }
+                    _components[9 + r][j] = m[9 + r] + m[r] * dt[0] + m[3 + r] * dt[1] + m[6 + r] * dt[2];
+                    _components[inverse_offset + 9 + r][j] = d[3 * r] * (m_inv[9] - dt[0]) +
+                                                             d[3 * r + 1] * (m_inv[10] - dt[1]) +
+                                                             d[3 * r + 2] * (m_inv[11] - dt[2]);
+                }
+            }
+        }
+    };
+
+} // namespace algebra
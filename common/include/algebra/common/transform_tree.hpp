@@ -0,0 +1,207 @@
+/** Algebra plugins, part of the ACTS project
+ *
+ * (c) 2020 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#pragma once
+
+#include "common/aligned_allocator.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace algebra
+{
+    /** Hierarchy of placements, e.g. volume -> layer -> module, that is addressed by index.
+     *
+     *  Every node holds its transform relative to the parent node. The global transforms
+     *  (and with them their inverses) are composed on first use and cached. Changing a
+     *  local transform only invalidates the cached global transforms of its subtree.
+     *
+     *  Parents have to be added before their children, so that a single pass in index
+     *  order flattens the whole tree.
+     *
+     * @tparam transform_t the plugin transform type, needs operator* for the composition
+     *
+     * @note The lazy evaluation in global() is not thread-safe, call flatten() before the
+     *       tree is shared between threads
+     **/
+    template <typename transform_t>
+    struct transform_tree
+    {
+        using transform_type = transform_t;
+        using container_type = std::vector<transform_t, aligned_allocator<transform_t>>;
+
+        // Parent index of the root nodes, and end marker of the child lists
+        static constexpr std::size_t no_node = std::numeric_limits<std::size_t>::max();
+
+        container_type _local;
+        mutable container_type _global;
+        mutable std::vector<bool> _valid;
+
+        // Tree structure: parent, first child and next sibling of every node
+        std::vector<std::size_t> _parents;
+        std::vector<std::size_t> _first_child;
+        std::vector<std::size_t> _next_sibling;
+
+        /** @return the number of nodes */
+        std::size_t size() const
+        {
+            return _local.size();
+        }
+
+        /** @return whether the tree is empty */
+        bool empty() const
+        {
+            return _local.empty();
+        }
+
+        /** Reserve memory for n nodes */
+        void reserve(std::size_t n)
+        {
+            _local.reserve(n);
+            _global.reserve(n);
+            _valid.reserve(n);
+            _parents.reserve(n);
+            _first_child.reserve(n);
+            _next_sibling.reserve(n);
+        }
+
+        /** Remove all nodes */
+        void clear()
+        {
+            _local.clear();
+            _global.clear();
+            _valid.clear();
+            _parents.clear();
+            _first_child.clear();
+            _next_sibling.clear();
+        }
+
+        /** Add a node to the tree
+         *
+         * @param local the transform relative to the parent, or the global transform of a root node
+         * @param parent the index of the parent node, no_node for a root node
+         *
+         * @return the index of the node
+         **/
+        std::size_t add(const transform_t &local, std::size_t parent = no_node)
+        {
+            assert(parent == no_node or parent < size());
+
+            const std::size_t index = size();
+            _local.push_back(local);
+            _global.push_back(local);
+            _valid.push_back(parent == no_node);
+            _parents.push_back(parent);
+            _first_child.push_back(no_node);
+            _next_sibling.push_back(no_node);
+            if (parent != no_node)
+            {
+                _next_sibling[index] = _first_child[parent];
+                _first_child[parent] = index;
+            }
+            return index;
+        }
+
+        /** @return the index of the parent node, no_node for a root node */
+        std::size_t parent(std::size_t index) const
+        {
+            return _parents[index];
+        }
+
+        /** @return the transform of a node relative to its parent */
+        const transform_t &local(std::size_t index) const
+        {
+            return _local[index];
+        }
+
+        /** Change the transform of a node relative to its parent, e.g. for an alignment update
+         *
+         * @param index the index of the node
+         * @param local the new relative transform
+         **/
+        void set_local(std::size_t index, const transform_t &local)
+        {
+            _local[index] = local;
+            invalidate(index);
+        }
+
+        /** @return whether the global transform of a node is cached */
+        bool is_valid(std::size_t index) const
+        {
+            return _valid[index];
+        }
+
+        /** Retrieve the global transform of a node, the global transforms of the node and its
+         *  ancestors are composed if they are not cached
+         *
+         * @param index the index of the node
+         **/
+        const transform_t &global(std::size_t index) const
+        {
+            if (not _valid[index])
+            {
+                const std::size_t p = _parents[index];
+                _global[index] = (p == no_node) ? _local[index] : global(p) * _local[index];
+                _valid[index] = true;
+            }
+            return _global[index];
+        }
+
+        /** Compose all global transforms that are not cached, in one pass in index order */
+        void flatten() const
+        {
+            const std::size_t n = size();
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                if (not _valid[i])
+                {
+                    const std::size_t p = _parents[i];
+                    _global[i] = (p == no_node) ? _local[i] : _global[p] * _local[i];
+                    _valid[i] = true;
+                }
+            }
+        }
+
+        /** Drop the cached global transforms of a node and of all its descendants
+         *
+         * @param index the index of the subtree root
+         *
+         * @note Descendants of an invalid node are invalid as well, so the traversal
+         *       stops at nodes that are already invalid
+         **/
+        void invalidate(std::size_t index)
+        {
+            if (not _valid[index])
+            {
+                return;
+            }
+            _valid[index] = false;
+
+            // Depth first through the child lists, climbing back up by the parent indices
+            std::size_t node = _first_child[index];
+            while (node != no_node)
+            {
+                std::size_t next = no_node;
+                if (_valid[node])
+                {
+                    _valid[node] = false;
+                    next = _first_child[node];
+                }
+                // Continue with the next sibling of the node or of its closest ancestor
+                while (next == no_node and node != index)
+                {
+                    next = _next_sibling[node];
+                    node = _parents[node];
+                }
+                node = next;
+            }
+        }
+    };
+
+} // namespace algebra
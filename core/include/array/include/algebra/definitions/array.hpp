@@ -7,17 +7,28 @@
  
 #pragma once
 
+#include "common/math.hpp"
+#include "common/projection.hpp"
+#include "common/quaternion.hpp"
+#include "common/rotation.hpp"
+#include "common/scalar.hpp"
+#include "common/small_matrix.hpp"
+#include "common/sparsity_pattern.hpp"
+#include "common/spherical.hpp"
+#include "common/symmetric_matrix.hpp"
+#include "common/transform_codec.hpp"
+#include "common/transform_file.hpp"
+#include "common/transform_kind.hpp"
+#include "common/transform_store.hpp"
+#include "common/transform_tree.hpp"
 #include "common/types.hpp"
 
 #include <any>
+#include <cassert>
 #include <cmath>
 #include <array>
-
-#ifdef ALGEBRA_PLUGIN_CUSTOM_SCALARTYPE
-using algebra_scalar = ALGEBRA_PLUGIN_CUSTOM_SCALARTYPE;
-#else
-using algebra_scalar = double;
-#endif
+#include <cstddef>
+#include <limits>
 
 // namespace of the algebra object definitions
 #define __plugin algebra::array
@@ -29,8 +40,6 @@ using algebra_scalar = double;
 namespace algebra
 {
 
-    using scalar = algebra_scalar;
-
     inline std::array<scalar, 2> operator*(const std::array<scalar, 2> &a, scalar s)
     {
         return {a[0] * s, a[1] * s};
@@ -95,21 +104,23 @@ namespace algebra
         /** This method retrieves phi from a vector, vector base with rows > 2
          * 
          * @param v the input vector 
+         * @param precision the accuracy of the elementary functions
          **/
-        template <typename vector_type>
-        auto phi(const vector_type &v) noexcept
+        template <typename vector_type, typename precision_t = math::default_precision>
+        auto phi(const vector_type &v, precision_t precision = {}) noexcept
         {
-            return std::atan2(v[1], v[0]);
+            return math::atan2(v[1], v[0], precision);
         }
 
         /** This method retrieves theta from a vector, vector base with rows >= 3
          * 
          * @param v the input vector 
+         * @param precision the accuracy of the elementary functions
          **/
-        template <typename vector_type>
-        auto theta(const vector_type &v) noexcept
+        template <typename vector_type, typename precision_t = math::default_precision>
+        auto theta(const vector_type &v, precision_t precision = {}) noexcept
         {
-            return std::atan2(std::sqrt(v[0] * v[0] + v[1] * v[1]), v[2]);
+            return math::atan2(std::sqrt(v[0] * v[0] + v[1] * v[1]), v[2], precision);
         }
 
         /** This method retrieves the perpenticular magnitude of a vector with rows >= 2
@@ -143,11 +154,12 @@ namespace algebra
         /** This method retrieves the pseudo-rapidity from a vector or vector base with rows >= 3
          * 
          * @param v the input vector 
+         * @param precision the accuracy of the elementary functions
          **/
-        template <typename vector_type>
-        auto eta(const vector_type &v) noexcept
+        template <typename vector_type, typename precision_t = math::default_precision>
+        auto eta(const vector_type &v, precision_t precision = {}) noexcept
         {
-            return std::atanh(v[2] / norm(v));
+            return math::atanh(v[2] / norm(v), precision);
         }
 
         /** This method retrieves a column from a matrix
@@ -191,15 +203,47 @@ namespace algebra
         using vector3 = std::array<scalar, 3>;
         using point3 = vector3;
         using point2 = std::array<scalar, 2>;
+        using quaternion = algebra::quaternion<scalar>;
+
+        /** Fixed size matrix, e.g. for the track parameter covariances
+         *
+         * @tparam kROWS the number of rows
+         * @tparam kCOLS the number of columns
+         **/
+        template <unsigned int kROWS, unsigned int kCOLS>
+        using matrix = algebra::small_matrix<scalar, kROWS, kCOLS>;
+
+        /** Symmetric matrix with packed storage, e.g. for the track parameter covariances
+         *
+         * @tparam kN the matrix size
+         **/
+        template <unsigned int kN>
+        using symmetric_matrix = algebra::symmetric_matrix<scalar, kN>;
 
         /** Transform wrapper class to ensure standard API within differnt plugins
          **/
         struct transform3
         {
+            // Whether the constructor from a matrix takes it to be a rigid body transform
+#ifdef ALGEBRA_PLUGIN_VALIDATE_ISOMETRY
+            static constexpr bool assumes_isometry = false;
+#else
+            static constexpr bool assumes_isometry = true;
+#endif
+
             using matrix44 = std::array<std::array<scalar, 4>, 4>;
+            // Matrix in the accumulation precision, for the general inversion
+            using matrix44_acc = std::array<std::array<accumulator, 4>, 4>;
 
             matrix44 _data;
+#ifdef ALGEBRA_PLUGIN_LAZY_INVERSE
+            mutable matrix44 _data_inv;
+            mutable bool _has_inverse = true;
+#else
             matrix44 _data_inv;
+#endif
+            // Selects the kernel of the point and vector transformations
+            transform_kind _kind = transform_kind::general;
 
             /** Contructor with arguments: t, z, x
              * 
@@ -230,7 +274,7 @@ namespace algebra
                 _data[3][2] = t[2];
                 _data[3][3] = 1.;
 
-                _data_inv = invert(_data);
+                update_inverse();
             }
 
             /** Constructor with arguments: translation
@@ -256,7 +300,34 @@ namespace algebra
                 _data[3][2] = t[2];
                 _data[3][3] = 1.;
 
-                _data_inv = invert(_data);
+                update_inverse();
+            }
+
+            /** Constructor with arguments: translation and rotation quaternion, the inverse is
+             *  set up from the transposed rotation and not computed by an inversion
+             *
+             * @param t the translation (or origin of the new frame)
+             * @param q the rotation, a unit quaternion
+             **/
+            transform3(const vector3 &t, const quaternion &q)
+            {
+                const auto r = q.rotation_matrix();
+                for (unsigned int c = 0; c < 3; ++c)
+                {
+                    for (unsigned int k = 0; k < 3; ++k)
+                    {
+                        _data[c][k] = r[3 * c + k];
+                        _data_inv[k][c] = r[3 * c + k];
+                    }
+                    _data[c][3] = 0.;
+                    _data_inv[c][3] = 0.;
+                    _data[3][c] = t[c];
+                    _data_inv[3][c] = static_cast<scalar>(-(accumulator(r[3 * c]) * t[0] + accumulator(r[3 * c + 1]) * t[1] +
+                                                            accumulator(r[3 * c + 2]) * t[2]));
+                }
+                _data[3][3] = 1.;
+                _data_inv[3][3] = 1.;
+                _kind = classify(_data);
             }
 
             /** Constructor with arguments: matrix 
@@ -266,6 +337,8 @@ namespace algebra
             transform3(const matrix44 &m)
             {
                 _data = m;
+
+                update_inverse();
             }
 
             /** Constructor with arguments: matrix as std::aray of scalar
@@ -291,9 +364,35 @@ namespace algebra
                 _data[3][2] = ma[11];
                 _data[3][3] = ma[15];
 
-                _data_inv = invert(_data);
+                update_inverse();
             }
 
+            /** Constructor with arguments: matrix and inverse matrix as std::aray of scalar,
+             *  the inverse is taken as it is
+             * 
+             * @param ma is the full 4x4 matrix 16 array
+             * @param ma_inv is the full 4x4 inverse matrix 16 array
+             **/
+            transform3(const array_s<scalar, 16> &ma, const array_s<scalar, 16> &ma_inv)
+            {
+                for (unsigned int c = 0; c < 4; ++c)
+                {
+                    for (unsigned int r = 0; r < 4; ++r)
+                    {
+                        _data[c][r] = ma[4 * r + c];
+                        _data_inv[c][r] = ma_inv[4 * r + c];
+                    }
+                }
+                _kind = classify(_data);
+            }
+
+            /** Constructor with arguments: matrix and inverse matrix, the inverse is taken as it is
+             *
+             * @param m is the full 4x4 matrix
+             * @param m_inv is the full 4x4 inverse matrix
+             **/
+            transform3(const matrix44 &m, const matrix44 &m_inv) : _data(m), _data_inv(m_inv), _kind(classify(m)) {}
+
             /** Constructor with arguments: identity
              *
              **/
@@ -317,6 +416,7 @@ namespace algebra
                 _data[3][3] = 1.;
 
                 _data_inv = _data;
+                _kind = transform_kind::identity;
             }
 
             /** Default contructors */
@@ -329,13 +429,99 @@ namespace algebra
                 return (_data == rhs._data);
             }
 
+            /** Composition: the result applies rhs first and this transform second
+             *
+             * @param rhs is the transform to be applied first
+             *
+             * @note the inverse is the product of the two inverses in reverse order,
+             *       with ALGEBRA_PLUGIN_LAZY_INVERSE they are set up by this call
+             **/
+            transform3 operator*(const transform3 &rhs) const
+            {
+                return transform3(multiply(_data, rhs._data), multiply(rhs.inverse(), inverse()));
+            }
+
+            /** Composition with the inverse: the result applies rhs first and the inverse
+             *  of this transform second, e.g. the placement of a child relative to its parent
+             *  is parent.compose_inverse(child) for the global placements of both
+             *
+             * @param rhs is the transform to be applied first
+             **/
+            transform3 compose_inverse(const transform3 &rhs) const
+            {
+                return transform3(multiply(inverse(), rhs._data), multiply(rhs.inverse(), _data));
+            }
+
+            /** Apply an alignment correction in the local frame, i.e. p -> R (dR p + dt) + t. The
+             *  inverse is composed with the inverse of the correction and not recomputed.
+             *
+             * @param rotation_delta the rotation vector dR of the correction, axis times angle
+             * @param translation_delta the translation dt of the correction
+             **/
+            void apply_delta(const vector3 &rotation_delta, const vector3 &translation_delta)
+            {
+                const auto r = rotation_matrix<scalar>(rotation_delta[0], rotation_delta[1], rotation_delta[2]);
+                *this = *this * transform3(translation_delta, vector3{r[6], r[7], r[8]}, vector3{r[0], r[1], r[2]});
+            }
+
+            /** Set up the kind and the inverse after the matrix has been changed: the inverse is
+             *  computed right away, or on first use if ALGEBRA_PLUGIN_LAZY_INVERSE is defined
+             **/
+            void update_inverse()
+            {
+                _kind = classify(_data);
+#ifdef ALGEBRA_PLUGIN_LAZY_INVERSE
+                _has_inverse = false;
+#else
+                _data_inv = invert_transform(_data, _kind);
+#endif
+            }
+
+            /** The kind of a 4x4 matrix, see classify_transform(). Matrices with a last row
+             *  other than (0, 0, 0, 1) are general.
+             */
+            static transform_kind classify(const matrix44 &m)
+            {
+                if (m[0][3] != 0. or m[1][3] != 0. or m[2][3] != 0. or m[3][3] != 1.)
+                {
+                    return transform_kind::general;
+                }
+                return classify_transform<scalar>({m[0][0], m[0][1], m[0][2], m[1][0], m[1][1], m[1][2],
+                                                   m[2][0], m[2][1], m[2][2]},
+                                                  {m[3][0], m[3][1], m[3][2]});
+            }
+
+            /** This method retrieves the kind of a transform */
+            transform_kind kind() const
+            {
+                return _kind;
+            }
+
+            /** This method retrieves the inverse of a transform
+             *
+             * @note With ALGEBRA_PLUGIN_LAZY_INVERSE the first call computes and caches the inverse,
+             *       it is not thread-safe and must not race with other calls on the same transform
+             **/
+            const matrix44 &inverse() const
+            {
+#ifdef ALGEBRA_PLUGIN_LAZY_INVERSE
+                if (not _has_inverse)
+                {
+                    _data_inv = invert_transform(_data, _kind);
+                    _has_inverse = true;
+                }
+#endif
+                return _data_inv;
+            }
+
             /** The determinant of a 4x4 matrix
              * 
              * @param m is the matrix
              *
              * @return a sacalar determinant - no checking done 
              */
-            static scalar determinant(const matrix44 &m)
+            template <typename matrix_type>
+            static auto determinant(const matrix_type &m)
             {
                 return m[3][0] * m[2][1] * m[1][2] * m[0][3] - m[2][0] * m[3][1] * m[1][2] * m[0][3] - m[3][0] * m[1][1] * m[2][2] * m[0][3] + m[1][0] * m[3][1] * m[2][2] * m[0][3] +
                        m[2][0] * m[1][1] * m[3][2] * m[0][3] - m[1][0] * m[2][1] * m[3][2] * m[0][3] - m[3][0] * m[2][1] * m[0][2] * m[1][3] + m[2][0] * m[3][1] * m[0][2] * m[1][3] +
@@ -350,10 +536,19 @@ namespace algebra
              * @param m is the matrix
              *
              * @return an inverse matrix 
+             *
+             * @note the cofactors and the determinant are accumulated in the accumulator type
              */
-            static matrix44 invert(const matrix44 &m)
+            static matrix44 invert(const matrix44 &ms)
             {
-                matrix44 i;
+                matrix44_acc m, i;
+                for (unsigned int c = 0; c < 4; ++c)
+                {
+                    for (unsigned int r = 0; r < 4; ++r)
+                    {
+                        m[c][r] = ms[c][r];
+                    }
+                }
                 i[0][0] = m[2][1] * m[3][2] * m[1][3] - m[3][1] * m[2][2] * m[1][3] + m[3][1] * m[1][2] * m[2][3] - m[1][1] * m[3][2] * m[2][3] - m[2][1] * m[1][2] * m[3][3] + m[1][1] * m[2][2] * m[3][3];
                 i[1][0] = m[3][0] * m[2][2] * m[1][3] - m[2][0] * m[3][2] * m[1][3] - m[3][0] * m[1][2] * m[2][3] + m[1][0] * m[3][2] * m[2][3] + m[2][0] * m[1][2] * m[3][3] - m[1][0] * m[2][2] * m[3][3];
                 i[2][0] = m[2][0] * m[3][1] * m[1][3] - m[3][0] * m[2][1] * m[1][3] + m[3][0] * m[1][1] * m[2][3] - m[1][0] * m[3][1] * m[2][3] - m[2][0] * m[1][1] * m[3][3] + m[1][0] * m[2][1] * m[3][3];
@@ -370,17 +565,90 @@ namespace algebra
                 i[1][3] = m[1][0] * m[2][2] * m[0][3] - m[2][0] * m[1][2] * m[0][3] + m[2][0] * m[0][2] * m[1][3] - m[0][0] * m[2][2] * m[1][3] - m[1][0] * m[0][2] * m[2][3] + m[0][0] * m[1][2] * m[2][3];
                 i[2][3] = m[2][0] * m[1][1] * m[0][3] - m[1][0] * m[2][1] * m[0][3] - m[2][0] * m[0][1] * m[1][3] + m[0][0] * m[2][1] * m[1][3] + m[1][0] * m[0][1] * m[2][3] - m[0][0] * m[1][1] * m[2][3];
                 i[3][3] = m[1][0] * m[2][1] * m[0][2] - m[2][0] * m[1][1] * m[0][2] + m[2][0] * m[0][1] * m[1][2] - m[0][0] * m[2][1] * m[1][2] - m[1][0] * m[0][1] * m[2][2] + m[0][0] * m[1][1] * m[2][2];
-                scalar idet = 1. / determinant(i);
+                accumulator idet = 1. / determinant(m);
+                matrix44 mi;
                 for (unsigned int c = 0; c < 4; ++c)
                 {
                     for (unsigned int r = 0; r < 4; ++r)
                     {
-                        i[c][r] *= idet;
+                        mi[c][r] = static_cast<scalar>(i[c][r] * idet);
+                    }
+                }
+                return mi;
+            }
+
+            /** The inverse of a rigid body transform, i.e. of an orthonormal rotation R
+             *  and a translation t, without the full 4x4 cofactor expansion
+             *
+             * @param m is the matrix
+             *
+             * @return the inverse matrix, built from R^T and -R^T t
+             */
+            static matrix44 invert_isometry(const matrix44 &m)
+            {
+                matrix44 i;
+                for (unsigned int c = 0; c < 3; ++c)
+                {
+                    for (unsigned int r = 0; r < 3; ++r)
+                    {
+                        i[c][r] = m[r][c];
                     }
+                    i[c][3] = 0.;
+                }
+                for (unsigned int r = 0; r < 3; ++r)
+                {
+                    i[3][r] = static_cast<scalar>(-(accumulator(m[r][0]) * m[3][0] + accumulator(m[r][1]) * m[3][1] +
+                                                    accumulator(m[r][2]) * m[3][2]));
                 }
+                i[3][3] = 1.;
                 return i;
             }
 
+            /** Check whether a 4x4 matrix describes a rigid body transform
+             *
+             * @param m is the matrix
+             *
+             * @return true if the rotation is orthonormal and the last row is (0, 0, 0, 1)
+             */
+            static bool is_isometry(const matrix44 &m)
+            {
+                constexpr scalar tolerance = 1e3 * std::numeric_limits<scalar>::epsilon();
+                for (unsigned int a = 0; a < 3; ++a)
+                {
+                    for (unsigned int b = 0; b <= a; ++b)
+                    {
+                        const accumulator d = accumulator(m[a][0]) * m[b][0] + accumulator(m[a][1]) * m[b][1] +
+                                              accumulator(m[a][2]) * m[b][2];
+                        if (std::abs(d - (a == b ? 1. : 0.)) > tolerance)
+                        {
+                            return false;
+                        }
+                    }
+                }
+                return std::abs(m[0][3]) <= tolerance and std::abs(m[1][3]) <= tolerance and
+                       std::abs(m[2][3]) <= tolerance and std::abs(m[3][3] - 1.) <= tolerance;
+            }
+
+            /** The inverse as computed at construction: the transform is taken to be a
+             *  rigid body transform. If ALGEBRA_PLUGIN_VALIDATE_ISOMETRY is defined, the
+             *  matrix is checked first and general matrices fall back to invert().
+             *
+             * @param m is the matrix
+             * @param kind is the kind of the matrix, only general matrices are checked
+             *
+             * @return an inverse matrix
+             */
+            static matrix44 invert_transform(const matrix44 &m, [[maybe_unused]] transform_kind kind = transform_kind::general)
+            {
+#ifdef ALGEBRA_PLUGIN_VALIDATE_ISOMETRY
+                if (kind == transform_kind::general and not is_isometry(m))
+                {
+                    return invert(m);
+                }
+#endif
+                return invert_isometry(m);
+            }
+
             /** Rotate a vector into / from a frame 
              * 
              * @param m is the rotation matrix
@@ -394,6 +662,29 @@ namespace algebra
                                m[0][2] * v[0] + m[1][2] * v[1] + m[2][2] * v[2]};
             }
 
+            /** The product of two affine 4x4 matrices: the rotations are multiplied and the
+             *  translation of b is rotated by a and shifted by its translation
+             *
+             * @param a is the left matrix
+             * @param b is the right matrix
+             *
+             * @return the product, with the last row (0, 0, 0, 1)
+             */
+            static matrix44 multiply(const matrix44 &a, const matrix44 &b)
+            {
+                matrix44 m;
+                for (unsigned int c = 0; c < 4; ++c)
+                {
+                    const vector3 col = rotate(a, vector3{b[c][0], b[c][1], b[c][2]});
+                    m[c] = {col[0], col[1], col[2], 0.};
+                }
+                m[3][0] += a[3][0];
+                m[3][1] += a[3][1];
+                m[3][2] += a[3][2];
+                m[3][3] = 1.;
+                return m;
+            }
+
             /** This method retrieves the rotation of a transform */
             auto rotation() const
             {
@@ -412,52 +703,528 @@ namespace algebra
                 return _data;
             }
 
+            /** Transform a point or vector with the kernel of a transform kind, the kernels
+             *  skip the multiplications with the trivial matrix elements
+             *
+             * @tparam kKIND the kind of the matrix
+             * @tparam kTRANSLATE whether to apply the translation (points) or not (vectors)
+             *
+             * @param m is the transformation matrix
+             * @param v is the point/vector
+             */
+            template <transform_kind kKIND, bool kTRANSLATE>
+            static vector3 transform_kernel(const matrix44 &m, const vector3 &v)
+            {
+                if constexpr (kKIND == transform_kind::identity or
+                              (kKIND == transform_kind::translation and not kTRANSLATE))
+                {
+                    return v;
+                }
+                else if constexpr (kKIND == transform_kind::translation)
+                {
+                    return vector3{v[0] + m[3][0], v[1] + m[3][1], v[2] + m[3][2]};
+                }
+                else if constexpr (kKIND == transform_kind::axis_aligned)
+                {
+                    if constexpr (kTRANSLATE)
+                    {
+                        return vector3{m[0][0] * v[0] + m[3][0], m[1][1] * v[1] + m[3][1], m[2][2] * v[2] + m[3][2]};
+                    }
+                    else
+                    {
+                        return vector3{m[0][0] * v[0], m[1][1] * v[1], m[2][2] * v[2]};
+                    }
+                }
+                else
+                {
+                    vector3 rg = rotate(m, v);
+                    if constexpr (kTRANSLATE)
+                    {
+                        return vector3{rg[0] + m[3][0], rg[1] + m[3][1], rg[2] + m[3][2]};
+                    }
+                    else
+                    {
+                        return rg;
+                    }
+                }
+            }
+
             /** This method transform from a point from the local 3D cartesian frame to the global 3D cartesian frame */
             template <typename point_type>
             const point_type point_to_global(const point_type &v) const
             {
-                vector3 rg = rotate(_data, v);
-                return point3{rg[0] + _data[3][0], rg[1] + _data[3][1], rg[2] + _data[3][2]};
+                return dispatch_kind(_kind, [&](auto kind) { return point_to_global<decltype(kind)::value>(v); });
+            }
+
+            /** This method transform from a point from the local 3D cartesian frame to the global 3D cartesian frame,
+             *  with the kernel of a kind that is known at compile time
+             *
+             * @tparam kKIND the kind of the transform, or a more general one
+             */
+            template <transform_kind kKIND, typename point_type>
+            const point_type point_to_global(const point_type &v) const
+            {
+                assert(_kind <= kKIND);
+                return transform_kernel<kKIND, true>(_data, v);
             }
 
             /** This method transform from a vector from the global 3D cartesian frame into the local 3D cartesian frame */
             template <typename point_type>
             const point_type point_to_local(const point_type &v) const
             {
-                vector3 rg = rotate(_data_inv, v);
-                return point3{rg[0] + _data_inv[3][0], rg[1] + _data_inv[3][1], rg[2] + _data_inv[3][2]};
+                return dispatch_kind(_kind, [&](auto kind) { return point_to_local<decltype(kind)::value>(v); });
+            }
+
+            /** This method transform from a point from the global 3D cartesian frame into the local 3D cartesian frame,
+             *  with the kernel of a kind that is known at compile time. The inverse has the same kind.
+             *
+             * @tparam kKIND the kind of the transform, or a more general one
+             */
+            template <transform_kind kKIND, typename point_type>
+            const point_type point_to_local(const point_type &v) const
+            {
+                assert(_kind <= kKIND);
+                if constexpr (kKIND == transform_kind::identity)
+                {
+                    return v;
+                }
+                else
+                {
+                    return transform_kernel<kKIND, true>(inverse(), v);
+                }
+            }
+
+            /** This method transforms a point from the global 3D cartesian frame into the first two
+             *  coordinates of the local 3D cartesian frame, only the two needed rows are evaluated
+             */
+            template <typename point_type>
+            point2 point_to_local2(const point_type &v) const
+            {
+                return dispatch_kind(_kind, [&](auto kind) { return point_to_local2<decltype(kind)::value>(v); });
+            }
+
+            /** This method transforms a point from the global 3D cartesian frame into the first two
+             *  coordinates of the local 3D cartesian frame, with the kernel of a kind that is known
+             *  at compile time
+             *
+             * @tparam kKIND the kind of the transform, or a more general one
+             */
+            template <transform_kind kKIND, typename point_type>
+            point2 point_to_local2(const point_type &v) const
+            {
+                assert(_kind <= kKIND);
+                if constexpr (kKIND == transform_kind::identity)
+                {
+                    return point2{v[0], v[1]};
+                }
+                else
+                {
+                    const matrix44 &inv = inverse();
+                    if constexpr (kKIND == transform_kind::translation)
+                    {
+                        return point2{v[0] + inv[3][0], v[1] + inv[3][1]};
+                    }
+                    else if constexpr (kKIND == transform_kind::axis_aligned)
+                    {
+                        return point2{inv[0][0] * v[0] + inv[3][0], inv[1][1] * v[1] + inv[3][1]};
+                    }
+                    else
+                    {
+                        return point2{inv[0][0] * v[0] + inv[1][0] * v[1] + inv[2][0] * v[2] + inv[3][0],
+                                      inv[0][1] * v[0] + inv[1][1] * v[1] + inv[2][1] * v[2] + inv[3][1]};
+                    }
+                }
             }
 
             /** This method transform from a vector from the local 3D cartesian frame to the global 3D cartesian frame */
             template <typename vector_type>
             const vector_type vector_to_global(const vector_type &v) const
             {
-                return rotate(_data, v);
+                return dispatch_kind(_kind, [&](auto kind) { return vector_to_global<decltype(kind)::value>(v); });
+            }
+
+            /** This method transform from a vector from the local 3D cartesian frame to the global 3D cartesian frame,
+             *  with the kernel of a kind that is known at compile time
+             *
+             * @tparam kKIND the kind of the transform, or a more general one
+             */
+            template <transform_kind kKIND, typename vector_type>
+            const vector_type vector_to_global(const vector_type &v) const
+            {
+                assert(_kind <= kKIND);
+                return transform_kernel<kKIND, false>(_data, v);
             }
 
             /** This method transform from a vector from the global 3D cartesian frame into the local 3D cartesian frame */
             template <typename vector_type>
             const auto vector_to_local(const vector_type &v) const
             {
-                return rotate(_data_inv, v);
+                return dispatch_kind(_kind, [&](auto kind) { return vector_to_local<decltype(kind)::value>(v); });
+            }
+
+            /** This method transform from a vector from the global 3D cartesian frame into the local 3D cartesian frame,
+             *  with the kernel of a kind that is known at compile time
+             *
+             * @tparam kKIND the kind of the transform, or a more general one
+             */
+            template <transform_kind kKIND, typename vector_type>
+            const vector3 vector_to_local(const vector_type &v) const
+            {
+                assert(_kind <= kKIND);
+                if constexpr (kKIND == transform_kind::identity or kKIND == transform_kind::translation)
+                {
+                    return v;
+                }
+                else
+                {
+                    return transform_kernel<kKIND, false>(inverse(), v);
+                }
+            }
+
+            /** Transform a batch of points or vectors with a given matrix. The matrix elements
+             *  are loaded once, outside of the loop.
+             *
+             * @tparam kTRANSLATE whether to apply the translation (points) or not (vectors)
+             * @tparam kKIND the kind of the matrix, the kernels of the special kinds only use
+             *         the diagonal of the rotation
+             *
+             * @param m is the transformation matrix
+             * @param in the input range of points/vectors
+             * @param out the output range, needs at least the size of the input range
+             */
+            template <bool kTRANSLATE, transform_kind kKIND = transform_kind::general, typename input_type,
+                      typename output_type>
+            static void transform_batch(const matrix44 &m, const input_type &in, output_type &out)
+            {
+                assert(out.size() >= in.size());
+
+                const scalar t0 = kTRANSLATE ? m[3][0] : 0.;
+                const scalar t1 = kTRANSLATE ? m[3][1] : 0.;
+                const scalar t2 = kTRANSLATE ? m[3][2] : 0.;
+
+                const std::size_t n = in.size();
+                if constexpr (kKIND == transform_kind::general)
+                {
+                    const scalar m00 = m[0][0], m01 = m[1][0], m02 = m[2][0];
+                    const scalar m10 = m[0][1], m11 = m[1][1], m12 = m[2][1];
+                    const scalar m20 = m[0][2], m21 = m[1][2], m22 = m[2][2];
+
+                    for (std::size_t i = 0; i < n; ++i)
+                    {
+                        const scalar x = in[i][0], y = in[i][1], z = in[i][2];
+                        out[i] = vector3{m00 * x + m01 * y + m02 * z + t0,
+                                         m10 * x + m11 * y + m12 * z + t1,
+                                         m20 * x + m21 * y + m22 * z + t2};
+                    }
+                }
+                else if constexpr (kKIND == transform_kind::axis_aligned)
+                {
+                    const scalar m00 = m[0][0], m11 = m[1][1], m22 = m[2][2];
+
+                    for (std::size_t i = 0; i < n; ++i)
+                    {
+                        out[i] = vector3{m00 * in[i][0] + t0, m11 * in[i][1] + t1, m22 * in[i][2] + t2};
+                    }
+                }
+                else if constexpr (kKIND == transform_kind::translation and kTRANSLATE)
+                {
+                    for (std::size_t i = 0; i < n; ++i)
+                    {
+                        out[i] = vector3{in[i][0] + t0, in[i][1] + t1, in[i][2] + t2};
+                    }
+                }
+                else
+                {
+                    for (std::size_t i = 0; i < n; ++i)
+                    {
+                        out[i] = vector3{in[i][0], in[i][1], in[i][2]};
+                    }
+                }
+            }
+
+            /** This method transforms a range of points from the local 3D cartesian frame to the global 3D cartesian frame
+             *
+             * @param points the input points in the local frame
+             * @param results the output points in the global frame, at least of the size of the input
+             */
+            template <typename input_type, typename output_type>
+            void point_to_global(const input_type &points, output_type &&results) const
+            {
+                dispatch_kind(_kind, [&](auto kind) { transform_batch<true, decltype(kind)::value>(_data, points, results); });
+            }
+
+            /** This method transforms a range of points from the global 3D cartesian frame into the local 3D cartesian frame
+             *
+             * @param points the input points in the global frame
+             * @param results the output points in the local frame, at least of the size of the input
+             */
+            template <typename input_type, typename output_type>
+            void point_to_local(const input_type &points, output_type &&results) const
+            {
+                dispatch_kind(_kind, [&](auto kind) { transform_batch<true, decltype(kind)::value>(inverse(), points, results); });
+            }
+
+            /** This method transforms a range of vectors from the local 3D cartesian frame to the global 3D cartesian frame
+             *
+             * @param vectors the input vectors in the local frame
+             * @param results the output vectors in the global frame, at least of the size of the input
+             */
+            template <typename input_type, typename output_type>
+            void vector_to_global(const input_type &vectors, output_type &&results) const
+            {
+                dispatch_kind(_kind, [&](auto kind) { transform_batch<false, decltype(kind)::value>(_data, vectors, results); });
+            }
+
+            /** This method transforms a range of vectors from the global 3D cartesian frame into the local 3D cartesian frame
+             *
+             * @param vectors the input vectors in the global frame
+             * @param results the output vectors in the local frame, at least of the size of the input
+             */
+            template <typename input_type, typename output_type>
+            void vector_to_local(const input_type &vectors, output_type &&results) const
+            {
+                dispatch_kind(_kind, [&](auto kind) { transform_batch<false, decltype(kind)::value>(inverse(), vectors, results); });
             }
         };
 
+        /** Transform wrapper class with a compact storage layout: the 3x3 rotation and the
+         *  translation, i.e. 12 instead of 32 scalars. The constant last row is not stored
+         *  and the inverse is derived on the fly as R^T (p - t), which requires a rigid body
+         *  transform.
+         **/
+        struct compact_transform3
+        {
+            // The inverse is always derived as the one of a rigid body transform
+            static constexpr bool assumes_isometry = true;
+
+            using matrix34 = std::array<std::array<scalar, 3>, 4>;
+            using matrix44 = transform3::matrix44;
+
+            matrix34 _data;
+
+            /** Contructor with arguments: t, z, x
+             * 
+             * @param t the translation (or origin of the new frame)
+             * @param z the z axis of the new frame, normal vector for planes
+             * @param x the x axis of the new frame
+             * 
+             * @note y will be constructed by cross product
+             * 
+             **/
+            compact_transform3(const vector3 &t, const vector3 &z, const vector3 &x)
+            {
+                _data = {x, vector::cross(z, x), z, t};
+            }
+
+            /** Constructor with arguments: translation
+             *
+             * @param t is the transform
+             **/
+            compact_transform3(const vector3 &t)
+            {
+                _data = {vector3{1., 0., 0.}, vector3{0., 1., 0.}, vector3{0., 0., 1.}, t};
+            }
+
+            /** Constructor with arguments: matrix, the last row is dropped
+             * 
+             * @param m is the full 4x4 matrix 
+             **/
+            compact_transform3(const matrix44 &m)
+            {
+                for (unsigned int c = 0; c < 4; ++c)
+                {
+                    _data[c] = {m[c][0], m[c][1], m[c][2]};
+                }
+            }
+
+            /** Constructor with arguments: matrix as std::aray of scalar
+             * 
+             * @param ma is the full 4x4 matrix 16 array, the last row is dropped
+             **/
+            compact_transform3(const array_s<scalar, 16> &ma)
+            {
+                for (unsigned int c = 0; c < 4; ++c)
+                {
+                    _data[c] = {ma[c], ma[4 + c], ma[8 + c]};
+                }
+            }
+
+            /** Constructor with arguments: full transform */
+            compact_transform3(const transform3 &trf) : compact_transform3(trf.matrix()) {}
+
+            /** Constructor with arguments: identity
+             *
+             **/
+            compact_transform3() : compact_transform3(vector3{0., 0., 0.}) {}
+
+            /** Default contructors */
+            compact_transform3(const compact_transform3 &rhs) = default;
+            ~compact_transform3() = default;
+
+            /** Equality operator */
+            bool operator==(const compact_transform3 &rhs) const
+            {
+                return (_data == rhs._data);
+            }
+
+            /** This method retrieves the rotation of a transform */
+            auto rotation() const
+            {
+                return getter::block<3, 3>(_data, 0, 0);
+            }
+
+            /** This method retrieves the translation of a transform */
+            point3 translation() const
+            {
+                return _data[3];
+            }
+
+            /** This method retrieves the 4x4 matrix of a transform */
+            matrix44 matrix() const
+            {
+                matrix44 m;
+                for (unsigned int c = 0; c < 4; ++c)
+                {
+                    m[c] = {_data[c][0], _data[c][1], _data[c][2], scalar(c == 3 ? 1. : 0.)};
+                }
+                return m;
+            }
+
+            /** This method transform from a point from the local 3D cartesian frame to the global 3D cartesian frame */
+            template <typename point_type>
+            const point_type point_to_global(const point_type &v) const
+            {
+                return point3{_data[0][0] * v[0] + _data[1][0] * v[1] + _data[2][0] * v[2] + _data[3][0],
+                              _data[0][1] * v[0] + _data[1][1] * v[1] + _data[2][1] * v[2] + _data[3][1],
+                              _data[0][2] * v[0] + _data[1][2] * v[1] + _data[2][2] * v[2] + _data[3][2]};
+            }
+
+            /** This method transform from a vector from the global 3D cartesian frame into the local 3D cartesian frame */
+            template <typename point_type>
+            const point_type point_to_local(const point_type &v) const
+            {
+                const scalar d0 = v[0] - _data[3][0], d1 = v[1] - _data[3][1], d2 = v[2] - _data[3][2];
+                return point3{_data[0][0] * d0 + _data[0][1] * d1 + _data[0][2] * d2,
+                              _data[1][0] * d0 + _data[1][1] * d1 + _data[1][2] * d2,
+                              _data[2][0] * d0 + _data[2][1] * d1 + _data[2][2] * d2};
+            }
+
+            /** This method transforms a point from the global 3D cartesian frame into the first two
+             *  coordinates of the local 3D cartesian frame, only the two needed rows are evaluated
+             */
+            template <typename point_type>
+            point2 point_to_local2(const point_type &v) const
+            {
+                const scalar d0 = v[0] - _data[3][0], d1 = v[1] - _data[3][1], d2 = v[2] - _data[3][2];
+                return point2{_data[0][0] * d0 + _data[0][1] * d1 + _data[0][2] * d2,
+                              _data[1][0] * d0 + _data[1][1] * d1 + _data[1][2] * d2};
+            }
+
+            /** This method transform from a vector from the local 3D cartesian frame to the global 3D cartesian frame */
+            template <typename vector_type>
+            const vector_type vector_to_global(const vector_type &v) const
+            {
+                return vector3{_data[0][0] * v[0] + _data[1][0] * v[1] + _data[2][0] * v[2],
+                               _data[0][1] * v[0] + _data[1][1] * v[1] + _data[2][1] * v[2],
+                               _data[0][2] * v[0] + _data[1][2] * v[1] + _data[2][2] * v[2]};
+            }
+
+            /** This method transform from a vector from the global 3D cartesian frame into the local 3D cartesian frame */
+            template <typename vector_type>
+            const auto vector_to_local(const vector_type &v) const
+            {
+                return vector3{_data[0][0] * v[0] + _data[0][1] * v[1] + _data[0][2] * v[2],
+                               _data[1][0] * v[0] + _data[1][1] * v[1] + _data[1][2] * v[2],
+                               _data[2][0] * v[0] + _data[2][1] * v[1] + _data[2][2] * v[2]};
+            }
+
+            /** This method transforms a range of points from the local 3D cartesian frame to the global 3D cartesian frame
+             *
+             * @param points the input points in the local frame
+             * @param results the output points in the global frame, at least of the size of the input
+             */
+            template <typename input_type, typename output_type>
+            void point_to_global(const input_type &points, output_type &&results) const
+            {
+                transform3::transform_batch<true>(matrix(), points, results);
+            }
+
+            /** This method transforms a range of points from the global 3D cartesian frame into the local 3D cartesian frame,
+             *  the inverse is computed once per batch
+             *
+             * @param points the input points in the global frame
+             * @param results the output points in the local frame, at least of the size of the input
+             */
+            template <typename input_type, typename output_type>
+            void point_to_local(const input_type &points, output_type &&results) const
+            {
+                transform3::transform_batch<true>(transform3::invert_isometry(matrix()), points, results);
+            }
+
+            /** This method transforms a range of vectors from the local 3D cartesian frame to the global 3D cartesian frame
+             *
+             * @param vectors the input vectors in the local frame
+             * @param results the output vectors in the global frame, at least of the size of the input
+             */
+            template <typename input_type, typename output_type>
+            void vector_to_global(const input_type &vectors, output_type &&results) const
+            {
+                transform3::transform_batch<false>(matrix(), vectors, results);
+            }
+
+            /** This method transforms a range of vectors from the global 3D cartesian frame into the local 3D cartesian frame,
+             *  the inverse is computed once per batch
+             *
+             * @param vectors the input vectors in the global frame
+             * @param results the output vectors in the local frame, at least of the size of the input
+             */
+            template <typename input_type, typename output_type>
+            void vector_to_local(const input_type &vectors, output_type &&results) const
+            {
+                transform3::transform_batch<false>(transform3::invert_isometry(matrix()), vectors, results);
+            }
+        };
+
+        /** Contiguous container of transforms that is addressed by index
+         *
+         * @tparam layout_t aos_layout or soa_layout
+         **/
+        template <typename layout_t = aos_layout>
+        using transform_store = algebra::transform_store<transform3, vector3, layout_t>;
+
+        /** Read-only view of structure of arrays transforms, e.g. of a transform file */
+        using transform_view = algebra::transform_view<transform3, vector3>;
+
+        /** Memory mapped binary transform file */
+        using transform_file = algebra::transform_file<scalar>;
+
+        /** Quaternion encoding of transform collections for compact geometry files */
+        using transform_codec = algebra::transform_codec<transform3, vector3>;
+
+        /** Hierarchy of transforms with lazily composed global transforms */
+        using transform_tree = algebra::transform_tree<transform3>;
+
+        /** Quaternion rotation and translation, a compact transform for large collections */
+        using quaternion_transform3 = algebra::quaternion_transform3<scalar, vector3>;
+
         /** Frame projection into a cartesian coordinate frame
          */
         struct cartesian2
         {
             /** This method transform from a point from the global 3D cartesian frame to the local 2D cartesian frame 
              * 
+             * @tparam transform_type transform3 or compact_transform3
+             *
              * @param trf the transform from global to local thredimensional frame
              * @param p the point in global frame
              * 
              * @return a local point2
              **/
-            point2 operator()(const transform3 &trf,
+            template <typename transform_type>
+            point2 operator()(const transform_type &trf,
                                   const point3 &p) const
             {
-                return operator()(trf.point_to_local(p));
+                return trf.point_to_local2(p);
             }
 
             /** This method transform from a point from the global 3D cartesian frame to the local 2D cartesian frame
@@ -470,6 +1237,17 @@ namespace algebra
             {
                 return {v[0], v[1]};
             }
+
+            /** This method projects a range of points from the global 3D cartesian frame into the local 2D frame,
+             *  see detail::project_range
+             **/
+            template <typename transform_type, typename input_type, typename output_type>
+            void operator()(const transform_type &trf, const input_type &points, output_type &&results) const
+            {
+                detail::project_range(trf, points, results, [&trf](auto kind, const auto &p) {
+                    return detail::point_to_local2<decltype(kind)::value>(trf, p);
+                });
+            }
         };
 
         /** Local frame projection into a polar coordinate frame */
@@ -477,15 +1255,18 @@ namespace algebra
         {
             /** This method transform from a point from the global 3D cartesian frame to the local 2D cartesian frame 
              * 
+             * @tparam transform_type transform3 or compact_transform3
+             *
              * @param trf the transform from global to local thredimensional frame
              * @param p the point in global frame
              * 
              * @return a local point2
              **/
-            point2 operator()(const transform3 &trf,
+            template <typename transform_type>
+            point2 operator()(const transform_type &trf,
                                   const point3 &p) const
             {
-                return operator()(trf.point_to_local(p));
+                return operator()(trf.point_to_local2(p));
             }
 
             /** This method transform from a point from 2D or 3D cartesian frame to a 2D polar point */
@@ -494,6 +1275,17 @@ namespace algebra
             {
                 return point2{getter::perp(v), getter::phi(v)};
             }
+
+            /** This method projects a range of points from the global 3D cartesian frame into the local 2D frame,
+             *  see detail::project_range
+             **/
+            template <typename transform_type, typename input_type, typename output_type>
+            void operator()(const transform_type &trf, const input_type &points, output_type &&results) const
+            {
+                detail::project_range(trf, points, results, [this, &trf](auto kind, const auto &p) {
+                    return (*this)(detail::point_to_local2<decltype(kind)::value>(trf, p));
+                });
+            }
         };
 
         /** Local frame projection into a polar coordinate frame */
@@ -501,12 +1293,15 @@ namespace algebra
         {
              /** This method transform from a point from the global 3D cartesian frame to the local 2D cartesian frame 
              * 
+             * @tparam transform_type transform3 or compact_transform3
+             *
              * @param trf the transform from global to local thredimensional frame
              * @param p the point in global frame
              * 
              * @return a local point2
              **/
-            point2 operator()(const transform3 &trf,
+            template <typename transform_type>
+            point2 operator()(const transform_type &trf,
                                   const point3 &p) const
             {
                 return operator()(trf.point_to_local(p));
@@ -517,6 +1312,17 @@ namespace algebra
             {
                 return point2{getter::perp(v) * getter::phi(v), v[2]};
             }
+
+            /** This method projects a range of points from the global 3D cartesian frame into the local 2D frame,
+             *  see detail::project_range
+             **/
+            template <typename transform_type, typename input_type, typename output_type>
+            void operator()(const transform_type &trf, const input_type &points, output_type &&results) const
+            {
+                detail::project_range(trf, points, results, [this, &trf](auto kind, const auto &p) {
+                    return (*this)(detail::point_to_local<decltype(kind)::value>(trf, p));
+                });
+            }
         };
 
     } // namespace array
@@ -534,7 +1340,7 @@ namespace algebra
          **/
         scalar dot(const std::array<scalar, 2> &a, const std::array<scalar, 2> &b)
         {
-            return a[0] * b[0] + a[1] * b[1];
+            return static_cast<scalar>(accumulator(a[0]) * b[0] + accumulator(a[1]) * b[1]);
         }
 
         /** Get a normalized version of the input vector
@@ -556,7 +1362,7 @@ namespace algebra
          **/
         scalar dot(const std::array<scalar, 3> &a, const std::array<scalar, 3> &b)
         {
-            return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+            return static_cast<scalar>(accumulator(a[0]) * b[0] + accumulator(a[1]) * b[1] + accumulator(a[2]) * b[2]);
         }
 
         /** Get a normalized version of the input vector
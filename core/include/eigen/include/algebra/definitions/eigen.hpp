@@ -7,21 +7,32 @@
  
 #pragma once
 
+#include "common/math.hpp"
+#include "common/projection.hpp"
+#include "common/quaternion.hpp"
+#include "common/rotation.hpp"
+#include "common/scalar.hpp"
+#include "common/sparsity_pattern.hpp"
+#include "common/spherical.hpp"
+#include "common/symmetric_matrix.hpp"
+#include "common/transform_codec.hpp"
+#include "common/transform_file.hpp"
+#include "common/transform_kind.hpp"
+#include "common/transform_store.hpp"
+#include "common/transform_tree.hpp"
 #include "common/types.hpp"
 
+#include <Eigen/Cholesky>
 #include <Eigen/Core>
+#include <Eigen/LU>
 #include <Eigen/Geometry>
 
 #include <any>
+#include <cassert>
+#include <cstddef>
 #include <tuple>
 #include <cmath>
 
-#ifdef ALGEBRA_PLUGIN_CUSTOM_SCALARTYPE
-using algebra_scalar = ALGEBRA_PLUGIN_CUSTOM_SCALARTYPE;
-#else
-using algebra_scalar = double;
-#endif
-
 // namespace of the algebra object definitions
 #define __plugin algebra::eigen
 // Name of the plugin
@@ -29,7 +40,6 @@ using algebra_scalar = double;
 
 namespace algebra
 {
-    using scalar = algebra_scalar;
 
     // eigen getter methdos
     namespace getter
@@ -37,37 +47,40 @@ namespace algebra
         /** This method retrieves phi from a vector, vector base with rows > 2
          * 
          * @param v the input vector 
+         * @param precision the accuracy of the elementary functions
          **/
-        template <typename derived_type>
-        auto phi(const Eigen::MatrixBase<derived_type> &v) noexcept
+        template <typename derived_type, typename precision_t = math::default_precision>
+        auto phi(const Eigen::MatrixBase<derived_type> &v, precision_t precision = {}) noexcept
         {
             constexpr int rows = Eigen::MatrixBase<derived_type>::RowsAtCompileTime;
             static_assert(rows >= 2, "vector::phi() required rows >= 2.");
-            return std::atan2(v[1], v[0]);
+            return math::atan2<scalar>(v[1], v[0], precision);
         }
 
         /** This method retrieves theta from a vector, vector base with rows >= 3
          * 
          * @param v the input vector 
+         * @param precision the accuracy of the elementary functions
          **/
-        template <typename derived_type>
-        auto theta(const Eigen::MatrixBase<derived_type> &v) noexcept
+        template <typename derived_type, typename precision_t = math::default_precision>
+        auto theta(const Eigen::MatrixBase<derived_type> &v, precision_t precision = {}) noexcept
         {
             constexpr int rows = Eigen::MatrixBase<derived_type>::RowsAtCompileTime;
             static_assert(rows >= 2, "vector::theta() required rows >= 3.");
-            return std::atan2(std::sqrt(v[0] * v[0] + v[1] * v[1]), v[2]);
+            return math::atan2<scalar>(std::sqrt(v[0] * v[0] + v[1] * v[1]), v[2], precision);
         }
 
         /** This method retrieves the pseudo-rapidity from a vector or vector base with rows >= 3
          * 
          * @param v the input vector 
+         * @param precision the accuracy of the elementary functions
          **/
-        template <typename derived_type>
-        auto eta(const Eigen::MatrixBase<derived_type> &v) noexcept
+        template <typename derived_type, typename precision_t = math::default_precision>
+        auto eta(const Eigen::MatrixBase<derived_type> &v, precision_t precision = {}) noexcept
         {
             constexpr int rows = Eigen::MatrixBase<derived_type>::RowsAtCompileTime;
             static_assert(rows >= 2, "vector::eta() required rows >= 3.");
-            return std::atanh(v[2] / v.norm());
+            return math::atanh<scalar>(v[2] / v.norm(), precision);
         }
 
         /** This method retrieves the perpenticular magnitude of a vector with rows >= 2
@@ -120,6 +133,23 @@ namespace algebra
         using vector3 = Eigen::Matrix<scalar, 3, 1>;
         using point3  = vector3;
         using point2  = Eigen::Matrix<scalar, 2, 1>;
+        using quaternion = algebra::quaternion<scalar>;
+
+        /** Fixed size matrix, e.g. for the track parameter covariances
+         *
+         * @tparam kROWS the number of rows
+         * @tparam kCOLS the number of columns
+         **/
+        template <int kROWS, int kCOLS>
+        using matrix = Eigen::Matrix<scalar, kROWS, kCOLS>;
+
+        /** Symmetric matrix with packed storage, e.g. for the track parameter covariances.
+         *  Eigen has no packed storage, the common type is used.
+         *
+         * @tparam kN the matrix size
+         **/
+        template <unsigned int kN>
+        using symmetric_matrix = algebra::symmetric_matrix<scalar, kN>;
 
         /** Transform wrapper class to ensure standard API within differnt plugins */
         struct transform3
@@ -127,8 +157,16 @@ namespace algebra
             Eigen::Transform<scalar, 3, Eigen::Affine> _data =
                 Eigen::Transform<scalar, 3, Eigen::Affine>::Identity();
 
+#ifdef ALGEBRA_PLUGIN_LAZY_INVERSE
+            mutable Eigen::Transform<scalar, 3, Eigen::Affine> _data_inv =
+                Eigen::Transform<scalar, 3, Eigen::Affine>::Identity();
+            mutable bool _has_inverse = true;
+#else
             Eigen::Transform<scalar, 3, Eigen::Affine> _data_inv =
                 Eigen::Transform<scalar, 3, Eigen::Affine>::Identity();
+#endif
+            // Selects the kernel of the point and vector transformations
+            transform_kind _kind = transform_kind::identity;
 
             using matrix44 = Eigen::Transform<scalar, 3, Eigen::Affine>::MatrixType;
 
@@ -149,7 +187,7 @@ namespace algebra
                 matrix.block<3, 1>(0, 2) = z;
                 matrix.block<3, 1>(0, 3) = t;
 
-                _data_inv = _data.inverse();
+                update_inverse();
             }
 
             /** Constructor with arguments: translation
@@ -161,7 +199,25 @@ namespace algebra
                 auto &matrix = _data.matrix();
                 matrix.block<3, 1>(0, 3) = t;
 
-                _data_inv = _data.inverse();
+                update_inverse();
+            }
+
+            /** Constructor with arguments: translation and rotation quaternion, the inverse is
+             *  set up from the transposed rotation and not computed by an inversion
+             *
+             * @param t the translation (or origin of the new frame)
+             * @param q the rotation, a unit quaternion
+             **/
+            transform3(const vector3 &t, const quaternion &q)
+            {
+                const auto r = q.rotation_matrix();
+                const Eigen::Map<const Eigen::Matrix<scalar, 3, 3>> rotation(r.data());
+                _data.linear() = rotation;
+                _data.translation() = t;
+                _data_inv.linear() = rotation.transpose();
+                _data_inv.translation() =
+                    -(rotation.transpose().template cast<accumulator>() * t.template cast<accumulator>()).template cast<scalar>();
+                _kind = classify(_data);
             }
 
             /** Constructor with arguments: matrix 
@@ -172,7 +228,7 @@ namespace algebra
             {
                 _data.matrix() = m;
 
-                _data_inv = _data.inverse();
+                update_inverse();
             }
 
             /** Constructor with arguments: matrix as std::aray of scalar
@@ -184,7 +240,32 @@ namespace algebra
                 _data.matrix() << ma[0], ma[1], ma[2], ma[3], ma[4], ma[5], ma[6], ma[7],
                     ma[8], ma[9], ma[10], ma[11], ma[12], ma[13], ma[14], ma[15];
 
-                _data_inv = _data.inverse();
+                update_inverse();
+            }
+
+            /** Constructor with arguments: matrix and inverse matrix as std::aray of scalar,
+             *  the inverse is taken as it is
+             * 
+             * @param ma is the full 4x4 matrix 16 array
+             * @param ma_inv is the full 4x4 inverse matrix 16 array
+             **/
+            transform3(const array_s<scalar, 16> &ma, const array_s<scalar, 16> &ma_inv)
+            {
+                _data.matrix() = Eigen::Map<const Eigen::Matrix<scalar, 4, 4, Eigen::RowMajor>>(ma.data());
+                _data_inv.matrix() = Eigen::Map<const Eigen::Matrix<scalar, 4, 4, Eigen::RowMajor>>(ma_inv.data());
+                _kind = classify(_data);
+            }
+
+            /** Constructor with arguments: matrix and inverse matrix, the inverse is taken as it is
+             *
+             * @param m is the full 4x4 matrix
+             * @param m_inv is the full 4x4 inverse matrix
+             **/
+            transform3(const matrix44 &m, const matrix44 &m_inv)
+            {
+                _data.matrix() = m;
+                _data_inv.matrix() = m_inv;
+                _kind = classify(_data);
             }
 
             /** Default contructors */
@@ -198,6 +279,110 @@ namespace algebra
                 return (_data.isApprox(rhs._data));
             }
 
+            /** Composition: the result applies rhs first and this transform second
+             *
+             * @param rhs is the transform to be applied first
+             *
+             * @note the product of affine transforms only multiplies the linear parts and
+             *       shifts the translation, the inverse is the product of the two inverses
+             *       in reverse order, with ALGEBRA_PLUGIN_LAZY_INVERSE they are set up by this call
+             **/
+            transform3 operator*(const transform3 &rhs) const
+            {
+                return transform3((_data * rhs._data).matrix(), (rhs.inverse() * inverse()).matrix());
+            }
+
+            /** Composition with the inverse: the result applies rhs first and the inverse
+             *  of this transform second, e.g. the placement of a child relative to its parent
+             *  is parent.compose_inverse(child) for the global placements of both
+             *
+             * @param rhs is the transform to be applied first
+             **/
+            transform3 compose_inverse(const transform3 &rhs) const
+            {
+                return transform3((inverse() * rhs._data).matrix(), (rhs.inverse() * _data).matrix());
+            }
+
+            /** Apply an alignment correction in the local frame, i.e. p -> R (dR p + dt) + t. The
+             *  inverse is composed with the inverse of the correction and not recomputed.
+             *
+             * @param rotation_delta the rotation vector dR of the correction, axis times angle
+             * @param translation_delta the translation dt of the correction
+             **/
+            void apply_delta(const vector3 &rotation_delta, const vector3 &translation_delta)
+            {
+                const auto r = rotation_matrix<scalar>(rotation_delta[0], rotation_delta[1], rotation_delta[2]);
+                *this = *this * transform3(translation_delta, vector3{r[6], r[7], r[8]}, vector3{r[0], r[1], r[2]});
+            }
+
+            /** The inverse of a transform
+             *
+             * @param trf is the transform
+             * @param kind is the kind of the transform, the special kinds are inverted as isometries
+             *
+             * @return the inverse transform
+             *
+             * @note the inversion is done in the accumulator type, the cast is a no-op if it is the scalar type
+             */
+            static Eigen::Transform<scalar, 3, Eigen::Affine> invert_transform(const Eigen::Transform<scalar, 3, Eigen::Affine> &trf,
+                                                                               transform_kind kind = transform_kind::general)
+            {
+                return trf.template cast<accumulator>()
+                    .inverse(kind == transform_kind::general ? Eigen::Affine : Eigen::Isometry)
+                    .template cast<scalar>();
+            }
+
+            /** Set up the kind and the inverse after the matrix has been changed: the inverse is
+             *  computed right away, or on first use if ALGEBRA_PLUGIN_LAZY_INVERSE is defined
+             **/
+            void update_inverse()
+            {
+                _kind = classify(_data);
+#ifdef ALGEBRA_PLUGIN_LAZY_INVERSE
+                _has_inverse = false;
+#else
+                _data_inv = invert_transform(_data, _kind);
+#endif
+            }
+
+            /** The kind of a transform, see classify_transform(). Matrices with a last row
+             *  other than (0, 0, 0, 1) are general.
+             */
+            static transform_kind classify(const Eigen::Transform<scalar, 3, Eigen::Affine> &trf)
+            {
+                const auto &m = trf.matrix();
+                if (m(3, 0) != 0. or m(3, 1) != 0. or m(3, 2) != 0. or m(3, 3) != 1.)
+                {
+                    return transform_kind::general;
+                }
+                return classify_transform<scalar>({m(0, 0), m(1, 0), m(2, 0), m(0, 1), m(1, 1), m(2, 1),
+                                                   m(0, 2), m(1, 2), m(2, 2)},
+                                                  {m(0, 3), m(1, 3), m(2, 3)});
+            }
+
+            /** This method retrieves the kind of a transform */
+            transform_kind kind() const
+            {
+                return _kind;
+            }
+
+            /** This method retrieves the inverse of a transform
+             *
+             * @note With ALGEBRA_PLUGIN_LAZY_INVERSE the first call computes and caches the inverse,
+             *       it is not thread-safe and must not race with other calls on the same transform
+             **/
+            const Eigen::Transform<scalar, 3, Eigen::Affine> &inverse() const
+            {
+#ifdef ALGEBRA_PLUGIN_LAZY_INVERSE
+                if (not _has_inverse)
+                {
+                    _data_inv = invert_transform(_data, _kind);
+                    _has_inverse = true;
+                }
+#endif
+                return _data_inv;
+            }
+
             /** This method retrieves the rotation of a transform  **/
             auto rotation() const
             {
@@ -216,6 +401,388 @@ namespace algebra
                 return _data.matrix();
             }
 
+            /** Transform a point or vector with the kernel of a transform kind, the kernels
+             *  skip the multiplications with the trivial matrix elements
+             *
+             * @tparam kKIND the kind of the transform
+             * @tparam kTRANSLATE whether to apply the translation (points) or not (vectors)
+             *
+             * @param trf is the transformation
+             * @param v is the point/vector
+             */
+            template <transform_kind kKIND, bool kTRANSLATE, typename derived_type>
+            static vector3 transform_kernel(const Eigen::Transform<scalar, 3, Eigen::Affine> &trf,
+                                            const Eigen::MatrixBase<derived_type> &v)
+            {
+                if constexpr (kKIND == transform_kind::identity or
+                              (kKIND == transform_kind::translation and not kTRANSLATE))
+                {
+                    return v;
+                }
+                else if constexpr (kKIND == transform_kind::translation)
+                {
+                    return v + trf.translation();
+                }
+                else if constexpr (kKIND == transform_kind::axis_aligned)
+                {
+                    if constexpr (kTRANSLATE)
+                    {
+                        return trf.linear().diagonal().cwiseProduct(v) + trf.translation();
+                    }
+                    else
+                    {
+                        return trf.linear().diagonal().cwiseProduct(v);
+                    }
+                }
+                else
+                {
+                    if constexpr (kTRANSLATE)
+                    {
+                        return trf * v;
+                    }
+                    else
+                    {
+                        return trf.linear() * v;
+                    }
+                }
+            }
+
+            /** This method transform from a point from the local 3D cartesian frame to the global 3D cartesian frame */
+            template <typename derived_type>
+            point3 point_to_global(const Eigen::MatrixBase<derived_type> &v) const
+            {
+                return dispatch_kind(_kind, [&](auto kind) { return point_to_global<decltype(kind)::value>(v); });
+            }
+
+            /** This method transform from a point from the local 3D cartesian frame to the global 3D cartesian frame,
+             *  with the kernel of a kind that is known at compile time
+             *
+             * @tparam kKIND the kind of the transform, or a more general one
+             */
+            template <transform_kind kKIND, typename derived_type>
+            point3 point_to_global(const Eigen::MatrixBase<derived_type> &v) const
+            {
+                constexpr int rows = Eigen::MatrixBase<derived_type>::RowsAtCompileTime;
+                constexpr int cols = Eigen::MatrixBase<derived_type>::ColsAtCompileTime;
+                static_assert(rows == 3 and cols == 1, "transform::point_to_global(v) requires a (3,1) matrix");
+                assert(_kind <= kKIND);
+                return transform_kernel<kKIND, true>(_data, v);
+            }
+
+            /** This method transform from a vector from the global 3D cartesian frame into the local 3D cartesian frame */
+            template <typename derived_type>
+            point3 point_to_local(const Eigen::MatrixBase<derived_type> &v) const
+            {
+                return dispatch_kind(_kind, [&](auto kind) { return point_to_local<decltype(kind)::value>(v); });
+            }
+
+            /** This method transform from a point from the global 3D cartesian frame into the local 3D cartesian frame,
+             *  with the kernel of a kind that is known at compile time. The inverse has the same kind.
+             *
+             * @tparam kKIND the kind of the transform, or a more general one
+             */
+            template <transform_kind kKIND, typename derived_type>
+            point3 point_to_local(const Eigen::MatrixBase<derived_type> &v) const
+            {
+                constexpr int rows = Eigen::MatrixBase<derived_type>::RowsAtCompileTime;
+                constexpr int cols = Eigen::MatrixBase<derived_type>::ColsAtCompileTime;
+                static_assert(rows == 3 and cols == 1, "transform::point_to_local(v) requires a (3,1) matrix");
+                assert(_kind <= kKIND);
+                if constexpr (kKIND == transform_kind::identity)
+                {
+                    return v;
+                }
+                else
+                {
+                    return transform_kernel<kKIND, true>(inverse(), v);
+                }
+            }
+
+            /** This method transforms a point from the global 3D cartesian frame into the first two
+             *  coordinates of the local 3D cartesian frame, only the two needed rows are evaluated
+             */
+            template <typename derived_type>
+            point2 point_to_local2(const Eigen::MatrixBase<derived_type> &v) const
+            {
+                return dispatch_kind(_kind, [&](auto kind) { return point_to_local2<decltype(kind)::value>(v); });
+            }
+
+            /** This method transforms a point from the global 3D cartesian frame into the first two
+             *  coordinates of the local 3D cartesian frame, with the kernel of a kind that is known
+             *  at compile time
+             *
+             * @tparam kKIND the kind of the transform, or a more general one
+             */
+            template <transform_kind kKIND, typename derived_type>
+            point2 point_to_local2(const Eigen::MatrixBase<derived_type> &v) const
+            {
+                constexpr int rows = Eigen::MatrixBase<derived_type>::RowsAtCompileTime;
+                constexpr int cols = Eigen::MatrixBase<derived_type>::ColsAtCompileTime;
+                static_assert(rows == 3 and cols == 1, "transform::point_to_local2(v) requires a (3,1) matrix");
+                assert(_kind <= kKIND);
+                if constexpr (kKIND == transform_kind::identity)
+                {
+                    return v.template head<2>();
+                }
+                else
+                {
+                    const auto &inv = inverse();
+                    if constexpr (kKIND == transform_kind::translation)
+                    {
+                        return point2(v.template head<2>() + inv.translation().template head<2>());
+                    }
+                    else if constexpr (kKIND == transform_kind::axis_aligned)
+                    {
+                        return point2(inv.linear().diagonal().template head<2>().cwiseProduct(v.template head<2>()) +
+                                      inv.translation().template head<2>());
+                    }
+                    else
+                    {
+                        return point2(inv.linear().template topRows<2>() * v + inv.translation().template head<2>());
+                    }
+                }
+            }
+
+            /** This method transform from a vector from the local 3D cartesian frame to the global 3D cartesian frame */
+            template <typename derived_type>
+            vector3 vector_to_global(const Eigen::MatrixBase<derived_type> &v) const
+            {
+                return dispatch_kind(_kind, [&](auto kind) { return vector_to_global<decltype(kind)::value>(v); });
+            }
+
+            /** This method transform from a vector from the local 3D cartesian frame to the global 3D cartesian frame,
+             *  with the kernel of a kind that is known at compile time
+             *
+             * @tparam kKIND the kind of the transform, or a more general one
+             */
+            template <transform_kind kKIND, typename derived_type>
+            vector3 vector_to_global(const Eigen::MatrixBase<derived_type> &v) const
+            {
+                constexpr int rows = Eigen::MatrixBase<derived_type>::RowsAtCompileTime;
+                constexpr int cols = Eigen::MatrixBase<derived_type>::ColsAtCompileTime;
+                static_assert(rows == 3 and cols == 1, "transform::vector_to_global(v) requires a (3,1) matrix");
+                assert(_kind <= kKIND);
+                return transform_kernel<kKIND, false>(_data, v);
+            }
+
+            /** This method transform from a vector from the global 3D cartesian frame into the local 3D cartesian frame */
+            template <typename derived_type>
+            vector3 vector_to_local(const Eigen::MatrixBase<derived_type> &v) const
+            {
+                return dispatch_kind(_kind, [&](auto kind) { return vector_to_local<decltype(kind)::value>(v); });
+            }
+
+            /** This method transform from a vector from the global 3D cartesian frame into the local 3D cartesian frame,
+             *  with the kernel of a kind that is known at compile time
+             *
+             * @tparam kKIND the kind of the transform, or a more general one
+             */
+            template <transform_kind kKIND, typename derived_type>
+            vector3 vector_to_local(const Eigen::MatrixBase<derived_type> &v) const
+            {
+                constexpr int rows = Eigen::MatrixBase<derived_type>::RowsAtCompileTime;
+                constexpr int cols = Eigen::MatrixBase<derived_type>::ColsAtCompileTime;
+                static_assert(rows == 3 and cols == 1, "transform::vector_to_local(v) requires a (3,1) matrix");
+                assert(_kind <= kKIND);
+                if constexpr (kKIND == transform_kind::identity or kKIND == transform_kind::translation)
+                {
+                    return v;
+                }
+                else
+                {
+                    return transform_kernel<kKIND, false>(inverse(), v);
+                }
+            }
+
+            /** Transform a batch of points or vectors with a given transform. The linear part
+             *  and the translation are copied into fixed size matrices outside of the loop.
+             *
+             * @tparam kTRANSLATE whether to apply the translation (points) or not (vectors)
+             * @tparam kKIND the kind of the transform, the kernels of the special kinds only use
+             *         the diagonal of the linear part
+             *
+             * @param trf is the transformation
+             * @param in the input range of points/vectors
+             * @param out the output range, needs at least the size of the input range
+             */
+            template <bool kTRANSLATE, transform_kind kKIND = transform_kind::general, typename input_type,
+                      typename output_type>
+            static void transform_batch(const Eigen::Transform<scalar, 3, Eigen::Affine> &trf,
+                                        const input_type &in, output_type &out)
+            {
+                assert(out.size() >= in.size());
+
+                const vector3 t = kTRANSLATE ? vector3(trf.translation()) : vector3(vector3::Zero());
+
+                const std::size_t n = in.size();
+                if constexpr (kKIND == transform_kind::general)
+                {
+                    const Eigen::Matrix<scalar, 3, 3> r = trf.linear();
+                    for (std::size_t i = 0; i < n; ++i)
+                    {
+                        out[i] = r * in[i] + t;
+                    }
+                }
+                else if constexpr (kKIND == transform_kind::axis_aligned)
+                {
+                    const vector3 d = trf.linear().diagonal();
+                    for (std::size_t i = 0; i < n; ++i)
+                    {
+                        out[i] = d.cwiseProduct(in[i]) + t;
+                    }
+                }
+                else if constexpr (kKIND == transform_kind::translation and kTRANSLATE)
+                {
+                    for (std::size_t i = 0; i < n; ++i)
+                    {
+                        out[i] = in[i] + t;
+                    }
+                }
+                else
+                {
+                    for (std::size_t i = 0; i < n; ++i)
+                    {
+                        out[i] = in[i];
+                    }
+                }
+            }
+
+            /** This method transforms a range of points from the local 3D cartesian frame to the global 3D cartesian frame
+             *
+             * @param points the input points in the local frame
+             * @param results the output points in the global frame, at least of the size of the input
+             */
+            template <typename input_type, typename output_type>
+            void point_to_global(const input_type &points, output_type &&results) const
+            {
+                dispatch_kind(_kind, [&](auto kind) { transform_batch<true, decltype(kind)::value>(_data, points, results); });
+            }
+
+            /** This method transforms a range of points from the global 3D cartesian frame into the local 3D cartesian frame
+             *
+             * @param points the input points in the global frame
+             * @param results the output points in the local frame, at least of the size of the input
+             */
+            template <typename input_type, typename output_type>
+            void point_to_local(const input_type &points, output_type &&results) const
+            {
+                dispatch_kind(_kind, [&](auto kind) { transform_batch<true, decltype(kind)::value>(inverse(), points, results); });
+            }
+
+            /** This method transforms a range of vectors from the local 3D cartesian frame to the global 3D cartesian frame
+             *
+             * @param vectors the input vectors in the local frame
+             * @param results the output vectors in the global frame, at least of the size of the input
+             */
+            template <typename input_type, typename output_type>
+            void vector_to_global(const input_type &vectors, output_type &&results) const
+            {
+                dispatch_kind(_kind, [&](auto kind) { transform_batch<false, decltype(kind)::value>(_data, vectors, results); });
+            }
+
+            /** This method transforms a range of vectors from the global 3D cartesian frame into the local 3D cartesian frame
+             *
+             * @param vectors the input vectors in the global frame
+             * @param results the output vectors in the local frame, at least of the size of the input
+             */
+            template <typename input_type, typename output_type>
+            void vector_to_local(const input_type &vectors, output_type &&results) const
+            {
+                dispatch_kind(_kind, [&](auto kind) { transform_batch<false, decltype(kind)::value>(inverse(), vectors, results); });
+            }
+        };
+
+        /** Transform wrapper class with a compact storage layout: the 3x4 affine matrix,
+         *  i.e. 12 instead of 32 scalars. The constant last row is not stored and the
+         *  inverse is derived on the fly as R^T (p - t), which requires a rigid body
+         *  transform.
+         **/
+        struct compact_transform3
+        {
+            // The inverse is always derived as the one of a rigid body transform
+            static constexpr bool assumes_isometry = true;
+
+            Eigen::Transform<scalar, 3, Eigen::AffineCompact> _data =
+                Eigen::Transform<scalar, 3, Eigen::AffineCompact>::Identity();
+
+            using matrix44 = transform3::matrix44;
+
+            /** Contructor with arguments: t, z, x
+             * 
+             * @param t the translation (or origin of the new frame)
+             * @param z the z axis of the new frame, normal vector for planes
+             * @param x the x axis of the new frame
+             * 
+             **/
+            compact_transform3(const vector3 &t, const vector3 &z, const vector3 &x)
+            {
+                auto &matrix = _data.matrix();
+                matrix.block<3, 1>(0, 0) = x;
+                matrix.block<3, 1>(0, 1) = z.cross(x);
+                matrix.block<3, 1>(0, 2) = z;
+                matrix.block<3, 1>(0, 3) = t;
+            }
+
+            /** Constructor with arguments: translation
+             *
+             * @param t is the transform
+             **/
+            compact_transform3(const vector3 &t)
+            {
+                _data.translation() = t;
+            }
+
+            /** Constructor with arguments: matrix, the last row is dropped
+             * 
+             * @param m is the full 4x4 matrix 
+             **/
+            compact_transform3(const matrix44 &m)
+            {
+                _data.matrix() = m.block<3, 4>(0, 0);
+            }
+
+            /** Constructor with arguments: matrix as std::aray of scalar
+             * 
+             * @param ma is the full 4x4 matrix asa 16 array, the last row is dropped
+             **/
+            compact_transform3(const array_s<scalar, 16> &ma)
+            {
+                _data.matrix() << ma[0], ma[1], ma[2], ma[3], ma[4], ma[5], ma[6], ma[7],
+                    ma[8], ma[9], ma[10], ma[11];
+            }
+
+            /** Constructor with arguments: full transform */
+            compact_transform3(const transform3 &trf) : compact_transform3(trf.matrix()) {}
+
+            /** Default contructors */
+            compact_transform3() = default;
+            compact_transform3(const compact_transform3 &rhs) = default;
+            ~compact_transform3() = default;
+
+            /** Equality operator */
+            bool operator==(const compact_transform3 &rhs) const
+            {
+                return (_data.isApprox(rhs._data));
+            }
+
+            /** This method retrieves the rotation of a transform  **/
+            auto rotation() const
+            {
+                return _data.matrix().block<3, 3>(0, 0);
+            }
+
+            /** This method retrieves the translation of a transform **/
+            auto translation() const
+            {
+                return _data.matrix().block<3, 1>(0, 3);
+            }
+
+            /** This method retrieves the 4x4 matrix of a transform */
+            matrix44 matrix() const
+            {
+                return Eigen::Transform<scalar, 3, Eigen::Affine>(_data).matrix();
+            }
+
             /** This method transform from a point from the local 3D cartesian frame to the global 3D cartesian frame */
             template <typename derived_type>
             auto point_to_global(const Eigen::MatrixBase<derived_type> &v) const
@@ -233,7 +800,21 @@ namespace algebra
                 constexpr int rows = Eigen::MatrixBase<derived_type>::RowsAtCompileTime;
                 constexpr int cols = Eigen::MatrixBase<derived_type>::ColsAtCompileTime;
                 static_assert(rows == 3 and cols == 1, "transform::point_to_local(v) requires a (3,1) matrix");
-                return (_data_inv * v);
+                return vector_to_local(vector3(v - _data.translation()));
+            }
+
+            /** This method transforms a point from the global 3D cartesian frame into the first two
+             *  coordinates of the local 3D cartesian frame, only the two needed rows are evaluated
+             */
+            template <typename derived_type>
+            point2 point_to_local2(const Eigen::MatrixBase<derived_type> &v) const
+            {
+                constexpr int rows = Eigen::MatrixBase<derived_type>::RowsAtCompileTime;
+                constexpr int cols = Eigen::MatrixBase<derived_type>::ColsAtCompileTime;
+                static_assert(rows == 3 and cols == 1, "transform::point_to_local2(v) requires a (3,1) matrix");
+                const vector3 d = v - _data.translation();
+                const auto &m = _data.matrix();
+                return point2(m.col(0).dot(d), m.col(1).dot(d));
             }
 
             /** This method transform from a vector from the local 3D cartesian frame to the global 3D cartesian frame */
@@ -253,10 +834,80 @@ namespace algebra
                 constexpr int rows = Eigen::MatrixBase<derived_type>::RowsAtCompileTime;
                 constexpr int cols = Eigen::MatrixBase<derived_type>::ColsAtCompileTime;
                 static_assert(rows == 3 and cols == 1, "transform::vector_to_local(v) requires a (3,1) matrix");
-                return (_data_inv.linear() * v);
+                // R^T v as column dot products, the transposed product expression is not unrolled as well
+                const auto &m = _data.matrix();
+                return vector3(m.col(0).dot(v), m.col(1).dot(v), m.col(2).dot(v));
+            }
+
+            /** This method transforms a range of points from the local 3D cartesian frame to the global 3D cartesian frame
+             *
+             * @param points the input points in the local frame
+             * @param results the output points in the global frame, at least of the size of the input
+             */
+            template <typename input_type, typename output_type>
+            void point_to_global(const input_type &points, output_type &&results) const
+            {
+                transform3::transform_batch<true>(Eigen::Transform<scalar, 3, Eigen::Affine>(_data), points, results);
+            }
+
+            /** This method transforms a range of points from the global 3D cartesian frame into the local 3D cartesian frame,
+             *  the inverse is computed once per batch
+             *
+             * @param points the input points in the global frame
+             * @param results the output points in the local frame, at least of the size of the input
+             */
+            template <typename input_type, typename output_type>
+            void point_to_local(const input_type &points, output_type &&results) const
+            {
+                transform3::transform_batch<true>(Eigen::Transform<scalar, 3, Eigen::Affine>(_data).inverse(Eigen::Isometry), points, results);
+            }
+
+            /** This method transforms a range of vectors from the local 3D cartesian frame to the global 3D cartesian frame
+             *
+             * @param vectors the input vectors in the local frame
+             * @param results the output vectors in the global frame, at least of the size of the input
+             */
+            template <typename input_type, typename output_type>
+            void vector_to_global(const input_type &vectors, output_type &&results) const
+            {
+                transform3::transform_batch<false>(Eigen::Transform<scalar, 3, Eigen::Affine>(_data), vectors, results);
+            }
+
+            /** This method transforms a range of vectors from the global 3D cartesian frame into the local 3D cartesian frame,
+             *  the inverse is computed once per batch
+             *
+             * @param vectors the input vectors in the global frame
+             * @param results the output vectors in the local frame, at least of the size of the input
+             */
+            template <typename input_type, typename output_type>
+            void vector_to_local(const input_type &vectors, output_type &&results) const
+            {
+                transform3::transform_batch<false>(Eigen::Transform<scalar, 3, Eigen::Affine>(_data).inverse(Eigen::Isometry), vectors, results);
             }
         };
 
+        /** Contiguous container of transforms that is addressed by index
+         *
+         * @tparam layout_t aos_layout or soa_layout
+         **/
+        template <typename layout_t = aos_layout>
+        using transform_store = algebra::transform_store<transform3, vector3, layout_t>;
+
+        /** Read-only view of structure of arrays transforms, e.g. of a transform file */
+        using transform_view = algebra::transform_view<transform3, vector3>;
+
+        /** Memory mapped binary transform file */
+        using transform_file = algebra::transform_file<scalar>;
+
+        /** Quaternion encoding of transform collections for compact geometry files */
+        using transform_codec = algebra::transform_codec<transform3, vector3>;
+
+        /** Hierarchy of transforms with lazily composed global transforms */
+        using transform_tree = algebra::transform_tree<transform3>;
+
+        /** Quaternion rotation and translation, a compact transform for large collections */
+        using quaternion_transform3 = algebra::quaternion_transform3<scalar, vector3>;
+
         /** Local frame projection into a cartesian coordinate frame
          */
         struct cartesian2
@@ -278,15 +929,29 @@ namespace algebra
 
             /** This method transform from a point from the global 3D cartesian frame to the local 2D cartesian frame 
              * 
+             * @tparam transform_type transform3 or compact_transform3
+             *
              * @param trf the transform from global to local thredimensional frame
              * @param p the point in global frame
              * 
              * @return a local point2
              **/
-            auto operator()(const transform3 &trf,
+            template <typename transform_type>
+            auto operator()(const transform_type &trf,
                             const point3 &p) const
             {
-                return operator()(trf.point_to_local(p));
+                return trf.point_to_local2(p);
+            }
+
+            /** This method projects a range of points from the global 3D cartesian frame into the local 2D frame,
+             *  see detail::project_range
+             **/
+            template <typename transform_type, typename input_type, typename output_type>
+            void operator()(const transform_type &trf, const input_type &points, output_type &&results) const
+            {
+                detail::project_range(trf, points, results, [&trf](auto kind, const auto &p) {
+                    return detail::point_to_local2<decltype(kind)::value>(trf, p);
+                });
             }
         };
 
@@ -310,15 +975,29 @@ namespace algebra
 
             /** This method transform from a point from the global 3D cartesian frame to the local 2D cartesian frame 
              * 
+             * @tparam transform_type transform3 or compact_transform3
+             *
              * @param trf the transform from global to local thredimensional frame
              * @param p the point in global frame
              * 
              * @return a local point2
              **/
-            auto operator()(const transform3 &trf,
+            template <typename transform_type>
+            auto operator()(const transform_type &trf,
                             const point3 &p) const
             {
-                return operator()(trf.point_to_local(p));
+                return operator()(trf.point_to_local2(p));
+            }
+
+            /** This method projects a range of points from the global 3D cartesian frame into the local 2D frame,
+             *  see detail::project_range
+             **/
+            template <typename transform_type, typename input_type, typename output_type>
+            void operator()(const transform_type &trf, const input_type &points, output_type &&results) const
+            {
+                detail::project_range(trf, points, results, [this, &trf](auto kind, const auto &p) {
+                    return (*this)(detail::point_to_local2<decltype(kind)::value>(trf, p));
+                });
             }
         };
 
@@ -343,16 +1022,30 @@ namespace algebra
 
             /** This method transform from a point from the global 3D cartesian frame to the local 2D cartesian frame 
              * 
+             * @tparam transform_type transform3 or compact_transform3
+             *
              * @param trf the transform from global to local thredimensional frame
              * @param p the point in global frame
              * 
              * @return a local point2
              **/
-            auto operator()(const transform3 &trf,
+            template <typename transform_type>
+            auto operator()(const transform_type &trf,
                             const point3 &p) const
             {
                 return operator()(trf.point_to_local(p));
             }
+
+            /** This method projects a range of points from the global 3D cartesian frame into the local 2D frame,
+             *  see detail::project_range
+             **/
+            template <typename transform_type, typename input_type, typename output_type>
+            void operator()(const transform_type &trf, const input_type &points, output_type &&results) const
+            {
+                detail::project_range(trf, points, results, [this, &trf](auto kind, const auto &p) {
+                    return (*this)(detail::point_to_local<decltype(kind)::value>(trf, p));
+                });
+            }
         };
 
     } // namespace eigen
@@ -386,7 +1079,8 @@ namespace algebra
         template <typename derived_type_lhs, typename derived_type_rhs>
         auto dot(const Eigen::MatrixBase<derived_type_lhs> &a, const Eigen::MatrixBase<derived_type_rhs> &b)
         {
-            return a.dot(b);
+            using scalar_type = typename derived_type_lhs::Scalar;
+            return static_cast<scalar_type>(a.template cast<accumulator>().dot(b.template cast<accumulator>()));
         }
 
         /** Cross product between two input vectors
@@ -406,4 +1100,65 @@ namespace algebra
         }
     } // namespace vector
 
+    // eigen matrix operations
+    namespace matrix
+    {
+        /** Inverse of a symmetric positive definite matrix: the fixed size closed form
+         *  inverse of Eigen up to 4x4 and a Cholesky (LL^T) decomposition above
+         *
+         * @param a the matrix
+         **/
+        template <int kN>
+        Eigen::Matrix<scalar, kN, kN> invert(const Eigen::Matrix<scalar, kN, kN> &a)
+        {
+            if constexpr (kN <= 4)
+            {
+                return a.inverse();
+            }
+            else
+            {
+                return a.llt().solve(Eigen::Matrix<scalar, kN, kN>::Identity());
+            }
+        }
+
+        /** Solve A x = b for a symmetric positive definite matrix A with a Cholesky decomposition
+         *
+         * @param a the matrix
+         * @param b the right hand side, one system per column
+         **/
+        template <int kN, int kCOLS>
+        Eigen::Matrix<scalar, kN, kCOLS> solve(const Eigen::Matrix<scalar, kN, kN> &a,
+                                               const Eigen::Matrix<scalar, kN, kCOLS> &b)
+        {
+            return a.llt().solve(b);
+        }
+
+        /** Similarity transform J C J^T of a symmetric matrix, only the lower triangle is computed
+         *
+         * @param j the matrix J
+         * @param c the symmetric matrix C
+         **/
+        template <int kM, unsigned int kN>
+        algebra::symmetric_matrix<scalar, kM> similarity(const Eigen::Matrix<scalar, kM, static_cast<int>(kN)> &j,
+                                                         const algebra::symmetric_matrix<scalar, kN> &c)
+        {
+            return detail::similarity<kM>(j, c);
+        }
+
+        /** Similarity transform J C J^T that skips the zero elements of J
+         *
+         * @tparam pattern_t the sparsity pattern of J, a sparsity_pattern
+         *
+         * @param j the matrix J, the elements outside of the pattern are not read
+         * @param c the symmetric matrix C
+         **/
+        template <typename pattern_t, int kM, unsigned int kN>
+        algebra::symmetric_matrix<scalar, kM> similarity(const Eigen::Matrix<scalar, kM, static_cast<int>(kN)> &j,
+                                                         const algebra::symmetric_matrix<scalar, kN> &c)
+        {
+            static_assert(pattern_t::rows == kM and pattern_t::cols == kN, "The pattern does not match the matrix");
+            return detail::sparse_similarity<pattern_t, algebra::symmetric_matrix<scalar, kM>>(j, c);
+        }
+    } // namespace matrix
+
 } // namespace algebra
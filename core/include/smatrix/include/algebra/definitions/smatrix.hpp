@@ -7,20 +7,30 @@
 
 #pragma once
 
+#include "common/math.hpp"
+#include "common/projection.hpp"
+#include "common/quaternion.hpp"
+#include "common/rotation.hpp"
+#include "common/scalar.hpp"
+#include "common/sparsity_pattern.hpp"
+#include "common/spherical.hpp"
+#include "common/transform_codec.hpp"
+#include "common/transform_file.hpp"
+#include "common/transform_kind.hpp"
+#include "common/transform_store.hpp"
+#include "common/transform_tree.hpp"
 #include "common/types.hpp"
 
+#include "Math/CholeskyDecomp.h"
 #include "Math/SMatrix.h"
 #include "Math/SVector.h"
 
 #include <any>
+#include <cassert>
+#include <cstddef>
 #include <tuple>
 #include <cmath>
-
-#ifdef ALGEBRA_PLUGIN_CUSTOM_SCALARTYPE
-using algebra_scalar = ALGEBRA_PLUGIN_CUSTOM_SCALARTYPE;
-#else
-using algebra_scalar = double;
-#endif
+#include <type_traits>
 
 // namespace of the algebra object definitions
 #define __plugin algebra::smatrix
@@ -29,7 +39,6 @@ using algebra_scalar = double;
 
 namespace algebra
 {
-    using scalar = algebra_scalar;
 
     using namespace ROOT::Math;
 
@@ -40,25 +49,27 @@ namespace algebra
         /** This method retrieves phi from a vector, vector base with rows > 2
          * 
          * @param v the input vector 
+         * @param precision the accuracy of the elementary functions
          **/
-        template <typename vec_expr_type>
-        auto phi(const vec_expr_type &v) noexcept
+        template <typename vec_expr_type, typename precision_t = math::default_precision>
+        auto phi(const vec_expr_type &v, precision_t precision = {}) noexcept
         {
             //static_assert(kDIM >= 2, "vector::perp() required rows >= 2.");
             scalar element0 = v.apply(0);
             scalar element1 = v.apply(1);
-            return std::atan2(element1, element0);
+            return math::atan2(element1, element0, precision);
         }
 
         /** This method retrieves theta from a vector, vector base with rows >= 3
          * 
          * @param v the input vector 
+         * @param precision the accuracy of the elementary functions
          **/
-        template <unsigned int kDIM>
-        auto theta(const SVector<scalar, kDIM> &v) noexcept
+        template <unsigned int kDIM, typename precision_t = math::default_precision>
+        auto theta(const SVector<scalar, kDIM> &v, precision_t precision = {}) noexcept
         {
             static_assert(kDIM > 2, "vector::theta() required rows >= 3.");
-            return std::atan2(std::sqrt(v[0] * v[0] + v[1] * v[1]), v[2]);
+            return math::atan2<scalar>(std::sqrt(v[0] * v[0] + v[1] * v[1]), v[2], precision);
         }
 
         /** This method retrieves the norm of a vector, no dimension restriction
@@ -74,12 +85,13 @@ namespace algebra
         /** This method retrieves the pseudo-rapidity from a vector or vector base with rows >= 3
          * 
          * @param v the input vector 
+         * @param precision the accuracy of the elementary functions
          **/
-        template <unsigned int kDIM>
-        auto eta(const SVector<scalar, kDIM> &v) noexcept
+        template <unsigned int kDIM, typename precision_t = math::default_precision>
+        auto eta(const SVector<scalar, kDIM> &v, precision_t precision = {}) noexcept
         {
             static_assert(kDIM > 2, "vector::eta() required rows >= 3.");
-            return std::atanh(v[2] / norm(v));
+            return math::atanh<scalar>(v[2] / norm(v), precision);
         }
 
         /** This method retrieves the perpenticular magnitude of a vector with rows >= 2
@@ -124,6 +136,22 @@ namespace algebra
         using point3 = vector3;
         using vector2 = SVector<scalar, 2>;
         using point2 = vector2;
+        using quaternion = algebra::quaternion<scalar>;
+
+        /** Fixed size matrix, e.g. for the track parameter covariances
+         *
+         * @tparam kROWS the number of rows
+         * @tparam kCOLS the number of columns
+         **/
+        template <unsigned int kROWS, unsigned int kCOLS>
+        using matrix = SMatrix<scalar, kROWS, kCOLS>;
+
+        /** Symmetric matrix with packed storage, e.g. for the track parameter covariances
+         *
+         * @tparam kN the matrix size
+         **/
+        template <unsigned int kN>
+        using symmetric_matrix = SMatrix<scalar, kN, kN, ROOT::Math::MatRepSym<scalar, kN>>;
 
         /** Transform wrapper class to ensure standard API within differnt plugins
          * 
@@ -131,7 +159,14 @@ namespace algebra
         struct transform3
         {
             SMatrix<scalar, 4, 4> _data = ROOT::Math::SMatrixIdentity();
+#ifdef ALGEBRA_PLUGIN_LAZY_INVERSE
+            mutable SMatrix<scalar, 4, 4> _data_inv = ROOT::Math::SMatrixIdentity();
+            mutable bool _has_inverse = true;
+#else
             SMatrix<scalar, 4, 4> _data_inv = ROOT::Math::SMatrixIdentity();
+#endif
+            // Selects the kernel of the point and vector transformations
+            transform_kind _kind = transform_kind::identity;
 
             using matrix44 = decltype(_data);
             using matrix33 = SMatrix<scalar, 3, 3>;
@@ -160,10 +195,7 @@ namespace algebra
                 _data(1, 3) = t[1];
                 _data(2, 3) = t[2];
 
-                int ifail = 0;
-                _data_inv = _data.Inverse(ifail);
-                // This should be an exception, "transform3 could not be initialized. Matrix not invertible."
-                assert(ifail == 0);
+                update_inverse();
             }
 
             /** Constructor with arguments: translation
@@ -176,10 +208,30 @@ namespace algebra
                 _data(1, 3) = t[1];
                 _data(2, 3) = t[2];
 
-                int ifail = 0;
-                _data_inv = _data.Inverse(ifail);
-                // This should be an exception, "transform3 could not be initialized. Matrix not invertible."
-                assert(ifail == 0);
+                update_inverse();
+            }
+
+            /** Constructor with arguments: translation and rotation quaternion, the inverse is
+             *  set up from the transposed rotation and not computed by an inversion
+             *
+             * @param t the translation (or origin of the new frame)
+             * @param q the rotation, a unit quaternion
+             **/
+            transform3(const vector3 &t, const quaternion &q)
+            {
+                const auto r = q.rotation_matrix();
+                for (unsigned int c = 0; c < 3; ++c)
+                {
+                    for (unsigned int k = 0; k < 3; ++k)
+                    {
+                        _data(k, c) = r[3 * c + k];
+                        _data_inv(c, k) = r[3 * c + k];
+                    }
+                    _data(c, 3) = t[c];
+                    _data_inv(c, 3) = static_cast<scalar>(-(accumulator(r[3 * c]) * t[0] + accumulator(r[3 * c + 1]) * t[1] +
+                                                            accumulator(r[3 * c + 2]) * t[2]));
+                }
+                _kind = classify(_data);
             }
 
             /** Constructor with arguments: matrix 
@@ -190,10 +242,7 @@ namespace algebra
             {
                 _data = m;
 
-                int ifail = 0;
-                _data_inv = _data.Inverse(ifail);
-                // This should be an exception, "transform3 could not be initialized. Matrix not invertible."
-                assert(ifail == 0);
+                update_inverse();
             }
 
             /** Constructor with arguments: matrix as std::aray of scalar
@@ -220,12 +269,29 @@ namespace algebra
                 _data(2, 3) = ma[11];
                 _data(3, 3) = ma[15];
 
-                int ifail = 0;
-                _data_inv = _data.Inverse(ifail);
-                // This should be an exception, "transform3 could not be initialized. Matrix not invertible."
-                assert(ifail == 0);
+                update_inverse();
+            }
+
+            /** Constructor with arguments: matrix and inverse matrix as std::aray of scalar,
+             *  the inverse is taken as it is
+             * 
+             * @param ma is the full 4x4 matrix 16 array
+             * @param ma_inv is the full 4x4 inverse matrix 16 array
+             **/
+            transform3(const array_s<scalar, 16> &ma, const array_s<scalar, 16> &ma_inv)
+            {
+                _data = matrix44(ma.begin(), 16);
+                _data_inv = matrix44(ma_inv.begin(), 16);
+                _kind = classify(_data);
             }
 
+            /** Constructor with arguments: matrix and inverse matrix, the inverse is taken as it is
+             *
+             * @param m is the full 4x4 matrix
+             * @param m_inv is the full 4x4 inverse matrix
+             **/
+            transform3(const matrix44 &m, const matrix44 &m_inv) : _data(m), _data_inv(m_inv), _kind(classify(m)) {}
+
             /** Default contructors */
             transform3() = default;
             transform3(const transform3 &rhs) = default;
@@ -237,6 +303,164 @@ namespace algebra
                 return _data == rhs._data;
             }
 
+            /** Composition: the result applies rhs first and this transform second
+             *
+             * @param rhs is the transform to be applied first
+             *
+             * @note the inverse is the product of the two inverses in reverse order,
+             *       with ALGEBRA_PLUGIN_LAZY_INVERSE they are set up by this call
+             **/
+            transform3 operator*(const transform3 &rhs) const
+            {
+                return transform3(multiply(_data, rhs._data), multiply(rhs.inverse(), inverse()));
+            }
+
+            /** Composition with the inverse: the result applies rhs first and the inverse
+             *  of this transform second, e.g. the placement of a child relative to its parent
+             *  is parent.compose_inverse(child) for the global placements of both
+             *
+             * @param rhs is the transform to be applied first
+             **/
+            transform3 compose_inverse(const transform3 &rhs) const
+            {
+                return transform3(multiply(inverse(), rhs._data), multiply(rhs.inverse(), _data));
+            }
+
+            /** Apply an alignment correction in the local frame, i.e. p -> R (dR p + dt) + t. The
+             *  inverse is composed with the inverse of the correction and not recomputed.
+             *
+             * @param rotation_delta the rotation vector dR of the correction, axis times angle
+             * @param translation_delta the translation dt of the correction
+             **/
+            void apply_delta(const vector3 &rotation_delta, const vector3 &translation_delta)
+            {
+                const auto r = rotation_matrix<scalar>(rotation_delta[0], rotation_delta[1], rotation_delta[2]);
+                *this = *this * transform3(translation_delta, vector3{r[6], r[7], r[8]}, vector3{r[0], r[1], r[2]});
+            }
+
+            /** The product of two affine 4x4 matrices: the rotations are multiplied and the
+             *  translation of b is rotated by a and shifted by its translation
+             *
+             * @param a is the left matrix
+             * @param b is the right matrix
+             *
+             * @return the product, with the last row (0, 0, 0, 1)
+             */
+            static matrix44 multiply(const matrix44 &a, const matrix44 &b)
+            {
+                const matrix33 ra = a.template Sub<matrix33>(0, 0);
+                const SVector<scalar, 3> t = ra * b.template SubCol<SVector<scalar, 3>>(3, 0) +
+                                             a.template SubCol<SVector<scalar, 3>>(3, 0);
+
+                matrix44 m = ROOT::Math::SMatrixIdentity();
+                m.Place_at(matrix33(ra * b.template Sub<matrix33>(0, 0)), 0, 0);
+                m.Place_in_col(t, 0, 3);
+                return m;
+            }
+
+            /** The inverse of a 4x4 matrix
+             *
+             * @param m is the matrix
+             * @param kind is the kind of the matrix, the special kinds are inverted in closed form
+             *
+             * @return an inverse matrix
+             *
+             * @note the inversion is done in the accumulator type
+             */
+            static matrix44 invert_transform(const matrix44 &m, transform_kind kind = transform_kind::general)
+            {
+                if (kind != transform_kind::general)
+                {
+                    // The diagonal rotation is its own inverse
+                    matrix44 i = m;
+                    for (unsigned int r = 0; r < 3; ++r)
+                    {
+                        i(r, 3) = -m(r, r) * m(r, 3);
+                    }
+                    return i;
+                }
+                int ifail = 0;
+                if constexpr (std::is_same_v<accumulator, scalar>)
+                {
+                    matrix44 i = m.Inverse(ifail);
+                    // This should be an exception, "transform3 could not be initialized. Matrix not invertible."
+                    assert(ifail == 0);
+                    return i;
+                }
+                else
+                {
+                    SMatrix<accumulator, 4, 4> ma;
+                    for (unsigned int r = 0; r < 4; ++r)
+                    {
+                        for (unsigned int c = 0; c < 4; ++c)
+                        {
+                            ma(r, c) = m(r, c);
+                        }
+                    }
+                    const SMatrix<accumulator, 4, 4> ia = ma.Inverse(ifail);
+                    assert(ifail == 0);
+                    matrix44 i;
+                    for (unsigned int r = 0; r < 4; ++r)
+                    {
+                        for (unsigned int c = 0; c < 4; ++c)
+                        {
+                            i(r, c) = static_cast<scalar>(ia(r, c));
+                        }
+                    }
+                    return i;
+                }
+            }
+
+            /** Set up the kind and the inverse after the matrix has been changed: the inverse is
+             *  computed right away, or on first use if ALGEBRA_PLUGIN_LAZY_INVERSE is defined
+             **/
+            void update_inverse()
+            {
+                _kind = classify(_data);
+#ifdef ALGEBRA_PLUGIN_LAZY_INVERSE
+                _has_inverse = false;
+#else
+                _data_inv = invert_transform(_data, _kind);
+#endif
+            }
+
+            /** The kind of a 4x4 matrix, see classify_transform(). Matrices with a last row
+             *  other than (0, 0, 0, 1) are general.
+             */
+            static transform_kind classify(const matrix44 &m)
+            {
+                if (m(3, 0) != 0. or m(3, 1) != 0. or m(3, 2) != 0. or m(3, 3) != 1.)
+                {
+                    return transform_kind::general;
+                }
+                return classify_transform<scalar>({m(0, 0), m(1, 0), m(2, 0), m(0, 1), m(1, 1), m(2, 1),
+                                                   m(0, 2), m(1, 2), m(2, 2)},
+                                                  {m(0, 3), m(1, 3), m(2, 3)});
+            }
+
+            /** This method retrieves the kind of a transform */
+            transform_kind kind() const
+            {
+                return _kind;
+            }
+
+            /** This method retrieves the inverse of a transform
+             *
+             * @note With ALGEBRA_PLUGIN_LAZY_INVERSE the first call computes and caches the inverse,
+             *       it is not thread-safe and must not race with other calls on the same transform
+             **/
+            const matrix44 &inverse() const
+            {
+#ifdef ALGEBRA_PLUGIN_LAZY_INVERSE
+                if (not _has_inverse)
+                {
+                    _data_inv = invert_transform(_data, _kind);
+                    _has_inverse = true;
+                }
+#endif
+                return _data_inv;
+            }
+
             /** This method retrieves the rotation of a transform */
             auto rotation() const
             {
@@ -255,41 +479,478 @@ namespace algebra
                 return _data;
             }
 
+            /** Transform a point or vector with the kernel of a transform kind, the kernels
+             *  skip the multiplications with the trivial matrix elements
+             *
+             * @tparam kKIND the kind of the matrix
+             * @tparam kTRANSLATE whether to apply the translation (points) or not (vectors)
+             *
+             * @param m is the transformation matrix
+             * @param v is the point/vector
+             */
+            template <transform_kind kKIND, bool kTRANSLATE>
+            static vector3 transform_kernel(const matrix44 &m, const vector3 &v)
+            {
+                if constexpr (kKIND == transform_kind::identity or
+                              (kKIND == transform_kind::translation and not kTRANSLATE))
+                {
+                    return v;
+                }
+                else if constexpr (kKIND == transform_kind::translation)
+                {
+                    return vector3(v[0] + m(0, 3), v[1] + m(1, 3), v[2] + m(2, 3));
+                }
+                else if constexpr (kKIND == transform_kind::axis_aligned)
+                {
+                    if constexpr (kTRANSLATE)
+                    {
+                        return vector3(m(0, 0) * v[0] + m(0, 3), m(1, 1) * v[1] + m(1, 3), m(2, 2) * v[2] + m(2, 3));
+                    }
+                    else
+                    {
+                        return vector3(m(0, 0) * v[0], m(1, 1) * v[1], m(2, 2) * v[2]);
+                    }
+                }
+                else
+                {
+                    SVector<scalar, 4> vector_4 = SVector<scalar, 4>();
+                    vector_4.Place_at(v, 0);
+                    vector_4[3] = static_cast<scalar>(kTRANSLATE ? 1 : 0);
+                    return SVector<scalar, 4>(m * vector_4).template Sub<SVector<scalar, 3>>(0);
+                }
+            }
+
             /** This method transform from a point from the local 3D cartesian frame to the global 3D cartesian frame */
             const point3 point_to_global(const point3 &v) const
             {
-               SVector<scalar, 4> vector_4 = SVector<scalar, 4>();
-               vector_4.Place_at(v, 0);
-               vector_4[3] = static_cast<scalar>(1);
-               return SVector<scalar, 4> (_data * vector_4).template Sub<SVector<scalar, 3> >(0);
+                return dispatch_kind(_kind, [&](auto kind) { return point_to_global<decltype(kind)::value>(v); });
+            }
+
+            /** This method transform from a point from the local 3D cartesian frame to the global 3D cartesian frame,
+             *  with the kernel of a kind that is known at compile time
+             *
+             * @tparam kKIND the kind of the transform, or a more general one
+             */
+            template <transform_kind kKIND>
+            const point3 point_to_global(const point3 &v) const
+            {
+                assert(_kind <= kKIND);
+                return transform_kernel<kKIND, true>(_data, v);
             }
 
             /** This method transform from a vector from the global 3D cartesian frame into the local 3D cartesian frame */
             const point3 point_to_local(const point3 &v) const
             {
-               SVector<scalar, 4> vector_4 = SVector<scalar, 4>();
-               vector_4.Place_at(v, 0);
-               vector_4[3] = static_cast<scalar>(1);
-               return SVector<scalar, 4> (_data_inv * vector_4).template Sub<SVector<scalar, 3> >(0);
+                return dispatch_kind(_kind, [&](auto kind) { return point_to_local<decltype(kind)::value>(v); });
+            }
+
+            /** This method transform from a point from the global 3D cartesian frame into the local 3D cartesian frame,
+             *  with the kernel of a kind that is known at compile time. The inverse has the same kind.
+             *
+             * @tparam kKIND the kind of the transform, or a more general one
+             */
+            template <transform_kind kKIND>
+            const point3 point_to_local(const point3 &v) const
+            {
+                assert(_kind <= kKIND);
+                if constexpr (kKIND == transform_kind::identity)
+                {
+                    return v;
+                }
+                else
+                {
+                    return transform_kernel<kKIND, true>(inverse(), v);
+                }
+            }
+
+            /** This method transforms a point from the global 3D cartesian frame into the first two
+             *  coordinates of the local 3D cartesian frame, only the two needed rows are evaluated
+             */
+            const point2 point_to_local2(const point3 &v) const
+            {
+                return dispatch_kind(_kind, [&](auto kind) { return point_to_local2<decltype(kind)::value>(v); });
+            }
+
+            /** This method transforms a point from the global 3D cartesian frame into the first two
+             *  coordinates of the local 3D cartesian frame, with the kernel of a kind that is known
+             *  at compile time
+             *
+             * @tparam kKIND the kind of the transform, or a more general one
+             */
+            template <transform_kind kKIND>
+            const point2 point_to_local2(const point3 &v) const
+            {
+                assert(_kind <= kKIND);
+                if constexpr (kKIND == transform_kind::identity)
+                {
+                    return point2(v[0], v[1]);
+                }
+                else
+                {
+                    const matrix44 &inv = inverse();
+                    if constexpr (kKIND == transform_kind::translation)
+                    {
+                        return point2(v[0] + inv(0, 3), v[1] + inv(1, 3));
+                    }
+                    else if constexpr (kKIND == transform_kind::axis_aligned)
+                    {
+                        return point2(inv(0, 0) * v[0] + inv(0, 3), inv(1, 1) * v[1] + inv(1, 3));
+                    }
+                    else
+                    {
+                        return point2(inv(0, 0) * v[0] + inv(0, 1) * v[1] + inv(0, 2) * v[2] + inv(0, 3),
+                                      inv(1, 0) * v[0] + inv(1, 1) * v[1] + inv(1, 2) * v[2] + inv(1, 3));
+                    }
+                }
             }
 
             /** This method transform from a vector from the local 3D cartesian frame to the global 3D cartesian frame */
             const point3 vector_to_global(const vector3 &v) const
             {
-               SVector<scalar, 4> vector_4 = SVector<scalar, 4>();
-               vector_4.Place_at(v, 0);
-               return SVector<scalar, 4> (_data * vector_4).template Sub<SVector<scalar, 3> >(0);
+                return dispatch_kind(_kind, [&](auto kind) { return vector_to_global<decltype(kind)::value>(v); });
+            }
+
+            /** This method transform from a vector from the local 3D cartesian frame to the global 3D cartesian frame,
+             *  with the kernel of a kind that is known at compile time
+             *
+             * @tparam kKIND the kind of the transform, or a more general one
+             */
+            template <transform_kind kKIND>
+            const point3 vector_to_global(const vector3 &v) const
+            {
+                assert(_kind <= kKIND);
+                return transform_kernel<kKIND, false>(_data, v);
             }
 
             /** This method transform from a vector from the global 3D cartesian frame into the local 3D cartesian frame */
             const point3 vector_to_local(const vector3 &v) const
             {
-               SVector<scalar, 4> vector_4 = SVector<scalar, 4>();
-               vector_4.Place_at(v, 0);
-               return SVector<scalar, 4> (_data_inv * vector_4).template Sub<SVector<scalar, 3> >(0);
+                return dispatch_kind(_kind, [&](auto kind) { return vector_to_local<decltype(kind)::value>(v); });
+            }
+
+            /** This method transform from a vector from the global 3D cartesian frame into the local 3D cartesian frame,
+             *  with the kernel of a kind that is known at compile time
+             *
+             * @tparam kKIND the kind of the transform, or a more general one
+             */
+            template <transform_kind kKIND>
+            const point3 vector_to_local(const vector3 &v) const
+            {
+                assert(_kind <= kKIND);
+                if constexpr (kKIND == transform_kind::identity or kKIND == transform_kind::translation)
+                {
+                    return v;
+                }
+                else
+                {
+                    return transform_kernel<kKIND, false>(inverse(), v);
+                }
+            }
+
+            /** Transform a batch of points or vectors with a given matrix. The rotation and
+             *  translation are extracted once, outside of the loop.
+             *
+             * @tparam kTRANSLATE whether to apply the translation (points) or not (vectors)
+             * @tparam kKIND the kind of the matrix, the kernels of the special kinds only use
+             *         the diagonal of the rotation
+             *
+             * @param m is the transformation matrix
+             * @param in the input range of points/vectors
+             * @param out the output range, needs at least the size of the input range
+             */
+            template <bool kTRANSLATE, transform_kind kKIND = transform_kind::general, typename input_type,
+                      typename output_type>
+            static void transform_batch(const matrix44 &m, const input_type &in, output_type &out)
+            {
+                assert(out.size() >= in.size());
+
+                const vector3 t = kTRANSLATE ? m.SubCol<vector3>(3, 0) : vector3();
+
+                const std::size_t n = in.size();
+                if constexpr (kKIND == transform_kind::general)
+                {
+                    const matrix33 r = m.Sub<matrix33>(0, 0);
+                    for (std::size_t i = 0; i < n; ++i)
+                    {
+                        out[i] = r * in[i] + t;
+                    }
+                }
+                else if constexpr (kKIND == transform_kind::axis_aligned)
+                {
+                    const vector3 d(m(0, 0), m(1, 1), m(2, 2));
+                    for (std::size_t i = 0; i < n; ++i)
+                    {
+                        out[i] = d * in[i] + t;
+                    }
+                }
+                else if constexpr (kKIND == transform_kind::translation and kTRANSLATE)
+                {
+                    for (std::size_t i = 0; i < n; ++i)
+                    {
+                        out[i] = in[i] + t;
+                    }
+                }
+                else
+                {
+                    for (std::size_t i = 0; i < n; ++i)
+                    {
+                        out[i] = in[i];
+                    }
+                }
+            }
+
+            /** This method transforms a range of points from the local 3D cartesian frame to the global 3D cartesian frame
+             *
+             * @param points the input points in the local frame
+             * @param results the output points in the global frame, at least of the size of the input
+             */
+            template <typename input_type, typename output_type>
+            void point_to_global(const input_type &points, output_type &&results) const
+            {
+                dispatch_kind(_kind, [&](auto kind) { transform_batch<true, decltype(kind)::value>(_data, points, results); });
+            }
+
+            /** This method transforms a range of points from the global 3D cartesian frame into the local 3D cartesian frame
+             *
+             * @param points the input points in the global frame
+             * @param results the output points in the local frame, at least of the size of the input
+             */
+            template <typename input_type, typename output_type>
+            void point_to_local(const input_type &points, output_type &&results) const
+            {
+                dispatch_kind(_kind, [&](auto kind) { transform_batch<true, decltype(kind)::value>(inverse(), points, results); });
+            }
+
+            /** This method transforms a range of vectors from the local 3D cartesian frame to the global 3D cartesian frame
+             *
+             * @param vectors the input vectors in the local frame
+             * @param results the output vectors in the global frame, at least of the size of the input
+             */
+            template <typename input_type, typename output_type>
+            void vector_to_global(const input_type &vectors, output_type &&results) const
+            {
+                dispatch_kind(_kind, [&](auto kind) { transform_batch<false, decltype(kind)::value>(_data, vectors, results); });
+            }
+
+            /** This method transforms a range of vectors from the global 3D cartesian frame into the local 3D cartesian frame
+             *
+             * @param vectors the input vectors in the global frame
+             * @param results the output vectors in the local frame, at least of the size of the input
+             */
+            template <typename input_type, typename output_type>
+            void vector_to_local(const input_type &vectors, output_type &&results) const
+            {
+                dispatch_kind(_kind, [&](auto kind) { transform_batch<false, decltype(kind)::value>(inverse(), vectors, results); });
             }
         };
 
+        /** Transform wrapper class with a compact storage layout: the 3x4 affine matrix,
+         *  i.e. 12 instead of 32 scalars. The constant last row is not stored and the
+         *  inverse is derived on the fly as R^T (p - t), which requires a rigid body
+         *  transform.
+         **/
+        struct compact_transform3
+        {
+            // The inverse is always derived as the one of a rigid body transform
+            static constexpr bool assumes_isometry = true;
+
+            SMatrix<scalar, 3, 4> _data = ROOT::Math::SMatrixIdentity();
+
+            using matrix34 = decltype(_data);
+            using matrix44 = transform3::matrix44;
+            using matrix33 = transform3::matrix33;
+
+            /** Contructor with arguments: t, z, x
+             * 
+             * @param t the translation (or origin of the new frame)
+             * @param z the z axis of the new frame, normal vector for planes
+             * @param x the x axis of the new frame
+             * 
+             **/
+            compact_transform3(const vector3 &t, const vector3 &z, const vector3 &x)
+            {
+                _data.Place_in_col(x, 0, 0);
+                _data.Place_in_col(Cross(z, x), 0, 1);
+                _data.Place_in_col(z, 0, 2);
+                _data.Place_in_col(t, 0, 3);
+            }
+
+            /** Constructor with arguments: translation
+             *
+             * @param t is the translation
+             **/
+            compact_transform3(const vector3 &t)
+            {
+                _data.Place_in_col(t, 0, 3);
+            }
+
+            /** Constructor with arguments: matrix, the last row is dropped
+             * 
+             * @param m is the full 4x4 matrix 
+             **/
+            compact_transform3(const matrix44 &m)
+            {
+                _data = m.Sub<matrix34>(0, 0);
+            }
+
+            /** Constructor with arguments: matrix as std::aray of scalar
+             * 
+             * @param ma is the full 4x4 matrix asa 16 array, the last row is dropped
+             **/
+            compact_transform3(const array_s<scalar, 16> &ma)
+            {
+                _data = matrix34(ma.begin(), 12);
+            }
+
+            /** Constructor with arguments: full transform */
+            compact_transform3(const transform3 &trf) : compact_transform3(trf.matrix()) {}
+
+            /** Default contructors */
+            compact_transform3() = default;
+            compact_transform3(const compact_transform3 &rhs) = default;
+            ~compact_transform3() = default;
+
+            /** Equality operator */
+            bool operator==(const compact_transform3 &rhs) const
+            {
+                return _data == rhs._data;
+            }
+
+            /** This method retrieves the rotation of a transform */
+            auto rotation() const
+            {
+                return (_data.Sub<matrix33>(0, 0));
+            }
+
+            /** This method retrieves the translation of a transform */
+            auto translation() const
+            {
+                return (_data.SubCol<SVector<scalar, 3>>(3, 0));
+            }
+
+            /** This method retrieves the 4x4 matrix of a transform */
+            matrix44 matrix() const
+            {
+                matrix44 m = ROOT::Math::SMatrixIdentity();
+                m.Place_at(_data, 0, 0);
+                return m;
+            }
+
+            /** This method retrieves the 4x4 matrix of the inverse transform */
+            matrix44 matrix_inverse() const
+            {
+                const matrix33 rt = Transpose(rotation());
+                const vector3 t = -(rt * translation());
+
+                matrix44 m = ROOT::Math::SMatrixIdentity();
+                m.Place_at(rt, 0, 0);
+                m.Place_in_col(t, 0, 3);
+                return m;
+            }
+
+            /** This method transform from a point from the local 3D cartesian frame to the global 3D cartesian frame */
+            const point3 point_to_global(const point3 &v) const
+            {
+               return _data * SVector<scalar, 4>(v[0], v[1], v[2], static_cast<scalar>(1));
+            }
+
+            /** This method transform from a vector from the global 3D cartesian frame into the local 3D cartesian frame */
+            const point3 point_to_local(const point3 &v) const
+            {
+               return TransposeTimes(rotation(), v - translation());
+            }
+
+            /** This method transforms a point from the global 3D cartesian frame into the first two
+             *  coordinates of the local 3D cartesian frame, only the two needed rows are evaluated
+             */
+            const point2 point_to_local2(const point3 &v) const
+            {
+               const scalar d0 = v[0] - _data(0, 3), d1 = v[1] - _data(1, 3), d2 = v[2] - _data(2, 3);
+               return point2(_data(0, 0) * d0 + _data(1, 0) * d1 + _data(2, 0) * d2,
+                             _data(0, 1) * d0 + _data(1, 1) * d1 + _data(2, 1) * d2);
+            }
+
+            /** This method transform from a vector from the local 3D cartesian frame to the global 3D cartesian frame */
+            const point3 vector_to_global(const vector3 &v) const
+            {
+               return rotation() * v;
+            }
+
+            /** This method transform from a vector from the global 3D cartesian frame into the local 3D cartesian frame */
+            const point3 vector_to_local(const vector3 &v) const
+            {
+               return TransposeTimes(rotation(), v);
+            }
+
+            /** This method transforms a range of points from the local 3D cartesian frame to the global 3D cartesian frame
+             *
+             * @param points the input points in the local frame
+             * @param results the output points in the global frame, at least of the size of the input
+             */
+            template <typename input_type, typename output_type>
+            void point_to_global(const input_type &points, output_type &&results) const
+            {
+                transform3::transform_batch<true>(matrix(), points, results);
+            }
+
+            /** This method transforms a range of points from the global 3D cartesian frame into the local 3D cartesian frame,
+             *  the inverse is computed once per batch
+             *
+             * @param points the input points in the global frame
+             * @param results the output points in the local frame, at least of the size of the input
+             */
+            template <typename input_type, typename output_type>
+            void point_to_local(const input_type &points, output_type &&results) const
+            {
+                transform3::transform_batch<true>(matrix_inverse(), points, results);
+            }
+
+            /** This method transforms a range of vectors from the local 3D cartesian frame to the global 3D cartesian frame
+             *
+             * @param vectors the input vectors in the local frame
+             * @param results the output vectors in the global frame, at least of the size of the input
+             */
+            template <typename input_type, typename output_type>
+            void vector_to_global(const input_type &vectors, output_type &&results) const
+            {
+                transform3::transform_batch<false>(matrix(), vectors, results);
+            }
+
+            /** This method transforms a range of vectors from the global 3D cartesian frame into the local 3D cartesian frame,
+             *  the inverse is computed once per batch
+             *
+             * @param vectors the input vectors in the global frame
+             * @param results the output vectors in the local frame, at least of the size of the input
+             */
+            template <typename input_type, typename output_type>
+            void vector_to_local(const input_type &vectors, output_type &&results) const
+            {
+                transform3::transform_batch<false>(matrix_inverse(), vectors, results);
+            }
+        };
+
+        /** Contiguous container of transforms that is addressed by index
+         *
+         * @tparam layout_t aos_layout or soa_layout
+         **/
+        template <typename layout_t = aos_layout>
+        using transform_store = algebra::transform_store<transform3, vector3, layout_t>;
+
+        /** Read-only view of structure of arrays transforms, e.g. of a transform file */
+        using transform_view = algebra::transform_view<transform3, vector3>;
+
+        /** Memory mapped binary transform file */
+        using transform_file = algebra::transform_file<scalar>;
+
+        /** Quaternion encoding of transform collections for compact geometry files */
+        using transform_codec = algebra::transform_codec<transform3, vector3>;
+
+        /** Hierarchy of transforms with lazily composed global transforms */
+        using transform_tree = algebra::transform_tree<transform3>;
+
+        /** Quaternion rotation and translation, a compact transform for large collections */
+        using quaternion_transform3 = algebra::quaternion_transform3<scalar, vector3>;
+
         /** Local frame projection into a cartesian coordinate frame */
         struct cartesian2
         {
@@ -309,15 +970,29 @@ namespace algebra
 
             /** This method transform from a point from the global 3D cartesian frame to the local 2D cartesian frame 
              * 
+             * @tparam transform_type transform3 or compact_transform3
+             *
              * @param trf the transform from global to local thredimensional frame
              * @param p the point in global frame
              * 
              * @return a local point2
              **/
-            const auto operator()(const transform3 &trf,
+            template <typename transform_type>
+            const auto operator()(const transform_type &trf,
                                   const point3 &p) const
             {
-                return operator()(trf.point_to_local(p));
+                return trf.point_to_local2(p);
+            }
+
+            /** This method projects a range of points from the global 3D cartesian frame into the local 2D frame,
+             *  see detail::project_range
+             **/
+            template <typename transform_type, typename input_type, typename output_type>
+            void operator()(const transform_type &trf, const input_type &points, output_type &&results) const
+            {
+                detail::project_range(trf, points, results, [&trf](auto kind, const auto &p) {
+                    return detail::point_to_local2<decltype(kind)::value>(trf, p);
+                });
             }
         };
 
@@ -341,15 +1016,29 @@ namespace algebra
 
             /** This method transform from a point from the global 3D cartesian frame to the local 2D cartesian frame 
              * 
+             * @tparam transform_type transform3 or compact_transform3
+             *
              * @param trf the transform from global to local thredimensional frame
              * @param p the point in global frame
              * 
              * @return a local point2
              **/
-            const auto operator()(const transform3 &trf,
+            template <typename transform_type>
+            const auto operator()(const transform_type &trf,
                                   const point3 &p) const
             {
-                return operator()(trf.point_to_local(p));
+                return operator()(trf.point_to_local2(p));
+            }
+
+            /** This method projects a range of points from the global 3D cartesian frame into the local 2D frame,
+             *  see detail::project_range
+             **/
+            template <typename transform_type, typename input_type, typename output_type>
+            void operator()(const transform_type &trf, const input_type &points, output_type &&results) const
+            {
+                detail::project_range(trf, points, results, [this, &trf](auto kind, const auto &p) {
+                    return (*this)(detail::point_to_local2<decltype(kind)::value>(trf, p));
+                });
             }
         };
 
@@ -373,16 +1062,30 @@ namespace algebra
 
             /** This method transform from a point from the global 3D cartesian frame to the local 2D cartesian frame 
              * 
+             * @tparam transform_type transform3 or compact_transform3
+             *
              * @param trf the transform from global to local thredimensional frame
              * @param p the point in global frame
              * 
              * @return a local point2
              **/
-            const auto operator()(const transform3 &trf,
+            template <typename transform_type>
+            const auto operator()(const transform_type &trf,
                                   const point3 &p) const
             {
                 return operator()(trf.point_to_local(p));
             }
+
+            /** This method projects a range of points from the global 3D cartesian frame into the local 2D frame,
+             *  see detail::project_range
+             **/
+            template <typename transform_type, typename input_type, typename output_type>
+            void operator()(const transform_type &trf, const input_type &points, output_type &&results) const
+            {
+                detail::project_range(trf, points, results, [this, &trf](auto kind, const auto &p) {
+                    return (*this)(detail::point_to_local<decltype(kind)::value>(trf, p));
+                });
+            }
         };
 
     } // namespace smatrix
@@ -391,6 +1094,22 @@ namespace algebra
     namespace vector
     {
 
+        namespace detail
+        {
+            /// The number of elements of a vector or a vector expression
+            template <typename value_type, unsigned int kDIM>
+            constexpr unsigned int size(const SVector<value_type, kDIM> &)
+            {
+                return kDIM;
+            }
+
+            template <typename expression_type, typename value_type, unsigned int kDIM>
+            constexpr unsigned int size(const VecExpr<expression_type, value_type, kDIM> &)
+            {
+                return kDIM;
+            }
+        } // namespace detail
+
         /** Get a normalized version of the input vector
          * 
          * @tparam derived_type is the matrix template
@@ -416,7 +1135,20 @@ namespace algebra
         template <typename vector3_type, typename vecexpr3_type>
         auto dot(const vector3_type &a, const vecexpr3_type &b)
         {
-            return ROOT::Math::Dot(a, b);
+            if constexpr (std::is_same_v<accumulator, scalar>)
+            {
+                return ROOT::Math::Dot(a, b);
+            }
+            else
+            {
+                // Element-wise, in the accumulator type
+                accumulator d = 0.;
+                for (unsigned int i = 0; i < detail::size(a); ++i)
+                {
+                    d += accumulator(a.apply(i)) * b.apply(i);
+                }
+                return static_cast<scalar>(d);
+            }
         }
 
         /** Cross product between two input vectors
@@ -437,4 +1169,105 @@ namespace algebra
 
     } // namespace vector
 
+    // smatrix matrix operations
+    namespace matrix
+    {
+        /** Inverse of a symmetric positive definite matrix: the fast (Cramer) inversion of
+         *  SMatrix up to 3x3 and its Cholesky inversion above
+         *
+         * @param a the matrix
+         **/
+        template <unsigned int kN>
+        SMatrix<scalar, kN, kN> invert(const SMatrix<scalar, kN, kN> &a)
+        {
+            int ifail = 0;
+            SMatrix<scalar, kN, kN> inv;
+            if constexpr (kN <= 3)
+            {
+                inv = a.InverseFast(ifail);
+            }
+            else
+            {
+                inv = a.InverseChol(ifail);
+            }
+            // The matrix is singular or not positive definite
+            assert(ifail == 0);
+            return inv;
+        }
+
+        /** Solve A x = b for a symmetric positive definite matrix A with the Cholesky
+         *  decomposition of SMatrix, column by column
+         *
+         * @param a the matrix
+         * @param b the right hand side, one system per column
+         **/
+        template <unsigned int kN, unsigned int kCOLS>
+        SMatrix<scalar, kN, kCOLS> solve(const SMatrix<scalar, kN, kN> &a, const SMatrix<scalar, kN, kCOLS> &b)
+        {
+            const ROOT::Math::CholeskyDecomp<scalar, kN> decomposition(a);
+            // The matrix is not positive definite
+            assert(decomposition.ok());
+            SMatrix<scalar, kN, kCOLS> x;
+            for (unsigned int c = 0; c < kCOLS; ++c)
+            {
+                ROOT::Math::SVector<scalar, kN> column = b.Col(c);
+                decomposition.Solve(column);
+                x.Place_in_col(column, 0, c);
+            }
+            return x;
+        }
+
+        /** Inverse of a symmetric positive definite matrix with packed storage: the fast
+         *  inversion up to 2x2 and the Cholesky inversion above
+         *
+         * @param a the matrix
+         **/
+        template <unsigned int kN>
+        SMatrix<scalar, kN, kN, ROOT::Math::MatRepSym<scalar, kN>> invert(
+            const SMatrix<scalar, kN, kN, ROOT::Math::MatRepSym<scalar, kN>> &a)
+        {
+            int ifail = 0;
+            SMatrix<scalar, kN, kN, ROOT::Math::MatRepSym<scalar, kN>> inv;
+            if constexpr (kN <= 2)
+            {
+                inv = a.InverseFast(ifail);
+            }
+            else
+            {
+                inv = a.InverseChol(ifail);
+            }
+            // The matrix is singular or not positive definite
+            assert(ifail == 0);
+            return inv;
+        }
+
+        /** Similarity transform J C J^T of a symmetric matrix, only the lower triangle is computed
+         *
+         * @param j the matrix J
+         * @param c the symmetric matrix C
+         **/
+        template <unsigned int kM, unsigned int kN>
+        SMatrix<scalar, kM, kM, ROOT::Math::MatRepSym<scalar, kM>> similarity(
+            const SMatrix<scalar, kM, kN> &j, const SMatrix<scalar, kN, kN, ROOT::Math::MatRepSym<scalar, kN>> &c)
+        {
+            return ROOT::Math::Similarity(j, c);
+        }
+
+        /** Similarity transform J C J^T that skips the zero elements of J
+         *
+         * @tparam pattern_t the sparsity pattern of J, a sparsity_pattern
+         *
+         * @param j the matrix J, the elements outside of the pattern are not read
+         * @param c the symmetric matrix C
+         **/
+        template <typename pattern_t, unsigned int kM, unsigned int kN>
+        SMatrix<scalar, kM, kM, ROOT::Math::MatRepSym<scalar, kM>> similarity(
+            const SMatrix<scalar, kM, kN> &j, const SMatrix<scalar, kN, kN, ROOT::Math::MatRepSym<scalar, kN>> &c)
+        {
+            static_assert(pattern_t::rows == kM and pattern_t::cols == kN, "The pattern does not match the matrix");
+            using result_type = SMatrix<scalar, kM, kM, ROOT::Math::MatRepSym<scalar, kM>>;
+            return detail::sparse_similarity<pattern_t, result_type>(j, c);
+        }
+    } // namespace matrix
+
 } // namespace algebra
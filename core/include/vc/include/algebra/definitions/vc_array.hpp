@@ -6,11 +6,31 @@
  */
 #pragma once
 
+#include "common/math.hpp"
+#include "common/projection.hpp"
+#include "common/quaternion.hpp"
+#include "common/rotation.hpp"
+#include "common/scalar.hpp"
+#include "common/small_matrix.hpp"
+#include "common/sparsity_pattern.hpp"
+#include "common/spherical.hpp"
+#include "common/symmetric_matrix.hpp"
+#include "common/transform_codec.hpp"
+#include "common/transform_file.hpp"
+#include "common/transform_kind.hpp"
+#include "common/transform_store.hpp"
+#include "common/transform_tree.hpp"
 #include "common/types.hpp"
 #include "common/simd_array_wrapper.hpp"
+#include "common/simd_soa.hpp"
 
 #include <any>
+#include <array>
+#include <cassert>
 #include <cmath>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
 
 // namespace of the algebra object definitions
 #define __plugin algebra::vc_array
@@ -61,7 +81,20 @@ namespace algebra
         template <typename vector_type>
         scalar dot(const vector_type &a, const vector_type &b)
         {
-            return (a*b).sum();
+            if constexpr (std::is_same_v<accumulator, scalar>)
+            {
+                return (a*b).sum();
+            }
+            else
+            {
+                // Lane by lane, in the accumulator type
+                accumulator d = 0.;
+                for (unsigned int i = 0; i < 4; ++i)
+                {
+                    d += accumulator(a[i]) * b[i];
+                }
+                return static_cast<scalar>(d);
+            }
         }
 
         /** Dot product between two input vectors
@@ -77,7 +110,19 @@ namespace algebra
         template <typename vec_expr1, typename vec_expr2>
         scalar dot(const vec_expr1 &a, const vec_expr2 &b)
         {
-            return (a*b).sum();
+            if constexpr (std::is_same_v<accumulator, scalar>)
+            {
+                return (a*b).sum();
+            }
+            else
+            {
+                accumulator d = 0.;
+                for (unsigned int i = 0; i < 4; ++i)
+                {
+                    d += accumulator(a[i]) * b[i];
+                }
+                return static_cast<scalar>(d);
+            }
         }
 
         /** Dot product between two input vectors - 2 Dim
@@ -89,7 +134,7 @@ namespace algebra
          **/
         scalar dot(const std::array<scalar, 2> &a, const std::array<scalar, 2> &b)
         {
-            return (a[0]*b[0] + a[1]*b[1]);
+            return static_cast<scalar>(accumulator(a[0])*b[0] + accumulator(a[1])*b[1]);
         }
 
         /** Get a normalized version of the input vector
@@ -145,11 +190,12 @@ namespace algebra
          * @tparam vector_type generic input vector type
          * 
          * @param v the input vector 
+         * @param precision the accuracy of the elementary functions
          **/
-        template <typename vector_type>
-        auto phi(const vector_type &v) noexcept
+        template <typename vector_type, typename precision_t = math::default_precision>
+        auto phi(const vector_type &v, precision_t precision = {}) noexcept
         {
-            return std::atan2(v[1], v[0]);
+            return math::atan2(scalar(v[1]), scalar(v[0]), precision);
         }
 
         /** This method retrieves theta from a vector, vector base with rows >= 3
@@ -157,11 +203,12 @@ namespace algebra
          * @tparam vector_type generic input vector type
          * 
          * @param v the input vector 
+         * @param precision the accuracy of the elementary functions
          **/
-        template <typename vector_type>
-        auto theta(const vector_type &v) noexcept
+        template <typename vector_type, typename precision_t = math::default_precision>
+        auto theta(const vector_type &v, precision_t precision = {}) noexcept
         {
-            return std::atan2(std::sqrt(v[0] * v[0] + v[1] * v[1]), v[2]);
+            return math::atan2(scalar(std::sqrt(v[0] * v[0] + v[1] * v[1])), scalar(v[2]), precision);
         }
 
         /** This method retrieves the perpenticular magnitude of a vector with 2 rows
@@ -193,46 +240,60 @@ namespace algebra
          * @tparam vector_type generic input vector type
          * 
          * @param v the input vector 
+         * @param precision the accuracy of the elementary functions
          **/
-        template <typename vector_type>
-        auto eta(const vector_type &v) noexcept
+        template <typename vector_type, typename precision_t = math::default_precision>
+        auto eta(const vector_type &v, precision_t precision = {}) noexcept
         {
-            return std::atanh(v[2] / norm(v));
+            return math::atanh(scalar(v[2] / norm(v)), precision);
         }
 
         /** This method retrieves a column from a matrix
          * 
+         * @tparam kROWS the number of rows to retrieve, the remaining lanes are zero
          * @tparam matrix_type generic input matrix type
          * 
          * @param m the input matrix 
+         * @param row the first row of the column segment
+         * @param col the column index
          **/
         template <unsigned int kROWS = 4, typename matrix_type>
-        simd::array<scalar, 4> vector(const matrix_type m, unsigned int row, unsigned int col) noexcept
+        simd::array<scalar, 4> vector(const matrix_type &m, unsigned int row, unsigned int col) noexcept
         {
-            switch (col) {
-                case 2: return m.z;
-                case 3: return m.t;
-                case 0: return m.x;
-                case 1: return m.y;
+            static_assert(kROWS <= 4, "A matrix column holds at most four rows");
+
+            const auto &column = (col == 0) ? m.x : (col == 1) ? m.y : (col == 2) ? m.z : m.t;
+            // Move the requested rows to the front, the shift fills in zeros
+            simd::array<scalar, 4> v = (row == 0) ? column._array : column._array.shifted(static_cast<int>(row));
+            for (unsigned int irow = kROWS; irow < 4; ++irow)
+            {
+                v[irow] = scalar{0.};
             }
-            return {};
+            return v;
         }
 
-        /** This method retrieves a submatrix
+        /** This method retrieves a submatrix, column-wise and without heap allocations
+         * 
+         * @tparam kROWS the number of rows of the submatrix
+         * @tparam kCOLS the number of columns of the submatrix
+         * @tparam matrix_type generic input matrix type
          * 
          * @param m the input matrix 
+         * @param row the first row of the submatrix
+         * @param col the first column of the submatrix
+         * 
+         * @return the submatrix columns, columns and rows outside the block are zero
          **/
         template <unsigned int kROWS, unsigned int kCOLS, typename matrix_type>
         auto block(const matrix_type &m, unsigned int row, unsigned int col) noexcept
         {
-            simd::array<scalar, 16> submatrix;
-            simd::aligned::vector<decltype(m.x)> vecs = {std::move(m.x), std::move(m.y), std::move(m.z), std::move(m.t)};
-            for (unsigned int irow = row; irow < row + kROWS; ++irow) {
-                for (unsigned int icol = col; icol < col + kCOLS; ++icol) {
-                    submatrix[(icol - col) * (irow - row) + (icol - col)] = vecs[irow - row][icol - col];
-                }
-            }
-            return submatrix;
+            static_assert(kCOLS <= 4, "A matrix holds at most four columns");
+
+            auto column = [&](unsigned int icol) {
+                return (icol < kCOLS) ? simd::array4_wrapper<scalar>(vector<kROWS>(m, row, col + icol))
+                                      : simd::array4_wrapper<scalar>(scalar{0.});
+            };
+            return simd::Vector4<simd::array4_wrapper<scalar>>{column(0), column(1), column(2), column(3)};
         }
 
     } // namespace getter
@@ -246,16 +307,50 @@ namespace algebra
         // Don't use vectorization on potentially half-filled vectors
         using vector2 = std::array<scalar, 2>;
         using point2  = vector2;
+        using quaternion = algebra::quaternion<scalar>;
+
+        /** Fixed size matrix, e.g. for the track parameter covariances
+         *
+         * @tparam kROWS the number of rows
+         * @tparam kCOLS the number of columns
+         **/
+        template <unsigned int kROWS, unsigned int kCOLS>
+        using matrix = algebra::small_matrix<scalar, kROWS, kCOLS>;
+
+        /** Symmetric matrix with packed storage, e.g. for the track parameter covariances
+         *
+         * @tparam kN the matrix size
+         **/
+        template <unsigned int kN>
+        using symmetric_matrix = algebra::symmetric_matrix<scalar, kN>;
 
         /** Transform wrapper class to ensure standard API within differnt plugins
          **/
         struct transform3
         {
+            // Whether the constructor from a matrix takes it to be a rigid body transform
+#ifdef ALGEBRA_PLUGIN_VALIDATE_ISOMETRY
+            static constexpr bool assumes_isometry = false;
+#else
+            static constexpr bool assumes_isometry = true;
+#endif
+
             // Keep 4 simd vector for easy handling
             using matrix44 = simd::Vector4<simd::array4_wrapper<scalar>>;
+            // Matrix in the accumulation precision, for the general inversion
+            using matrix44_acc = simd::Vector4<std::array<accumulator, 4>>;
+            // The rotation columns, padded to four lanes
+            using matrix33 = simd::Vector3<simd::array4_wrapper<scalar>>;
 
             matrix44 _data;
+#ifdef ALGEBRA_PLUGIN_LAZY_INVERSE
+            mutable matrix44 _data_inv;
+            mutable bool _has_inverse = true;
+#else
             matrix44 _data_inv;
+#endif
+            // Selects the kernel of the point and vector transformations
+            transform_kind _kind = transform_kind::general;
 
             /** Contructor with arguments: t, z, x
              * 
@@ -274,7 +369,7 @@ namespace algebra
                 _data.z = {z[0], z[1], z[2], 0.};
                 _data.t = {t[0], t[1], t[2], 1.};
 
-                _data_inv = invert(_data);
+                update_inverse();
             }
 
             /** Constructor with arguments: translation
@@ -288,7 +383,34 @@ namespace algebra
                 _data.z = {0., 0., 1., 0.};
                 _data.t = {t[0], t[1], t[2], 1.};
 
-                _data_inv = invert(_data);
+                update_inverse();
+            }
+
+            /** Constructor with arguments: translation and rotation quaternion, the inverse is
+             *  set up from the transposed rotation and not computed by an inversion
+             *
+             * @param t the translation (or origin of the new frame)
+             * @param q the rotation, a unit quaternion
+             **/
+            transform3(const vector3 &t, const quaternion &q)
+            {
+                const auto r = q.rotation_matrix();
+                _data.x = vector3(r[0], r[1], r[2], 0.);
+                _data.y = vector3(r[3], r[4], r[5], 0.);
+                _data.z = vector3(r[6], r[7], r[8], 0.);
+                _data.t = vector3(t[0], t[1], t[2], 1.);
+
+                _data_inv.x = vector3(r[0], r[3], r[6], 0.);
+                _data_inv.y = vector3(r[1], r[4], r[7], 0.);
+                _data_inv.z = vector3(r[2], r[5], r[8], 0.);
+                scalar t_inv[3];
+                for (unsigned int c = 0; c < 3; ++c)
+                {
+                    t_inv[c] = static_cast<scalar>(-(accumulator(r[3 * c]) * t[0] + accumulator(r[3 * c + 1]) * t[1] +
+                                                     accumulator(r[3 * c + 2]) * t[2]));
+                }
+                _data_inv.t = vector3(t_inv[0], t_inv[1], t_inv[2], 1.);
+                _kind = classify(_data);
             }
 
             /** Constructor with arguments: matrix 
@@ -298,6 +420,8 @@ namespace algebra
             transform3(const matrix44 &m)
             {
                 _data = m;
+
+                update_inverse();
             }
 
             /** Constructor with arguments: matrix as std::aray of scalar
@@ -311,9 +435,36 @@ namespace algebra
                 _data.z = {ma[2], ma[6], ma[10], ma[14]};
                 _data.t = {ma[3], ma[7], ma[11], ma[15]};
 
-                _data_inv = invert(_data);
+                update_inverse();
+            }
+
+            /** Constructor with arguments: matrix and inverse matrix as std::aray of scalar,
+             *  the inverse is taken as it is
+             * 
+             * @param ma is the full 4x4 matrix 16 array
+             * @param ma_inv is the full 4x4 inverse matrix 16 array
+             **/
+            transform3(const array_s<scalar, 16> &ma, const array_s<scalar, 16> &ma_inv)
+            {
+                _data.x = {ma[0], ma[4], ma[8], ma[12]};
+                _data.y = {ma[1], ma[5], ma[9], ma[13]};
+                _data.z = {ma[2], ma[6], ma[10], ma[14]};
+                _data.t = {ma[3], ma[7], ma[11], ma[15]};
+
+                _data_inv.x = {ma_inv[0], ma_inv[4], ma_inv[8], ma_inv[12]};
+                _data_inv.y = {ma_inv[1], ma_inv[5], ma_inv[9], ma_inv[13]};
+                _data_inv.z = {ma_inv[2], ma_inv[6], ma_inv[10], ma_inv[14]};
+                _data_inv.t = {ma_inv[3], ma_inv[7], ma_inv[11], ma_inv[15]};
+                _kind = classify(_data);
             }
 
+            /** Constructor with arguments: matrix and inverse matrix, the inverse is taken as it is
+             *
+             * @param m is the full 4x4 matrix
+             * @param m_inv is the full 4x4 inverse matrix
+             **/
+            transform3(const matrix44 &m, const matrix44 &m_inv) : _data(m), _data_inv(m_inv), _kind(classify(m)) {}
+
             /** Constructor with arguments: identity
              *
              **/
@@ -325,6 +476,7 @@ namespace algebra
                 _data.t = {0., 0., 0., 1.};
 
                 _data_inv = _data;
+                _kind = transform_kind::identity;
             }
 
             /** Default contructors */
@@ -337,13 +489,99 @@ namespace algebra
                 return (_data == rhs._data);
             }
 
+            /** Composition: the result applies rhs first and this transform second
+             *
+             * @param rhs is the transform to be applied first
+             *
+             * @note the inverse is the product of the two inverses in reverse order,
+             *       with ALGEBRA_PLUGIN_LAZY_INVERSE they are set up by this call
+             **/
+            transform3 operator*(const transform3 &rhs) const
+            {
+                return transform3(multiply(_data, rhs._data), multiply(rhs.inverse(), inverse()));
+            }
+
+            /** Composition with the inverse: the result applies rhs first and the inverse
+             *  of this transform second, e.g. the placement of a child relative to its parent
+             *  is parent.compose_inverse(child) for the global placements of both
+             *
+             * @param rhs is the transform to be applied first
+             **/
+            transform3 compose_inverse(const transform3 &rhs) const
+            {
+                return transform3(multiply(inverse(), rhs._data), multiply(rhs.inverse(), _data));
+            }
+
+            /** Apply an alignment correction in the local frame, i.e. p -> R (dR p + dt) + t. The
+             *  inverse is composed with the inverse of the correction and not recomputed.
+             *
+             * @param rotation_delta the rotation vector dR of the correction, axis times angle
+             * @param translation_delta the translation dt of the correction
+             **/
+            void apply_delta(const vector3 &rotation_delta, const vector3 &translation_delta)
+            {
+                const auto r = rotation_matrix<scalar>(rotation_delta[0], rotation_delta[1], rotation_delta[2]);
+                *this = *this * transform3(translation_delta, vector3{r[6], r[7], r[8]}, vector3{r[0], r[1], r[2]});
+            }
+
+            /** Set up the kind and the inverse after the matrix has been changed: the inverse is
+             *  computed right away, or on first use if ALGEBRA_PLUGIN_LAZY_INVERSE is defined
+             **/
+            void update_inverse()
+            {
+                _kind = classify(_data);
+#ifdef ALGEBRA_PLUGIN_LAZY_INVERSE
+                _has_inverse = false;
+#else
+                _data_inv = invert_transform(_data, _kind);
+#endif
+            }
+
+            /** The kind of a 4x4 matrix, see classify_transform(). Matrices with a last row
+             *  other than (0, 0, 0, 1) are general.
+             */
+            static transform_kind classify(const matrix44 &m)
+            {
+                if (m.x[3] != 0. or m.y[3] != 0. or m.z[3] != 0. or m.t[3] != 1.)
+                {
+                    return transform_kind::general;
+                }
+                return classify_transform<scalar>({m.x[0], m.x[1], m.x[2], m.y[0], m.y[1], m.y[2],
+                                                   m.z[0], m.z[1], m.z[2]},
+                                                  {m.t[0], m.t[1], m.t[2]});
+            }
+
+            /** This method retrieves the kind of a transform */
+            transform_kind kind() const
+            {
+                return _kind;
+            }
+
+            /** This method retrieves the inverse of a transform
+             *
+             * @note With ALGEBRA_PLUGIN_LAZY_INVERSE the first call computes and caches the inverse,
+             *       it is not thread-safe and must not race with other calls on the same transform
+             **/
+            const matrix44 &inverse() const
+            {
+#ifdef ALGEBRA_PLUGIN_LAZY_INVERSE
+                if (not _has_inverse)
+                {
+                    _data_inv = invert_transform(_data, _kind);
+                    _has_inverse = true;
+                }
+#endif
+                return _data_inv;
+            }
+
             /** The determinant of a 4x4 matrix
              * 
              * @param m is the matrix
              *
              * @return a sacalar determinant - no checking done 
              */
-            static scalar determinant(const matrix44 &m)
+            template <typename matrix_type>
+            static auto determinant(const matrix_type &m)
             {
                 return m.t[0] * m.z[1] * m.y[2] * m.x[3] - m.z[0] * m.t[1] * m.y[2] * m.x[3] - m.t[0] * m.y[1] * m.z[2] * m.x[3] + m.y[0] * m.t[1] * m.z[2] * m.x[3] +
                        m.z[0] * m.y[1] * m.t[2] * m.x[3] - m.y[0] * m.z[1] * m.t[2] * m.x[3] - m.t[0] * m.z[1] * m.x[2] * m.y[3] + m.z[0] * m.t[1] * m.x[2] * m.y[3] +
@@ -358,10 +596,16 @@ namespace algebra
              * @param m is the matrix
              *
              * @return an inverse matrix 
+             *
+             * @note the cofactors and the determinant are accumulated in the accumulator type
              */
-            static matrix44 invert(const matrix44 &m)
+            static matrix44 invert(const matrix44 &ms)
             {
-                matrix44 i;
+                const matrix44_acc m = {{ms.x[0], ms.x[1], ms.x[2], ms.x[3]},
+                                        {ms.y[0], ms.y[1], ms.y[2], ms.y[3]},
+                                        {ms.z[0], ms.z[1], ms.z[2], ms.z[3]},
+                                        {ms.t[0], ms.t[1], ms.t[2], ms.t[3]}};
+                matrix44_acc i;
                 i.x[0] = m.z[1] * m.t[2] * m.y[3] - m.t[1] * m.z[2] * m.y[3] + m.t[1] * m.y[2] * m.z[3] - m.y[1] * m.t[2] * m.z[3] - m.z[1] * m.y[2] * m.t[3] + m.y[1] * m.z[2] * m.t[3];
                 i.x[1] = m.t[1] * m.z[2] * m.x[3] - m.z[1] * m.t[2] * m.x[3] - m.t[1] * m.x[2] * m.z[3] + m.x[1] * m.t[2] * m.z[3] + m.z[1] * m.x[2] * m.t[3] - m.x[1] * m.z[2] * m.t[3];
                 i.x[2] = m.y[1] * m.t[2] * m.x[3] - m.t[1] * m.y[2] * m.x[3] + m.t[1] * m.x[2] * m.y[3] - m.x[1] * m.t[2] * m.y[3] - m.y[1] * m.x[2] * m.t[3] + m.x[1] * m.y[2] * m.t[3];
@@ -378,16 +622,83 @@ namespace algebra
                 i.t[1] = m.z[0] * m.t[1] * m.x[2] - m.t[0] * m.z[1] * m.x[2] + m.t[0] * m.x[1] * m.z[2] - m.x[0] * m.t[1] * m.z[2] - m.z[0] * m.x[1] * m.t[2] + m.x[0] * m.z[1] * m.t[2];
                 i.t[2] = m.t[0] * m.y[1] * m.x[2] - m.y[0] * m.t[1] * m.x[2] - m.t[0] * m.x[1] * m.y[2] + m.x[0] * m.t[1] * m.y[2] + m.y[0] * m.x[1] * m.t[2] - m.x[0] * m.y[1] * m.t[2];
                 i.t[3] = m.y[0] * m.z[1] * m.x[2] - m.z[0] * m.y[1] * m.x[2] + m.z[0] * m.x[1] * m.y[2] - m.x[0] * m.z[1] * m.y[2] - m.y[0] * m.x[1] * m.z[2] + m.x[0] * m.y[1] * m.z[2];
-                scalar idet = 1. / determinant(i);
+                const accumulator idet = 1. / determinant(m);
 
-                i.x *= idet;
-                i.y *= idet;
-                i.z *= idet;
-                i.t *= idet;
+                auto scale = [idet](const std::array<accumulator, 4> &c) {
+                    return vector3(static_cast<scalar>(c[0] * idet), static_cast<scalar>(c[1] * idet),
+                                   static_cast<scalar>(c[2] * idet), static_cast<scalar>(c[3] * idet));
+                };
+                return matrix44{scale(i.x), scale(i.y), scale(i.z), scale(i.t)};
+            }
+
+            /** The inverse of a rigid body transform, i.e. of an orthonormal rotation R
+             *  and a translation t, without the full 4x4 cofactor expansion
+             *
+             * @param m is the matrix
+             *
+             * @return the inverse matrix, built from R^T and -R^T t
+             */
+            static matrix44 invert_isometry(const matrix44 &m)
+            {
+                const accumulator t0 = m.t[0], t1 = m.t[1], t2 = m.t[2];
 
+                matrix44 i;
+                i.x = {m.x[0], m.y[0], m.z[0], 0.};
+                i.y = {m.x[1], m.y[1], m.z[1], 0.};
+                i.z = {m.x[2], m.y[2], m.z[2], 0.};
+                i.t = {static_cast<scalar>(-(m.x[0] * t0 + m.x[1] * t1 + m.x[2] * t2)),
+                       static_cast<scalar>(-(m.y[0] * t0 + m.y[1] * t1 + m.y[2] * t2)),
+                       static_cast<scalar>(-(m.z[0] * t0 + m.z[1] * t1 + m.z[2] * t2)), 1.};
                 return i;
             }
 
+            /** Check whether a 4x4 matrix describes a rigid body transform
+             *
+             * @param m is the matrix
+             *
+             * @return true if the rotation is orthonormal and the last row is (0, 0, 0, 1)
+             */
+            static bool is_isometry(const matrix44 &m)
+            {
+                constexpr scalar tolerance = 1e3 * std::numeric_limits<scalar>::epsilon();
+                const vector3 *columns[3] = {&m.x, &m.y, &m.z};
+                for (unsigned int a = 0; a < 3; ++a)
+                {
+                    for (unsigned int b = 0; b <= a; ++b)
+                    {
+                        const vector3 &ca = *columns[a], &cb = *columns[b];
+                        const accumulator d = accumulator(ca[0]) * cb[0] + accumulator(ca[1]) * cb[1] +
+                                              accumulator(ca[2]) * cb[2];
+                        if (std::abs(d - (a == b ? 1. : 0.)) > tolerance)
+                        {
+                            return false;
+                        }
+                    }
+                }
+                return std::abs(m.x[3]) <= tolerance and std::abs(m.y[3]) <= tolerance and
+                       std::abs(m.z[3]) <= tolerance and std::abs(m.t[3] - 1.) <= tolerance;
+            }
+
+            /** The inverse as computed at construction: the transform is taken to be a
+             *  rigid body transform. If ALGEBRA_PLUGIN_VALIDATE_ISOMETRY is defined, the
+             *  matrix is checked first and general matrices fall back to invert().
+             *
+             * @param m is the matrix
+             * @param kind is the kind of the matrix, only general matrices are checked
+             *
+             * @return an inverse matrix
+             */
+            static matrix44 invert_transform(const matrix44 &m, [[maybe_unused]] transform_kind kind = transform_kind::general)
+            {
+#ifdef ALGEBRA_PLUGIN_VALIDATE_ISOMETRY
+                if (kind == transform_kind::general and not is_isometry(m))
+                {
+                    return invert(m);
+                }
+#endif
+                return invert_isometry(m);
+            }
+
             /** Rotate a vector into / from a frame 
              * 
              * @param m is the rotation matrix
@@ -398,10 +709,28 @@ namespace algebra
                 return m.x*v[0] + m.y*v[1] + m.z*v[2];
             }
 
-            /** This method retrieves the rotation of a transform */
-            auto rotation() const
+            /** The product of two affine 4x4 matrices: the columns of b are rotated by a,
+             *  and the translation of a is added to the last one
+             *
+             * @param a is the left matrix
+             * @param b is the right matrix
+             *
+             * @return the product, the last row is (0, 0, 0, 1) as the rotation columns
+             *         of a have a zero fourth lane
+             */
+            static matrix44 multiply(const matrix44 &a, const matrix44 &b)
+            {
+                return matrix44{rotate(a, b.x), rotate(a, b.y), rotate(a, b.z), a.x*b.t[0] + a.y*b.t[1] + a.z*b.t[2] + a.t};
+            }
+
+            /** This method retrieves the rotation of a transform
+             *
+             * @note The fourth lane of an affine rotation column is zero, so the
+             *       columns are returned as they are stored
+             **/
+            matrix33 rotation() const
             {
-                return getter::block<3, 3>(_data, 0, 0);
+                return matrix33{_data.x, _data.y, _data.z};
             }
 
             /** This method retrieves the translation of a transform */
@@ -416,6 +745,47 @@ namespace algebra
                 return _data;
             }
 
+            /** Transform a point or vector with the kernel of a transform kind, the kernels
+             *  of the special kinds scale by the diagonal of the rotation instead of rotating
+             *
+             * @tparam kKIND the kind of the matrix
+             * @tparam kTRANSLATE whether to apply the translation (points) or not (vectors)
+             *
+             * @param m is the transformation matrix
+             * @param v is the point/vector
+             *
+             * @note The fourth lane is the same as for the general kernel, it enters the dot
+             *       product. This is why the identity uses the translation kernel.
+             */
+            template <transform_kind kKIND, bool kTRANSLATE>
+            static vector3 transform_kernel(const matrix44 &m, const vector3 &v)
+            {
+                if constexpr (kKIND == transform_kind::general)
+                {
+                    if constexpr (kTRANSLATE)
+                    {
+                        return m.x*v[0] + m.y*v[1] + m.z*v[2] + m.t;
+                    }
+                    else
+                    {
+                        return rotate(m, v);
+                    }
+                }
+                else
+                {
+                    const vector3 d = kKIND == transform_kind::axis_aligned ? vector3(m.x[0], m.y[1], m.z[2])
+                                                                            : vector3(1., 1., 1.);
+                    if constexpr (kTRANSLATE)
+                    {
+                        return d*v + m.t;
+                    }
+                    else
+                    {
+                        return d*v;
+                    }
+                }
+            }
+
             /** This method transform from a point from the local 3D cartesian frame 
              *  to the global 3D cartesian frame 
              *
@@ -428,7 +798,25 @@ namespace algebra
             template <typename point_type>
             const point_type point_to_global(const point_type &v) const
             {
-                return _data.x*v[0] + _data.y*v[1] + _data.z*v[2] + _data.t;
+                return dispatch_kind(_kind, [&](auto kind) { return point_to_global<decltype(kind)::value>(v); });
+            }
+
+            /** This method transform from a point from the local 3D cartesian frame
+             *  to the global 3D cartesian frame, with the kernel of a kind that is known
+             *  at compile time
+             *
+             * @tparam kKIND the kind of the transform, or a more general one
+             * @tparam point_type 3D point
+             *
+             * @param v is the point to be transformed
+             *
+             * @return a global point
+             */
+            template <transform_kind kKIND, typename point_type>
+            const point_type point_to_global(const point_type &v) const
+            {
+                assert(_kind <= kKIND);
+                return transform_kernel<kKIND, true>(_data, v);
             }
 
             /** This method transform from a vector from the global 3D cartesian frame 
@@ -443,7 +831,50 @@ namespace algebra
             template <typename point_type>
             const point_type point_to_local(const point_type &v) const
             {
-                return _data_inv.x*v[0] + _data_inv.y*v[1] + _data_inv.z*v[2] + _data_inv.t;
+                return dispatch_kind(_kind, [&](auto kind) { return point_to_local<decltype(kind)::value>(v); });
+            }
+
+            /** This method transform from a point from the global 3D cartesian frame
+             *  into the local 3D cartesian frame, with the kernel of a kind that is known
+             *  at compile time. The inverse has the same kind.
+             *
+             * @tparam kKIND the kind of the transform, or a more general one
+             * @tparam point_type 3D point
+             *
+             * @param v is the point to be transformed
+             *
+             * @return a local point
+             */
+            template <transform_kind kKIND, typename point_type>
+            const point_type point_to_local(const point_type &v) const
+            {
+                assert(_kind <= kKIND);
+                return transform_kernel<kKIND, true>(inverse(), v);
+            }
+
+            /** This method transforms a point from the global 3D cartesian frame into the first two
+             *  coordinates of the local 3D cartesian frame
+             *
+             * @note The rows are evaluated in parallel lanes, so all of them are computed
+             */
+            template <typename point_type>
+            point2 point_to_local2(const point_type &v) const
+            {
+                const point3 local = point_to_local(v);
+                return point2{local[0], local[1]};
+            }
+
+            /** This method transforms a point from the global 3D cartesian frame into the first two
+             *  coordinates of the local 3D cartesian frame, with the kernel of a kind that is known
+             *  at compile time
+             *
+             * @tparam kKIND the kind of the transform, or a more general one
+             */
+            template <transform_kind kKIND, typename point_type>
+            point2 point_to_local2(const point_type &v) const
+            {
+                const point3 local = point_to_local<kKIND>(v);
+                return point2{local[0], local[1]};
             }
 
             /** This method transform from a vector from the local 3D cartesian frame 
@@ -458,7 +889,25 @@ namespace algebra
             template <typename vector_type>
             const vector_type vector_to_global(const vector_type &v) const
             {
-                return rotate(_data, v);
+                return dispatch_kind(_kind, [&](auto kind) { return vector_to_global<decltype(kind)::value>(v); });
+            }
+
+            /** This method transform from a vector from the local 3D cartesian frame
+             *  to the global 3D cartesian frame, with the kernel of a kind that is known
+             *  at compile time
+             *
+             * @tparam kKIND the kind of the transform, or a more general one
+             * @tparam vector_type 3D vector
+             *
+             * @param v is the vector to be transformed
+             *
+             * @return a vector in global coordinates
+             */
+            template <transform_kind kKIND, typename vector_type>
+            const vector_type vector_to_global(const vector_type &v) const
+            {
+                assert(_kind <= kKIND);
+                return transform_kernel<kKIND, false>(_data, v);
             }
 
             /** This method transform from a vector from the global 3D cartesian frame
@@ -473,10 +922,446 @@ namespace algebra
             template <typename vector_type>
             const auto vector_to_local(const vector_type &v) const
             {
-                return rotate(_data_inv, v);
+                return dispatch_kind(_kind, [&](auto kind) { return vector_to_local<decltype(kind)::value>(v); });
+            }
+
+            /** This method transform from a vector from the global 3D cartesian frame
+             *  into the local 3D cartesian frame, with the kernel of a kind that is known
+             *  at compile time
+             *
+             * @tparam kKIND the kind of the transform, or a more general one
+             * @tparam vector_type 3D vector
+             *
+             * @param v is the vector to be transformed
+             *
+             * @return a vector in local coordinates
+             */
+            template <transform_kind kKIND, typename vector_type>
+            const vector3 vector_to_local(const vector_type &v) const
+            {
+                assert(_kind <= kKIND);
+                return transform_kernel<kKIND, false>(inverse(), v);
+            }
+
+            /** Transform points or vectors in structure-of-arrays layout with a given matrix.
+             *  The matrix elements are broadcast, so that every lane holds a different point.
+             *
+             * @tparam kTRANSLATE whether to apply the translation (points) or not (vectors)
+             *
+             * @param m is the transformation matrix
+             * @param v the structure-of-arrays input points/vectors
+             *
+             * @return the transformed points/vectors, in structure-of-arrays layout
+             */
+            template <bool kTRANSLATE>
+            static simd::vector3_v transform_soa(const matrix44 &m, const simd::vector3_v &v)
+            {
+                simd::vector3_v r;
+                r.x = m.x[0] * v.x + m.y[0] * v.y + m.z[0] * v.z;
+                r.y = m.x[1] * v.x + m.y[1] * v.y + m.z[1] * v.z;
+                r.z = m.x[2] * v.x + m.y[2] * v.y + m.z[2] * v.z;
+                if (kTRANSLATE)
+                {
+                    r.x += m.t[0];
+                    r.y += m.t[1];
+                    r.z += m.t[2];
+                }
+                return r;
+            }
+
+            /** This method transforms scalar_v::Size points from the local 3D cartesian frame
+             *  to the global 3D cartesian frame
+             *
+             * @param v the points in structure-of-arrays layout
+             *
+             * @return the global points
+             */
+            simd::point3_v point_to_global(const simd::point3_v &v) const
+            {
+                return transform_soa<true>(_data, v);
+            }
+
+            /** This method transforms scalar_v::Size points from the global 3D cartesian frame
+             *  into the local 3D cartesian frame
+             *
+             * @param v the points in structure-of-arrays layout
+             *
+             * @return the local points
+             */
+            simd::point3_v point_to_local(const simd::point3_v &v) const
+            {
+                return transform_soa<true>(inverse(), v);
+            }
+
+            /** This method transforms scalar_v::Size vectors from the local 3D cartesian frame
+             *  to the global 3D cartesian frame
+             *
+             * @param v the vectors in structure-of-arrays layout
+             *
+             * @return the global vectors
+             */
+            simd::vector3_v vector_to_global(const simd::vector3_v &v) const
+            {
+                return transform_soa<false>(_data, v);
+            }
+
+            /** This method transforms scalar_v::Size vectors from the global 3D cartesian frame
+             *  into the local 3D cartesian frame
+             *
+             * @param v the vectors in structure-of-arrays layout
+             *
+             * @return the local vectors
+             */
+            simd::vector3_v vector_to_local(const simd::vector3_v &v) const
+            {
+                return transform_soa<false>(inverse(), v);
+            }
+
+            /** Transform a batch of points or vectors with a given matrix. The matrix
+             *  columns are loaded into simd registers once, outside of the loop.
+             *
+             * @tparam kTRANSLATE whether to apply the translation (points) or not (vectors)
+             * @tparam kKIND the kind of the matrix, the kernels of the special kinds only use
+             *         the diagonal of the rotation
+             *
+             * @param m is the transformation matrix
+             * @param in the input range of points/vectors
+             * @param out the output range, needs at least the size of the input range
+             */
+            template <bool kTRANSLATE, transform_kind kKIND = transform_kind::general, typename input_type,
+                      typename output_type>
+            static void transform_batch(const matrix44 &m, const input_type &in, output_type &out)
+            {
+                assert(out.size() >= in.size());
+
+                const simd::array<scalar, 4> t = kTRANSLATE ? m.t._array : simd::array<scalar, 4>(scalar{0.});
+
+                const std::size_t n = in.size();
+                if constexpr (kKIND == transform_kind::general)
+                {
+                    const simd::array<scalar, 4> x = m.x._array;
+                    const simd::array<scalar, 4> y = m.y._array;
+                    const simd::array<scalar, 4> z = m.z._array;
+
+                    for (std::size_t i = 0; i < n; ++i)
+                    {
+                        out[i] = x * in[i][0] + y * in[i][1] + z * in[i][2] + t;
+                    }
+                }
+                else
+                {
+                    const vector3 d = kKIND == transform_kind::axis_aligned ? vector3(m.x[0], m.y[1], m.z[2])
+                                                                            : vector3(1., 1., 1.);
+                    for (std::size_t i = 0; i < n; ++i)
+                    {
+                        out[i] = d * in[i] + t;
+                    }
+                }
+            }
+
+            /** This method transforms a range of points from the local 3D cartesian frame
+             *  to the global 3D cartesian frame
+             *
+             * @param points the input points in the local frame
+             * @param results the output points in the global frame, at least of the size of the input
+             */
+            template <typename input_type, typename output_type>
+            void point_to_global(const input_type &points, output_type &&results) const
+            {
+                dispatch_kind(_kind, [&](auto kind) { transform_batch<true, decltype(kind)::value>(_data, points, results); });
+            }
+
+            /** This method transforms a range of points from the global 3D cartesian frame
+             *  into the local 3D cartesian frame
+             *
+             * @param points the input points in the global frame
+             * @param results the output points in the local frame, at least of the size of the input
+             */
+            template <typename input_type, typename output_type>
+            void point_to_local(const input_type &points, output_type &&results) const
+            {
+                dispatch_kind(_kind, [&](auto kind) { transform_batch<true, decltype(kind)::value>(inverse(), points, results); });
+            }
+
+            /** This method transforms a range of vectors from the local 3D cartesian frame
+             *  to the global 3D cartesian frame
+             *
+             * @param vectors the input vectors in the local frame
+             * @param results the output vectors in the global frame, at least of the size of the input
+             */
+            template <typename input_type, typename output_type>
+            void vector_to_global(const input_type &vectors, output_type &&results) const
+            {
+                dispatch_kind(_kind, [&](auto kind) { transform_batch<false, decltype(kind)::value>(_data, vectors, results); });
+            }
+
+            /** This method transforms a range of vectors from the global 3D cartesian frame
+             *  into the local 3D cartesian frame
+             *
+             * @param vectors the input vectors in the global frame
+             * @param results the output vectors in the local frame, at least of the size of the input
+             */
+            template <typename input_type, typename output_type>
+            void vector_to_local(const input_type &vectors, output_type &&results) const
+            {
+                dispatch_kind(_kind, [&](auto kind) { transform_batch<false, decltype(kind)::value>(inverse(), vectors, results); });
             }
         };
 
+        /** Transform wrapper class with a compact storage layout: the rotation columns and
+         *  the translation, without a stored inverse. The inverse is derived on the fly as
+         *  R^T (p - t), which requires a rigid body transform.
+         *
+         * @note The columns stay padded to four lanes for the vectorized global transforms
+         **/
+        struct compact_transform3
+        {
+            // The inverse is always derived as the one of a rigid body transform
+            static constexpr bool assumes_isometry = true;
+
+            using matrix44 = transform3::matrix44;
+            using matrix33 = transform3::matrix33;
+
+            matrix44 _data;
+
+            /** Contructor with arguments: t, z, x
+             * 
+             * @param t the translation (or origin of the new frame)
+             * @param z the z axis of the new frame, normal vector for planes
+             * @param x the x axis of the new frame
+             * 
+             * @note y will be constructed by cross product
+             * 
+             **/
+            compact_transform3(const vector3 &t, const vector3 &z, const vector3 &x)
+            {
+                auto y = vector::cross(z, x);
+                _data.x = {x[0], x[1], x[2], 0.};
+                _data.y = {y[0], y[1], y[2], 0.};
+                _data.z = {z[0], z[1], z[2], 0.};
+                _data.t = {t[0], t[1], t[2], 1.};
+            }
+
+            /** Constructor with arguments: translation
+             *
+             * @param t is the transform
+             **/
+            compact_transform3(const vector3 &t)
+            {
+                _data.x = {1., 0., 0., 0.};
+                _data.y = {0., 1., 0., 0.};
+                _data.z = {0., 0., 1., 0.};
+                _data.t = {t[0], t[1], t[2], 1.};
+            }
+
+            /** Constructor with arguments: matrix 
+             * 
+             * @param m is the full 4x4 matrix 
+             **/
+            compact_transform3(const matrix44 &m)
+            {
+                _data = m;
+            }
+
+            /** Constructor with arguments: matrix as std::aray of scalar
+             * 
+             * @param ma is the full 4x4 matrix 16 array
+             **/
+            compact_transform3(const array_s<scalar, 16> &ma)
+            {
+                _data.x = {ma[0], ma[4], ma[8], ma[12]};
+                _data.y = {ma[1], ma[5], ma[9], ma[13]};
+                _data.z = {ma[2], ma[6], ma[10], ma[14]};
+                _data.t = {ma[3], ma[7], ma[11], ma[15]};
+            }
+
+            /** Constructor with arguments: full transform */
+            compact_transform3(const transform3 &trf) : compact_transform3(trf.matrix()) {}
+
+            /** Constructor with arguments: identity
+             *
+             **/
+            compact_transform3() : compact_transform3(vector3{0., 0., 0.}) {}
+
+            /** Default contructors */
+            compact_transform3(const compact_transform3 &rhs) = default;
+            ~compact_transform3() = default;
+
+            /** Equality operator */
+            bool operator==(const compact_transform3 &rhs) const
+            {
+                return (_data == rhs._data);
+            }
+
+            /** This method retrieves the rotation of a transform
+             *
+             * @note The fourth lane of an affine rotation column is zero, so the
+             *       columns are returned as they are stored
+             **/
+            matrix33 rotation() const
+            {
+                return matrix33{_data.x, _data.y, _data.z};
+            }
+
+            /** This method retrieves the translation of a transform */
+            point3 translation() const
+            {
+                return _data.t;
+            }
+
+            /** This method retrieves the 4x4 matrix of a transform */
+            const matrix44 &matrix() const
+            {
+                return _data;
+            }
+
+            /** This method transform from a point from the local 3D cartesian frame 
+             *  to the global 3D cartesian frame 
+             *
+             * @tparam point_type 3D point
+             *
+             * @param v is the point to be transformed
+             *
+             * @return a global point
+             */
+            template <typename point_type>
+            const point_type point_to_global(const point_type &v) const
+            {
+                return _data.x*v[0] + _data.y*v[1] + _data.z*v[2] + _data.t;
+            }
+
+            /** This method transform from a vector from the global 3D cartesian frame 
+             *  into the local 3D cartesian frame
+             *
+             * @tparam point_type 3D point
+             *
+             * @param v is the point to be transformed
+             *
+             * @return a local point
+             */
+            template <typename point_type>
+            const point_type point_to_local(const point_type &v) const
+            {
+                const scalar d0 = v[0] - _data.t[0], d1 = v[1] - _data.t[1], d2 = v[2] - _data.t[2];
+                return point_type{_data.x[0] * d0 + _data.x[1] * d1 + _data.x[2] * d2,
+                                  _data.y[0] * d0 + _data.y[1] * d1 + _data.y[2] * d2,
+                                  _data.z[0] * d0 + _data.z[1] * d1 + _data.z[2] * d2};
+            }
+
+            /** This method transforms a point from the global 3D cartesian frame into the first two
+             *  coordinates of the local 3D cartesian frame, only the two needed rows are evaluated
+             */
+            template <typename point_type>
+            point2 point_to_local2(const point_type &v) const
+            {
+                const scalar d0 = v[0] - _data.t[0], d1 = v[1] - _data.t[1], d2 = v[2] - _data.t[2];
+                return point2{_data.x[0] * d0 + _data.x[1] * d1 + _data.x[2] * d2,
+                              _data.y[0] * d0 + _data.y[1] * d1 + _data.y[2] * d2};
+            }
+
+            /** This method transform from a vector from the local 3D cartesian frame 
+             *  to the global 3D cartesian frame
+             *
+             * @tparam vector_type 3D vector 
+             *
+             * @param v is the vector to be transformed
+             *
+             * @return a vector in global coordinates
+             */
+            template <typename vector_type>
+            const vector_type vector_to_global(const vector_type &v) const
+            {
+                return transform3::rotate(_data, v);
+            }
+
+            /** This method transform from a vector from the global 3D cartesian frame
+             *  into the local 3D cartesian frame
+             *
+             * @tparam vector_type 3D vector 
+             *
+             * @param v is the vector to be transformed
+             *
+             * @return a vector in global coordinates
+             */
+            template <typename vector_type>
+            const vector_type vector_to_local(const vector_type &v) const
+            {
+                return vector_type{_data.x[0] * v[0] + _data.x[1] * v[1] + _data.x[2] * v[2],
+                                   _data.y[0] * v[0] + _data.y[1] * v[1] + _data.y[2] * v[2],
+                                   _data.z[0] * v[0] + _data.z[1] * v[1] + _data.z[2] * v[2]};
+            }
+
+            /** This method transforms a range of points from the local 3D cartesian frame
+             *  to the global 3D cartesian frame
+             *
+             * @param points the input points in the local frame
+             * @param results the output points in the global frame, at least of the size of the input
+             */
+            template <typename input_type, typename output_type>
+            void point_to_global(const input_type &points, output_type &&results) const
+            {
+                transform3::transform_batch<true>(_data, points, results);
+            }
+
+            /** This method transforms a range of points from the global 3D cartesian frame
+             *  into the local 3D cartesian frame, the inverse is computed once per batch
+             *
+             * @param points the input points in the global frame
+             * @param results the output points in the local frame, at least of the size of the input
+             */
+            template <typename input_type, typename output_type>
+            void point_to_local(const input_type &points, output_type &&results) const
+            {
+                transform3::transform_batch<true>(transform3::invert_isometry(_data), points, results);
+            }
+
+            /** This method transforms a range of vectors from the local 3D cartesian frame
+             *  to the global 3D cartesian frame
+             *
+             * @param vectors the input vectors in the local frame
+             * @param results the output vectors in the global frame, at least of the size of the input
+             */
+            template <typename input_type, typename output_type>
+            void vector_to_global(const input_type &vectors, output_type &&results) const
+            {
+                transform3::transform_batch<false>(_data, vectors, results);
+            }
+
+            /** This method transforms a range of vectors from the global 3D cartesian frame
+             *  into the local 3D cartesian frame, the inverse is computed once per batch
+             *
+             * @param vectors the input vectors in the global frame
+             * @param results the output vectors in the local frame, at least of the size of the input
+             */
+            template <typename input_type, typename output_type>
+            void vector_to_local(const input_type &vectors, output_type &&results) const
+            {
+                transform3::transform_batch<false>(transform3::invert_isometry(_data), vectors, results);
+            }
+        };
+
+        /** Contiguous container of transforms that is addressed by index
+         *
+         * @tparam layout_t aos_layout or soa_layout
+         **/
+        template <typename layout_t = aos_layout>
+        using transform_store = algebra::transform_store<transform3, vector3, layout_t>;
+
+        /** Read-only view of structure of arrays transforms, e.g. of a transform file */
+        using transform_view = algebra::transform_view<transform3, vector3>;
+
+        /** Memory mapped binary transform file */
+        using transform_file = algebra::transform_file<scalar>;
+
+        /** Quaternion encoding of transform collections for compact geometry files */
+        using transform_codec = algebra::transform_codec<transform3, vector3>;
+
+        /** Hierarchy of transforms with lazily composed global transforms */
+        using transform_tree = algebra::transform_tree<transform3>;
+
+        /** Quaternion rotation and translation, a compact transform for large collections */
+        using quaternion_transform3 = algebra::quaternion_transform3<scalar, vector3>;
+
         /** Frame projection into a cartesian coordinate frame
          */
         struct cartesian2
@@ -484,15 +1369,18 @@ namespace algebra
             /** This method transform from a point from the global 3D cartesian frame 
              *  to the local 2D cartesian frame 
              * 
+             * @tparam transform_type transform3 or compact_transform3
+             *
              * @param trf the transform from global to local thredimensional frame
              * @param p the point in global frame
              * 
              * @return a local point2
              **/
-            point2 operator()(const transform3 &trf,
+            template <typename transform_type>
+            point2 operator()(const transform_type &trf,
                                   const point3 &p) const
             {
-                return operator()(trf.point_to_local(p));
+                return trf.point_to_local2(p);
             }
 
             /** This method transform from a point from the global 3D cartesian 
@@ -506,6 +1394,17 @@ namespace algebra
             {
                 return {v[0], v[1]};
             }
+
+            /** This method projects a range of points from the global 3D cartesian frame into the local 2D frame,
+             *  see detail::project_range
+             **/
+            template <typename transform_type, typename input_type, typename output_type>
+            void operator()(const transform_type &trf, const input_type &points, output_type &&results) const
+            {
+                detail::project_range(trf, points, results, [&trf](auto kind, const auto &p) {
+                    return detail::point_to_local2<decltype(kind)::value>(trf, p);
+                });
+            }
         };
 
         /** Local frame projection into a polar coordinate frame */
@@ -514,15 +1413,18 @@ namespace algebra
             /** This method transform from a point from the global 3D cartesian 
              *  frame to the local 2D cartesian frame 
              * 
+             * @tparam transform_type transform3 or compact_transform3
+             *
              * @param trf the transform from global to local thredimensional frame
              * @param p the point in global frame
              * 
              * @return a local point2
              **/
-            point2 operator()(const transform3 &trf,
+            template <typename transform_type>
+            point2 operator()(const transform_type &trf,
                                   const point3 &p) const
             {
-                return operator()(trf.point_to_local(p));
+                return operator()(trf.point_to_local2(p));
             }
 
             /** This method transform from a point from 2D or 3D cartesian frame 
@@ -532,6 +1434,17 @@ namespace algebra
             {
                 return point2{getter::perp(v), getter::phi(v)};
             }
+
+            /** This method projects a range of points from the global 3D cartesian frame into the local 2D frame,
+             *  see detail::project_range
+             **/
+            template <typename transform_type, typename input_type, typename output_type>
+            void operator()(const transform_type &trf, const input_type &points, output_type &&results) const
+            {
+                detail::project_range(trf, points, results, [this, &trf](auto kind, const auto &p) {
+                    return (*this)(detail::point_to_local2<decltype(kind)::value>(trf, p));
+                });
+            }
         };
 
         /** Local frame projection into a polar coordinate frame */
@@ -540,12 +1453,15 @@ namespace algebra
              /** This method transform from a point from the global 3D cartesian 
               *  frame to the local 2D cartesian frame 
               * 
+              * @tparam transform_type transform3 or compact_transform3
+              *
               * @param trf the transform from global to local thredimensional frame
               * @param p the point in global frame
               * 
               * @return a local point2
               **/
-            point2 operator()(const transform3 &trf,
+            template <typename transform_type>
+            point2 operator()(const transform_type &trf,
                                   const point3 &p) const
             {
                 return operator()(trf.point_to_local(p));
@@ -557,6 +1473,17 @@ namespace algebra
             {
                 return point2{getter::perp(v) * getter::phi(v), v[2]};
             }
+
+            /** This method projects a range of points from the global 3D cartesian frame into the local 2D frame,
+             *  see detail::project_range
+             **/
+            template <typename transform_type, typename input_type, typename output_type>
+            void operator()(const transform_type &trf, const input_type &points, output_type &&results) const
+            {
+                detail::project_range(trf, points, results, [this, &trf](auto kind, const auto &p) {
+                    return (*this)(detail::point_to_local<decltype(kind)::value>(trf, p));
+                });
+            }
         };
 
     } // namespace vc_array
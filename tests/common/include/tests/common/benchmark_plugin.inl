@@ -0,0 +1,843 @@
+/** Algebra plugins library, part of the ACTS project
+ *
+ * (c) 2020 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#include "common/types.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <iterator>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+/// @note __plugin has to be defined with a preprocessor command
+using namespace algebra;
+
+// Two-dimensional definitions
+using point2 = __plugin::point2;
+__plugin::cartesian2 cartesian2;
+__plugin::polar2 polar2;
+__plugin::cylindrical2 cylindrical2;
+
+// Three-dimensional definitions
+using transform3 = __plugin::transform3;
+using compact_transform3 = __plugin::compact_transform3;
+using vector3 = __plugin::vector3;
+using point3 = __plugin::point3;
+
+// Batch sizes: from a single module up to the hits of a full event
+#define ALGEBRA_BENCHMARK(bench) BENCHMARK(bench)->RangeMultiplier(10)->Range(1000, 100000)
+
+namespace
+{
+    /** Generate a reproducible set of random vectors
+     *
+     * @param n the number of vectors
+     * @param seed the seed of the random number generator
+     **/
+    std::vector<vector3> random_vectors(std::size_t n, unsigned int seed = 42)
+    {
+        std::mt19937 generator(seed);
+        std::uniform_real_distribution<scalar> dist(-10., 10.);
+
+        std::vector<vector3> vectors;
+        vectors.reserve(n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            vectors.push_back(vector3{dist(generator), dist(generator), dist(generator)});
+        }
+        return vectors;
+    }
+
+    /** Generate the input data for the transform constructors: t, z, x
+     *
+     * @param n the number of transforms
+     **/
+    auto random_frames(std::size_t n)
+    {
+        auto translations = random_vectors(n, 1);
+        auto zs = random_vectors(n, 2);
+        auto xs = random_vectors(n, 3);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            zs[i] = vector::normalize(zs[i]);
+            vector3 x = vector::cross(zs[i], xs[i]);
+            xs[i] = vector::normalize(x);
+        }
+        return std::make_tuple(translations, zs, xs);
+    }
+
+    /** Generate a reproducible set of random transforms
+     *
+     * @tparam transform_type the transform storage, transform3 or compact_transform3
+     *
+     * @param n the number of transforms
+     **/
+    template <typename transform_type = transform3>
+    std::vector<transform_type> random_transforms(std::size_t n)
+    {
+        auto [translations, zs, xs] = random_frames(n);
+
+        std::vector<transform_type> transforms;
+        transforms.reserve(n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            transforms.push_back(transform_type(translations[i], zs[i], xs[i]));
+        }
+        return transforms;
+    }
+
+    /** Generate a reproducible random permutation of transform indices
+     *
+     * @param n the number of indices
+     **/
+    std::vector<std::size_t> random_indices(std::size_t n)
+    {
+        std::vector<std::size_t> indices(n);
+        std::iota(indices.begin(), indices.end(), 0);
+        std::shuffle(indices.begin(), indices.end(), std::mt19937(42));
+        return indices;
+    }
+} // namespace
+
+// This benchmarks the transform3 construction (including the inverse)
+static void BM_transform3_construction(benchmark::State &state)
+{
+    const std::size_t n = state.range(0);
+    auto [translations, zs, xs] = random_frames(n);
+
+    for (auto _ : state)
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            transform3 trf(translations[i], zs[i], xs[i]);
+            benchmark::DoNotOptimize(trf);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+ALGEBRA_BENCHMARK(BM_transform3_construction);
+
+// This benchmarks the composition of placements, e.g. of a module in a layer in a volume
+static void BM_transform3_composition(benchmark::State &state)
+{
+    const std::size_t n = state.range(0);
+    const auto volumes = random_transforms<transform3>(n);
+    const auto layers = random_transforms<transform3>(n);
+    std::vector<transform3> results(n);
+
+    for (auto _ : state)
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            results[i] = volumes[i] * layers[i];
+        }
+        benchmark::DoNotOptimize(results.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+ALGEBRA_BENCHMARK(BM_transform3_composition);
+
+// This benchmarks the composition of placements with quaternion rotations
+static void BM_quaternion_composition(benchmark::State &state)
+{
+    const std::size_t n = state.range(0);
+    auto [translations, axes, unused] = random_frames(n);
+    std::vector<__plugin::quaternion_transform3> transforms;
+    transforms.reserve(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        transforms.emplace_back(translations[i], __plugin::quaternion::from_axis_angle(axes[i], translations[i][0]));
+    }
+    std::vector<__plugin::quaternion_transform3> results(n);
+
+    for (auto _ : state)
+    {
+        for (std::size_t i = 0; i + 1 < n; ++i)
+        {
+            results[i] = transforms[i] * transforms[i + 1];
+        }
+        benchmark::DoNotOptimize(results.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+ALGEBRA_BENCHMARK(BM_quaternion_composition);
+
+// This benchmarks an alignment update in a hierarchy of one volume, ten layers and n modules:
+// an update of a layer recomputes the global transforms of its modules only, an update of
+// the volume recomputes all of them
+static void BM_tree_alignment_update(benchmark::State &state, std::size_t node)
+{
+    const std::size_t n = state.range(0);
+    const std::size_t n_layers = 10;
+    const auto transforms = random_transforms(n + n_layers + 1);
+
+    __plugin::transform_tree tree;
+    tree.reserve(transforms.size());
+    const std::size_t volume = tree.add(transforms[0]);
+    for (std::size_t l = 0; l < n_layers; ++l)
+    {
+        tree.add(transforms[1 + l], volume);
+    }
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        tree.add(transforms[1 + n_layers + i], 1 + i % n_layers);
+    }
+    tree.flatten();
+
+    for (auto _ : state)
+    {
+        tree.set_local(node, transforms[node]);
+        tree.flatten();
+        benchmark::DoNotOptimize(tree.global(tree.size() - 1));
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK_CAPTURE(BM_tree_alignment_update, layer, 1)->RangeMultiplier(10)->Range(1000, 100000);
+BENCHMARK_CAPTURE(BM_tree_alignment_update, volume, 0)->RangeMultiplier(10)->Range(1000, 100000);
+
+// This benchmarks the local to global point transformation, for the full and the compact storage
+template <typename transform_type>
+static void BM_point_to_global(benchmark::State &state)
+{
+    const std::size_t n = state.range(0);
+    const auto transforms = random_transforms<transform_type>(n);
+    const auto points = random_vectors(n);
+    std::vector<point3> results(n);
+
+    for (auto _ : state)
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            results[i] = transforms[i].point_to_global(points[i]);
+        }
+        benchmark::DoNotOptimize(results.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+ALGEBRA_BENCHMARK(BM_point_to_global<transform3>);
+ALGEBRA_BENCHMARK(BM_point_to_global<compact_transform3>);
+
+// This benchmarks the local to global point transformation with the kernel of the transform
+// kind: translation-only placements against rotated ones
+static void BM_point_to_global_kind(benchmark::State &state, transform_kind kind)
+{
+    const std::size_t n = state.range(0);
+    auto transforms = random_transforms(n);
+    if (kind == transform_kind::translation)
+    {
+        const auto translations = random_vectors(n, 1);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            transforms[i] = transform3(translations[i]);
+        }
+    }
+    const auto points = random_vectors(n);
+    std::vector<point3> results(n);
+
+    for (auto _ : state)
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            results[i] = transforms[i].point_to_global(points[i]);
+        }
+        benchmark::DoNotOptimize(results.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK_CAPTURE(BM_point_to_global_kind, general, transform_kind::general)->RangeMultiplier(10)->Range(1000, 100000);
+BENCHMARK_CAPTURE(BM_point_to_global_kind, translation, transform_kind::translation)->RangeMultiplier(10)->Range(1000, 100000);
+
+// This benchmarks the global to local point transformation, for the full and the compact storage
+template <typename transform_type>
+static void BM_point_to_local(benchmark::State &state)
+{
+    const std::size_t n = state.range(0);
+    const auto transforms = random_transforms<transform_type>(n);
+    const auto points = random_vectors(n);
+    std::vector<point3> results(n);
+
+    for (auto _ : state)
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            results[i] = transforms[i].point_to_local(points[i]);
+        }
+        benchmark::DoNotOptimize(results.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+ALGEBRA_BENCHMARK(BM_point_to_local<transform3>);
+ALGEBRA_BENCHMARK(BM_point_to_local<compact_transform3>);
+
+// This benchmarks the local to global vector transformation
+static void BM_vector_to_global(benchmark::State &state)
+{
+    const std::size_t n = state.range(0);
+    const auto transforms = random_transforms(n);
+    const auto vectors = random_vectors(n);
+    std::vector<vector3> results(n);
+
+    for (auto _ : state)
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            results[i] = transforms[i].vector_to_global(vectors[i]);
+        }
+        benchmark::DoNotOptimize(results.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+ALGEBRA_BENCHMARK(BM_vector_to_global);
+
+// This benchmarks the global to local vector transformation
+static void BM_vector_to_local(benchmark::State &state)
+{
+    const std::size_t n = state.range(0);
+    const auto transforms = random_transforms(n);
+    const auto vectors = random_vectors(n);
+    std::vector<vector3> results(n);
+
+    for (auto _ : state)
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            results[i] = transforms[i].vector_to_local(vectors[i]);
+        }
+        benchmark::DoNotOptimize(results.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+ALGEBRA_BENCHMARK(BM_vector_to_local);
+
+// This benchmarks the batched local to global point transformation
+static void BM_point_to_global_batch(benchmark::State &state)
+{
+    const std::size_t n = state.range(0);
+    const auto transforms = random_transforms(1);
+    const auto points = random_vectors(n);
+    std::vector<point3> results(n);
+
+    for (auto _ : state)
+    {
+        transforms[0].point_to_global(points, results);
+        benchmark::DoNotOptimize(results.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+ALGEBRA_BENCHMARK(BM_point_to_global_batch);
+
+// This benchmarks the batched global to local point transformation
+static void BM_point_to_local_batch(benchmark::State &state)
+{
+    const std::size_t n = state.range(0);
+    const auto transforms = random_transforms(1);
+    const auto points = random_vectors(n);
+    std::vector<point3> results(n);
+
+    for (auto _ : state)
+    {
+        transforms[0].point_to_local(points, results);
+        benchmark::DoNotOptimize(results.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+ALGEBRA_BENCHMARK(BM_point_to_local_batch);
+
+// This benchmarks the batched local to global vector transformation
+static void BM_vector_to_global_batch(benchmark::State &state)
+{
+    const std::size_t n = state.range(0);
+    const auto transforms = random_transforms(1);
+    const auto vectors = random_vectors(n);
+    std::vector<vector3> results(n);
+
+    for (auto _ : state)
+    {
+        transforms[0].vector_to_global(vectors, results);
+        benchmark::DoNotOptimize(results.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+ALGEBRA_BENCHMARK(BM_vector_to_global_batch);
+
+// This benchmarks the batched global to local vector transformation
+static void BM_vector_to_local_batch(benchmark::State &state)
+{
+    const std::size_t n = state.range(0);
+    const auto transforms = random_transforms(1);
+    const auto vectors = random_vectors(n);
+    std::vector<vector3> results(n);
+
+    for (auto _ : state)
+    {
+        transforms[0].vector_to_local(vectors, results);
+        benchmark::DoNotOptimize(results.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+ALGEBRA_BENCHMARK(BM_vector_to_local_batch);
+
+// This benchmarks the global to local point transformation with randomly indexed transforms from a std::vector
+static void BM_gather_point_to_local(benchmark::State &state)
+{
+    const std::size_t n = state.range(0);
+    const auto transforms = random_transforms(n);
+    const auto indices = random_indices(n);
+    const auto points = random_vectors(n);
+    std::vector<point3> results(n);
+
+    for (auto _ : state)
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            results[i] = transforms[indices[i]].point_to_local(points[i]);
+        }
+        benchmark::DoNotOptimize(results.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+ALGEBRA_BENCHMARK(BM_gather_point_to_local);
+
+// This benchmarks the global to local point transformation with randomly indexed transforms from a transform store
+template <typename layout_t>
+static void BM_store_point_to_local(benchmark::State &state)
+{
+    const std::size_t n = state.range(0);
+    __plugin::transform_store<layout_t> store;
+    store.reserve(n);
+    for (const auto &trf : random_transforms(n))
+    {
+        store.push_back(trf);
+    }
+    const auto indices = random_indices(n);
+    const auto points = random_vectors(n);
+    std::vector<point3> results(n);
+
+    for (auto _ : state)
+    {
+        store.point_to_local(indices, points, results);
+        benchmark::DoNotOptimize(results.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+ALGEBRA_BENCHMARK(BM_store_point_to_local<aos_layout>);
+ALGEBRA_BENCHMARK(BM_store_point_to_local<soa_layout>);
+
+// This benchmarks an alignment reload: a small correction is applied to every transform of a store
+template <typename layout_t>
+static void BM_store_apply_delta(benchmark::State &state)
+{
+    const std::size_t n = state.range(0);
+    __plugin::transform_store<layout_t> store;
+    store.reserve(n);
+    for (const auto &trf : random_transforms(n))
+    {
+        store.push_back(trf);
+    }
+    const auto indices = random_indices(n);
+    auto rotation_deltas = random_vectors(n, 4);
+    for (auto &w : rotation_deltas)
+    {
+        w = w * scalar(1e-4);
+    }
+    const auto translation_deltas = random_vectors(n, 5);
+
+    for (auto _ : state)
+    {
+        store.apply_delta(indices, rotation_deltas, translation_deltas);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+ALGEBRA_BENCHMARK(BM_store_apply_delta<aos_layout>);
+ALGEBRA_BENCHMARK(BM_store_apply_delta<soa_layout>);
+
+// This benchmarks the construction of a store from a buffer of row major matrices, e.g. at
+// the start-up of the detector geometry: one transform at a time against the bulk construction
+template <typename layout_t, bool kBULK>
+static void BM_store_construction(benchmark::State &state)
+{
+    const std::size_t n = state.range(0);
+    __plugin::transform_store<soa_layout> reference;
+    reference.reserve(n);
+    for (const auto &trf : random_transforms(n))
+    {
+        reference.push_back(trf);
+    }
+    std::vector<scalar> buffer;
+    buffer.reserve(16 * n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        const auto ma = reference.matrix(i);
+        buffer.insert(buffer.end(), ma.begin(), ma.end());
+    }
+
+    for (auto _ : state)
+    {
+        __plugin::transform_store<layout_t> store;
+        if constexpr (kBULK)
+        {
+            store.append(buffer.data(), n);
+        }
+        else
+        {
+            store.reserve(n);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                array_s<scalar, 16> ma;
+                std::copy_n(buffer.begin() + 16 * i, 16, ma.begin());
+                store.emplace_back(ma);
+            }
+        }
+        benchmark::DoNotOptimize(store.size());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK_TEMPLATE2(BM_store_construction, aos_layout, false)->RangeMultiplier(10)->Range(1000, 100000);
+BENCHMARK_TEMPLATE2(BM_store_construction, aos_layout, true)->RangeMultiplier(10)->Range(1000, 100000);
+BENCHMARK_TEMPLATE2(BM_store_construction, soa_layout, false)->RangeMultiplier(10)->Range(1000, 100000);
+BENCHMARK_TEMPLATE2(BM_store_construction, soa_layout, true)->RangeMultiplier(10)->Range(1000, 100000);
+
+// This benchmarks the geometry loading from a binary transform file, with the
+// transforms used in place or constructed into a store
+template <bool kIN_PLACE>
+static void BM_transform_file_load(benchmark::State &state)
+{
+    const std::size_t n = state.range(0);
+    __plugin::transform_store<soa_layout> reference;
+    reference.reserve(n);
+    for (const auto &trf : random_transforms(n))
+    {
+        reference.push_back(trf);
+    }
+    // A file of its own in the temporary directory, parallel runs do not share it
+    const std::string path = (std::filesystem::temp_directory_path() /
+                              ("algebra_benchmark_transforms_" + std::to_string(std::random_device{}()) + ".bin"))
+                                 .string();
+    write_transform_file(path, reference, kIN_PLACE ? transform_file_header::soa : transform_file_header::aos);
+
+    for (auto _ : state)
+    {
+        __plugin::transform_file file(path);
+        if constexpr (kIN_PLACE)
+        {
+            const __plugin::transform_view view = file.view<transform3, vector3>();
+            benchmark::DoNotOptimize(view._components[0]);
+        }
+        else
+        {
+            __plugin::transform_store<aos_layout> store;
+            store.append(file.matrices(), file.size(), 12);
+            benchmark::DoNotOptimize(store.size());
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+    std::remove(path.c_str());
+}
+BENCHMARK_TEMPLATE(BM_transform_file_load, false)->RangeMultiplier(10)->Range(1000, 100000);
+BENCHMARK_TEMPLATE(BM_transform_file_load, true)->RangeMultiplier(10)->Range(1000, 100000);
+
+// This benchmarks the bulk decoding of quaternion encoded transforms
+template <typename storage_t>
+static void BM_transform_decode(benchmark::State &state)
+{
+    const std::size_t n = state.range(0);
+    const std::vector<storage_t> data = __plugin::transform_codec::encode<storage_t>(random_transforms(n));
+    std::vector<transform3> transforms;
+    transforms.reserve(n);
+
+    for (auto _ : state)
+    {
+        transforms.clear();
+        __plugin::transform_codec::decode(data.data(), n, std::back_inserter(transforms));
+        benchmark::DoNotOptimize(transforms.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+    state.SetBytesProcessed(state.iterations() * n * 7 * sizeof(storage_t));
+}
+BENCHMARK_TEMPLATE(BM_transform_decode, float)->RangeMultiplier(10)->Range(1000, 100000);
+BENCHMARK_TEMPLATE(BM_transform_decode, double)->RangeMultiplier(10)->Range(1000, 100000);
+
+// Bound (loc0, loc1, phi, theta, q/p, t) to free (x, y, z, t, tx, ty, tz, q/p) Jacobian
+using bound_to_free_pattern =
+    sparsity_pattern<8, 6,
+                     block_mask<8, 6>(0, 0, 3, 4) | block_mask<8, 6>(4, 2, 3, 2) | block_mask<8, 6>(3, 5) |
+                         block_mask<8, 6>(7, 4),
+                     block_mask<8, 6>(3, 5) | block_mask<8, 6>(7, 4)>;
+
+// This benchmarks the bound to free covariance transport, with the sparse or the dense Jacobian
+template <bool kSPARSE>
+static void BM_covariance_transport(benchmark::State &state)
+{
+    const std::size_t n = state.range(0);
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<scalar> dist(-1., 1.);
+
+    std::vector<__plugin::matrix<8, 6>> jacobians(n);
+    std::vector<__plugin::symmetric_matrix<6>> covariances(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        for (unsigned int r = 0; r < 8; ++r)
+        {
+            for (unsigned int c = 0; c < 6; ++c)
+            {
+                jacobians[i](r, c) = bound_to_free_pattern::is_unit(r, c)      ? 1.
+                                     : bound_to_free_pattern::is_nonzero(r, c) ? dist(generator)
+                                                                               : 0.;
+            }
+        }
+        for (unsigned int r = 0; r < 6; ++r)
+        {
+            for (unsigned int c = 0; c <= r; ++c)
+            {
+                covariances[i](r, c) = r == c ? 2. + dist(generator) : 0.1 * dist(generator);
+            }
+        }
+    }
+    std::vector<__plugin::symmetric_matrix<8>> results(n);
+
+    for (auto _ : state)
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            if constexpr (kSPARSE)
+            {
+                results[i] = matrix::similarity<bound_to_free_pattern>(jacobians[i], covariances[i]);
+            }
+            else
+            {
+                results[i] = matrix::similarity(jacobians[i], covariances[i]);
+            }
+        }
+        benchmark::DoNotOptimize(results.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK_TEMPLATE(BM_covariance_transport, false)->RangeMultiplier(10)->Range(1000, 100000);
+BENCHMARK_TEMPLATE(BM_covariance_transport, true)->RangeMultiplier(10)->Range(1000, 100000);
+
+// This benchmarks the global to local 2D projections
+template <typename projection_type>
+static void BM_projection(benchmark::State &state, const projection_type &projection)
+{
+    const std::size_t n = state.range(0);
+    const auto transforms = random_transforms(n);
+    const auto points = random_vectors(n);
+    std::vector<point2> results(n);
+
+    for (auto _ : state)
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            results[i] = projection(transforms[i], points[i]);
+        }
+        benchmark::DoNotOptimize(results.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK_CAPTURE(BM_projection, cartesian2, cartesian2)->RangeMultiplier(10)->Range(1000, 100000);
+BENCHMARK_CAPTURE(BM_projection, polar2, polar2)->RangeMultiplier(10)->Range(1000, 100000);
+BENCHMARK_CAPTURE(BM_projection, cylindrical2, cylindrical2)->RangeMultiplier(10)->Range(1000, 100000);
+
+// This benchmarks the batched global to local 2D projections with a single transform
+template <typename projection_type>
+static void BM_projection_batch(benchmark::State &state, const projection_type &projection)
+{
+    const std::size_t n = state.range(0);
+    const auto trf = random_transforms(1).front();
+    const auto points = random_vectors(n);
+    std::vector<point2> results(n);
+
+    for (auto _ : state)
+    {
+        projection(trf, points, results);
+        benchmark::DoNotOptimize(results.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK_CAPTURE(BM_projection_batch, cartesian2, cartesian2)->RangeMultiplier(10)->Range(1000, 100000);
+BENCHMARK_CAPTURE(BM_projection_batch, polar2, polar2)->RangeMultiplier(10)->Range(1000, 100000);
+BENCHMARK_CAPTURE(BM_projection_batch, cylindrical2, cylindrical2)->RangeMultiplier(10)->Range(1000, 100000);
+
+// This benchmarks the dot product
+static void BM_vector_dot(benchmark::State &state)
+{
+    const std::size_t n = state.range(0);
+    const auto as = random_vectors(n, 1);
+    const auto bs = random_vectors(n, 2);
+    std::vector<scalar> results(n);
+
+    for (auto _ : state)
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            results[i] = vector::dot(as[i], bs[i]);
+        }
+        benchmark::DoNotOptimize(results.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+ALGEBRA_BENCHMARK(BM_vector_dot);
+
+// This benchmarks the cross product
+static void BM_vector_cross(benchmark::State &state)
+{
+    const std::size_t n = state.range(0);
+    const auto as = random_vectors(n, 1);
+    const auto bs = random_vectors(n, 2);
+    std::vector<vector3> results(n);
+
+    for (auto _ : state)
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            results[i] = vector::cross(as[i], bs[i]);
+        }
+        benchmark::DoNotOptimize(results.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+ALGEBRA_BENCHMARK(BM_vector_cross);
+
+// This benchmarks the vector normalization
+static void BM_vector_normalize(benchmark::State &state)
+{
+    const std::size_t n = state.range(0);
+    const auto vectors = random_vectors(n);
+    std::vector<vector3> results(n);
+
+    for (auto _ : state)
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            results[i] = vector::normalize(vectors[i]);
+        }
+        benchmark::DoNotOptimize(results.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+ALGEBRA_BENCHMARK(BM_vector_normalize);
+
+// This benchmarks the getter functions
+#define ALGEBRA_GETTER_BENCHMARK(getter_name)                       \
+    static void BM_getter_##getter_name(benchmark::State &state)    \
+    {                                                               \
+        const std::size_t n = state.range(0);                       \
+        const auto vectors = random_vectors(n);                     \
+        std::vector<scalar> results(n);                             \
+                                                                    \
+        for (auto _ : state)                                        \
+        {                                                           \
+            for (std::size_t i = 0; i < n; ++i)                     \
+            {                                                       \
+                results[i] = getter::getter_name(vectors[i]);       \
+            }                                                       \
+            benchmark::DoNotOptimize(results.data());               \
+            benchmark::ClobberMemory();                             \
+        }                                                           \
+        state.SetItemsProcessed(state.iterations() * n);            \
+    }                                                               \
+    ALGEBRA_BENCHMARK(BM_getter_##getter_name);
+
+ALGEBRA_GETTER_BENCHMARK(phi)
+ALGEBRA_GETTER_BENCHMARK(theta)
+ALGEBRA_GETTER_BENCHMARK(eta)
+ALGEBRA_GETTER_BENCHMARK(perp)
+ALGEBRA_GETTER_BENCHMARK(norm)
+
+// This benchmarks the binning coordinates phi and eta with either accuracy of the elementary functions
+template <typename precision_t>
+static void BM_getter_phi_eta(benchmark::State &state)
+{
+    const std::size_t n = state.range(0);
+    const auto vectors = random_vectors(n);
+    std::vector<scalar> phis(n), etas(n);
+
+    for (auto _ : state)
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            phis[i] = getter::phi(vectors[i], precision_t{});
+            etas[i] = getter::eta(vectors[i], precision_t{});
+        }
+        benchmark::DoNotOptimize(phis.data());
+        benchmark::DoNotOptimize(etas.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+ALGEBRA_BENCHMARK(BM_getter_phi_eta<math::full_precision>);
+ALGEBRA_BENCHMARK(BM_getter_phi_eta<math::fast_precision>);
+
+// This benchmarks the five single getters on the same vectors
+static void BM_getter_all(benchmark::State &state)
+{
+    const std::size_t n = state.range(0);
+    const auto vectors = random_vectors(n);
+    std::vector<spherical_coordinates<scalar>> results(n);
+
+    for (auto _ : state)
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            const vector3 &v = vectors[i];
+            results[i] = {getter::phi(v), getter::theta(v), getter::eta(v), getter::perp(v), getter::norm(v)};
+        }
+        benchmark::DoNotOptimize(results.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+ALGEBRA_BENCHMARK(BM_getter_all);
+
+// This benchmarks the fused spherical coordinates getter
+template <typename precision_t>
+static void BM_getter_spherical(benchmark::State &state)
+{
+    const std::size_t n = state.range(0);
+    const auto vectors = random_vectors(n);
+    std::vector<spherical_coordinates<scalar>> results(n);
+
+    for (auto _ : state)
+    {
+        getter::spherical(vectors, results, precision_t{});
+        benchmark::DoNotOptimize(results.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+ALGEBRA_BENCHMARK(BM_getter_spherical<math::full_precision>);
+ALGEBRA_BENCHMARK(BM_getter_spherical<math::fast_precision>);
+
+BENCHMARK_MAIN();
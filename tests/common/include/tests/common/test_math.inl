@@ -0,0 +1,305 @@
+/** Algebra plugins library, part of the ACTS project
+ *
+ * (c) 2020 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#include "common/math.hpp"
+#include "common/types.hpp"
+
+#include <cmath>
+
+#include <gtest/gtest.h>
+
+/// @note __plugin has to be defined with a preprocessor command
+using namespace algebra;
+
+using vector3 = __plugin::vector3;
+
+// Bound of the fast approximations, including the rounding of float scalars
+constexpr scalar tolerance = 1e-6;
+
+// This tests the fast arc tangent against the standard library
+TEST(ALGEBRA_PLUGIN, math_atan2)
+{
+    for (scalar r : {1e-3, 1., 1e3})
+    {
+        for (int i = -180; i <= 180; ++i)
+        {
+            const scalar angle = i * 0.99 * M_PI / 180.;
+            const scalar y = r * std::sin(angle);
+            const scalar x = r * std::cos(angle);
+            ASSERT_NEAR(math::atan2(y, x, math::fast_precision{}), std::atan2(y, x), tolerance);
+            ASSERT_EQ(math::atan2(y, x, math::full_precision{}), std::atan2(y, x));
+        }
+    }
+
+    // Axes and origin
+    ASSERT_NEAR(math::atan2(scalar(0.), scalar(1.), math::fast_precision{}), 0., tolerance);
+    ASSERT_NEAR(math::atan2(scalar(1.), scalar(0.), math::fast_precision{}), M_PI_2, tolerance);
+    ASSERT_NEAR(math::atan2(scalar(0.), scalar(-1.), math::fast_precision{}), M_PI, tolerance);
+    ASSERT_NEAR(math::atan2(scalar(-1.), scalar(0.), math::fast_precision{}), -M_PI_2, tolerance);
+    ASSERT_EQ(math::atan2(scalar(0.), scalar(0.), math::fast_precision{}), 0.);
+}
+
+// This tests the fast inverse hyperbolic tangent against the standard library
+TEST(ALGEBRA_PLUGIN, math_atanh)
+{
+    for (int i = -999; i <= 999; ++i)
+    {
+        const scalar x = i * 1e-3;
+        const scalar ref = std::atanh(x);
+        ASSERT_NEAR(math::atanh(x, math::fast_precision{}), ref, tolerance * (1. + std::abs(ref)));
+        ASSERT_NEAR(math::atanh(x, math::full_precision{}), ref, tolerance);
+    }
+
+    ASSERT_TRUE(std::isinf(math::atanh(scalar(1.), math::fast_precision{})));
+    ASSERT_TRUE(std::isinf(math::atanh(scalar(-1.), math::fast_precision{})));
+}
+
+// This tests the square root and the inverse square root
+TEST(ALGEBRA_PLUGIN, math_sqrt)
+{
+    for (scalar x : {1e-6, 0.5, 1., 2., 3., 1e6})
+    {
+        ASSERT_NEAR(math::sqrt(x, math::fast_precision{}), std::sqrt(x), tolerance * std::sqrt(x));
+        ASSERT_NEAR(math::rsqrt(x, math::fast_precision{}), 1. / std::sqrt(x), tolerance / std::sqrt(x));
+        ASSERT_NEAR(math::rsqrt(x, math::full_precision{}), 1. / std::sqrt(x), tolerance / std::sqrt(x));
+    }
+}
+
+// This tests the fast sine and cosine against the standard library
+TEST(ALGEBRA_PLUGIN, math_sincos)
+{
+    for (int i = -1000; i <= 1000; ++i)
+    {
+        const scalar x = i * 0.0123;
+        scalar s = 0., c = 0.;
+        math::sincos(x, s, c, math::fast_precision{});
+        ASSERT_NEAR(s, std::sin(x), tolerance);
+        ASSERT_NEAR(c, std::cos(x), tolerance);
+
+        math::sincos(x, s, c, math::full_precision{});
+        ASSERT_NEAR(s, std::sin(x), tolerance);
+        ASSERT_NEAR(c, std::cos(x), tolerance);
+    }
+}
+
+// This tests the getters with an explicit precision
+TEST(ALGEBRA_PLUGIN, math_getters)
+{
+    for (int i = -20; i <= 20; ++i)
+    {
+        const vector3 v{scalar(1. + 0.1 * i), scalar(-0.5 * i), scalar(0.3 * i - 1.)};
+        ASSERT_NEAR(getter::phi(v, math::fast_precision{}), getter::phi(v, math::full_precision{}), tolerance);
+        ASSERT_NEAR(getter::theta(v, math::fast_precision{}), getter::theta(v, math::full_precision{}), tolerance);
+        ASSERT_NEAR(getter::eta(v, math::fast_precision{}), getter::eta(v, math::full_precision{}), tolerance);
+    }
+}
+
+namespace
+{
+    /** Check the inverse and the solution of a linear system against the identity, for a
+     *  diagonally dominant, i.e. positive definite, symmetric matrix
+     *
+     * @tparam kN the matrix size
+     **/
+    template <unsigned int kN>
+    void check_spd_matrix()
+    {
+        using matrix_type = __plugin::matrix<kN, kN>;
+        using vector_type = __plugin::matrix<kN, 1>;
+        constexpr scalar isclose = 1e-5;
+
+        matrix_type a;
+        vector_type b;
+        for (unsigned int r = 0; r < kN; ++r)
+        {
+            for (unsigned int c = 0; c < kN; ++c)
+            {
+                a(r, c) = r == c ? kN + 1. + r : 0.5 / (1. + r + c);
+            }
+            b(r, 0) = 1. + r;
+        }
+
+        const matrix_type a_inv = matrix::invert(a);
+        const vector_type x = matrix::solve(a, b);
+        for (unsigned int r = 0; r < kN; ++r)
+        {
+            scalar ax = 0.;
+            for (unsigned int c = 0; c < kN; ++c)
+            {
+                scalar aa_inv = 0.;
+                for (unsigned int k = 0; k < kN; ++k)
+                {
+                    aa_inv += a(r, k) * a_inv(k, c);
+                }
+                ASSERT_NEAR(aa_inv, r == c ? 1. : 0., isclose);
+                ax += a(r, c) * x(c, 0);
+            }
+            ASSERT_NEAR(ax, b(r, 0), isclose);
+        }
+    }
+} // namespace
+
+// This tests the inversion of the covariance sized matrices
+TEST(ALGEBRA_PLUGIN, matrix_invert)
+{
+    check_spd_matrix<1>();
+    check_spd_matrix<2>();
+    check_spd_matrix<3>();
+    check_spd_matrix<4>();
+    check_spd_matrix<5>();
+    check_spd_matrix<6>();
+}
+
+// This tests the covariance kernels of the symmetric matrices
+TEST(ALGEBRA_PLUGIN, symmetric_matrix)
+{
+    constexpr scalar isclose = 1e-4;
+
+    // Free to bound covariance transport
+    __plugin::matrix<6, 8> j;
+    for (unsigned int r = 0; r < 6; ++r)
+    {
+        for (unsigned int c = 0; c < 8; ++c)
+        {
+            j(r, c) = r == c ? 1. : 0.1 * (1. + r) / (1. + c);
+        }
+    }
+    __plugin::symmetric_matrix<8> cov;
+    for (unsigned int r = 0; r < 8; ++r)
+    {
+        // The lower triangle sets the matrix
+        for (unsigned int c = 0; c <= r; ++c)
+        {
+            cov(r, c) = r == c ? 9. + r : 0.5 / (1. + r + c);
+        }
+    }
+    ASSERT_EQ(cov(2, 5), cov(5, 2));
+
+    const __plugin::symmetric_matrix<6> bound = matrix::similarity(j, cov);
+    for (unsigned int r = 0; r < 6; ++r)
+    {
+        for (unsigned int c = 0; c < 6; ++c)
+        {
+            scalar expected = 0.;
+            for (unsigned int k = 0; k < 8; ++k)
+            {
+                for (unsigned int l = 0; l < 8; ++l)
+                {
+                    expected += j(r, k) * cov(k, l) * j(c, l);
+                }
+            }
+            ASSERT_NEAR(bound(r, c), expected, isclose);
+        }
+    }
+
+    const __plugin::symmetric_matrix<6> sum = bound + bound;
+    const __plugin::symmetric_matrix<8> cov_inv = matrix::invert(cov);
+    for (unsigned int r = 0; r < 8; ++r)
+    {
+        for (unsigned int c = 0; c < 8; ++c)
+        {
+            if (r < 6 and c < 6)
+            {
+                ASSERT_NEAR(sum(r, c), 2. * bound(r, c), isclose);
+            }
+            scalar cc_inv = 0.;
+            for (unsigned int k = 0; k < 8; ++k)
+            {
+                cc_inv += cov(r, k) * cov_inv(k, c);
+            }
+            ASSERT_NEAR(cc_inv, r == c ? 1. : 0., isclose);
+        }
+    }
+}
+
+namespace
+{
+    // Bound (loc0, loc1, phi, theta, q/p, t) to free (x, y, z, t, tx, ty, tz, q/p) Jacobian
+    using bound_to_free_pattern =
+        sparsity_pattern<8, 6,
+                         block_mask<8, 6>(0, 0, 3, 4) | block_mask<8, 6>(4, 2, 3, 2) | block_mask<8, 6>(3, 5) |
+                             block_mask<8, 6>(7, 4),
+                         block_mask<8, 6>(3, 5) | block_mask<8, 6>(7, 4)>;
+
+    // Free to bound Jacobian
+    using free_to_bound_pattern =
+        sparsity_pattern<6, 8,
+                         block_mask<6, 8>(0, 0, 2, 3) | block_mask<6, 8>(2, 4, 2, 3) | block_mask<6, 8>(4, 7) |
+                             block_mask<6, 8>(5, 3),
+                         block_mask<6, 8>(4, 7) | block_mask<6, 8>(5, 3)>;
+
+    /** A matrix that follows a sparsity pattern, with distinct non-zero elements
+     *
+     * @tparam pattern_t the sparsity pattern
+     **/
+    template <typename pattern_t>
+    __plugin::matrix<pattern_t::rows, pattern_t::cols> sparse_matrix()
+    {
+        __plugin::matrix<pattern_t::rows, pattern_t::cols> m;
+        for (unsigned int r = 0; r < pattern_t::rows; ++r)
+        {
+            for (unsigned int c = 0; c < pattern_t::cols; ++c)
+            {
+                m(r, c) = pattern_t::is_unit(r, c) ? 1.
+                          : pattern_t::is_nonzero(r, c) ? 0.5 + 0.1 * r - 0.2 * c
+                                                        : 0.;
+            }
+        }
+        return m;
+    }
+
+    /** A covariance with distinct elements
+     *
+     * @tparam kN the matrix size
+     **/
+    template <unsigned int kN>
+    __plugin::symmetric_matrix<kN> test_covariance()
+    {
+        __plugin::symmetric_matrix<kN> cov;
+        for (unsigned int r = 0; r < kN; ++r)
+        {
+            for (unsigned int c = 0; c <= r; ++c)
+            {
+                cov(r, c) = r == c ? 9. + r : 0.5 / (1. + r + c);
+            }
+        }
+        return cov;
+    }
+} // namespace
+
+// This tests the covariance transport with sparse Jacobians against the dense transport
+TEST(ALGEBRA_PLUGIN, sparse_similarity)
+{
+    constexpr scalar isclose = 1e-4;
+
+    ASSERT_EQ(bound_to_free_pattern::entries.size(), 18u);
+    ASSERT_EQ(bound_to_free_pattern::unit_entries.size(), 2u);
+
+    const auto bound_to_free = sparse_matrix<bound_to_free_pattern>();
+    const auto bound_cov = test_covariance<6>();
+    const __plugin::symmetric_matrix<8> free = matrix::similarity<bound_to_free_pattern>(bound_to_free, bound_cov);
+    const __plugin::symmetric_matrix<8> free_dense = matrix::similarity(bound_to_free, bound_cov);
+    for (unsigned int r = 0; r < 8; ++r)
+    {
+        for (unsigned int c = 0; c < 8; ++c)
+        {
+            ASSERT_NEAR(free(r, c), free_dense(r, c), isclose);
+        }
+    }
+
+    const auto free_to_bound = sparse_matrix<free_to_bound_pattern>();
+    const auto free_cov = test_covariance<8>();
+    const __plugin::symmetric_matrix<6> bound = matrix::similarity<free_to_bound_pattern>(free_to_bound, free_cov);
+    const __plugin::symmetric_matrix<6> bound_dense = matrix::similarity(free_to_bound, free_cov);
+    for (unsigned int r = 0; r < 6; ++r)
+    {
+        for (unsigned int c = 0; c < 6; ++c)
+        {
+            ASSERT_NEAR(bound(r, c), bound_dense(r, c), isclose);
+        }
+    }
+}
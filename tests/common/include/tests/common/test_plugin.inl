@@ -9,6 +9,8 @@
 
 #include <cmath>
 #include <climits>
+#include <type_traits>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -25,12 +27,20 @@ __plugin::cylindrical2 cylindrical2;
 
 // Three-dimensional definitions
 using transform3 = __plugin::transform3;
+using compact_transform3 = __plugin::compact_transform3;
 using vector3 = __plugin::vector3;
 using point3 = __plugin::point3;
 
 constexpr scalar epsilon = std::numeric_limits<scalar>::epsilon();
 constexpr scalar isclose = 1e-5;
 
+// The getters use bounded-error approximations with ALGEBRA_PLUGIN_FAST_MATH
+#ifdef ALGEBRA_PLUGIN_FAST_MATH
+constexpr scalar math_epsilon = 1e-6;
+#else
+constexpr scalar math_epsilon = epsilon;
+#endif
+
 // This defines the local frame test suite
 TEST(ALGEBRA_PLUGIN, local_vectors)
 {
@@ -57,7 +67,7 @@ TEST(ALGEBRA_PLUGIN, local_vectors)
     // Cast operations to phi, theta, eta, perp
     point2cart vD{1., 1.};
     scalar phi = getter::phi(vD);
-    ASSERT_NEAR(phi, M_PI_4, epsilon);
+    ASSERT_NEAR(phi, M_PI_4, math_epsilon);
 
     scalar perp = getter::perp(vD);
     ASSERT_NEAR(perp, std::sqrt(2.), epsilon);
@@ -100,10 +110,10 @@ TEST(ALGEBRA_PLUGIN, vector3)
     // Cast operations to phi, theta, eta, perp
     vector3 vD{1., 1., 1.};
     scalar phi = getter::phi(vD);
-    ASSERT_NEAR(phi, M_PI_4, epsilon);
+    ASSERT_NEAR(phi, M_PI_4, math_epsilon);
 
     scalar theta = getter::theta(vD);
-    ASSERT_NEAR(theta, std::atan2(std::sqrt(2.), 1.), epsilon);
+    ASSERT_NEAR(theta, std::atan2(std::sqrt(2.), 1.), math_epsilon);
 
     scalar eta = getter::eta(vD);
     ASSERT_NEAR(eta, 0.65847891569137573, isclose);
@@ -115,6 +125,40 @@ TEST(ALGEBRA_PLUGIN, vector3)
     ASSERT_NEAR(norm, std::sqrt(3.), epsilon);
 }
 
+// This tests the precision in which dot products and inversions are accumulated
+TEST(ALGEBRA_PLUGIN, accumulation_precision)
+{
+#ifdef ALGEBRA_PLUGIN_MIXED_PRECISION
+    static_assert(std::is_same_v<accumulator, double>, "Mixed precision accumulates in double");
+#else
+    static_assert(std::is_same_v<accumulator, scalar>, "The accumulator defaults to the scalar type");
+#endif
+
+    // The second product is lost in 1 + 1e-8 if the sum is taken in float
+    const vector3 a{1., 1., 1.};
+    const vector3 b{1., 1e-8, -1.};
+    const scalar d = vector::dot(a, b);
+    if constexpr (std::numeric_limits<accumulator>::epsilon() < 1e-8)
+    {
+        ASSERT_NEAR(d, scalar(1e-8), 1e-14);
+    }
+    else
+    {
+        ASSERT_NEAR(d, 0., 1e-7);
+    }
+
+    // Round trip through a transform far from the origin
+    vector3 z = vector::normalize(vector3{3., 2., 1.});
+    vector3 x = vector::normalize(vector3{2., -3., 0.});
+    transform3 trf(point3{1000., -2000., 500.}, z, x);
+    point3 lpoint = {0.5, -0.25, 0.};
+    auto lpoint_r = trf.point_to_local(trf.point_to_global(lpoint));
+    const scalar tolerance = 1e4 * epsilon;
+    ASSERT_NEAR(lpoint_r[0], lpoint[0], tolerance);
+    ASSERT_NEAR(lpoint_r[1], lpoint[1], tolerance);
+    ASSERT_NEAR(lpoint_r[2], lpoint[2], tolerance);
+}
+
 // This defines the vector operation test suite
 TEST(ALGEBRA_PLUGIN, getter)
 {
@@ -137,6 +181,41 @@ TEST(ALGEBRA_PLUGIN, getter)
     ASSERT_NEAR(vector::dot(z, x), 0., epsilon);
 }
 
+// This tests the fused spherical coordinates getter against the single getters
+TEST(ALGEBRA_PLUGIN, spherical_getter)
+{
+    std::vector<vector3> vectors;
+    for (int i = -5; i <= 5; ++i)
+    {
+        vectors.push_back(vector3{scalar(1. + 0.5 * i), scalar(-2. + i), scalar(0.7 * i)});
+    }
+
+    std::vector<spherical_coordinates<scalar>> results(vectors.size());
+    getter::spherical(vectors, results);
+
+    for (std::size_t i = 0; i < vectors.size(); ++i)
+    {
+        const vector3 &v = vectors[i];
+        const auto sph = getter::spherical(v);
+        ASSERT_NEAR(sph.phi, getter::phi(v), epsilon);
+        ASSERT_NEAR(sph.theta, getter::theta(v), epsilon);
+        ASSERT_NEAR(sph.eta, getter::eta(v), isclose);
+        ASSERT_NEAR(sph.perp, getter::perp(v), epsilon);
+        ASSERT_NEAR(sph.norm, getter::norm(v), isclose);
+
+        ASSERT_EQ(results[i].phi, sph.phi);
+        ASSERT_EQ(results[i].theta, sph.theta);
+        ASSERT_EQ(results[i].eta, sph.eta);
+        ASSERT_EQ(results[i].perp, sph.perp);
+        ASSERT_EQ(results[i].norm, sph.norm);
+    }
+
+    // Explicit accuracy
+    const auto sph = getter::spherical(vectors[0], math::fast_precision{});
+    ASSERT_NEAR(sph.phi, getter::phi(vectors[0]), 1e-6);
+    ASSERT_NEAR(sph.eta, getter::eta(vectors[0]), 1e-6);
+}
+
 // This defines the transform3 test suite
 TEST(ALGEBRA_PLUGIN, transform3)
 {
@@ -262,6 +341,444 @@ TEST(ALGEBRA_PLUGIN, global_transformations)
     ASSERT_NEAR(lvectorB[2], lvectorC[2], isclose);
 }
 
+// This test the inverse of transforms built from a matrix
+TEST(ALGEBRA_PLUGIN, inverse_transformations)
+{
+    // Preparatioon work
+    vector3 z = vector::normalize(vector3{3., 2., 1.});
+    vector3 x = vector::normalize(vector3{2., -3., 0.});
+    point3 t = {2., 3., 4.};
+    transform3 trf(t, z, x);
+    transform3 trfm(trf.matrix());
+
+    // A copy that is taken before the inverse is used, it may not be set up yet
+    transform3 trfc(trfm);
+
+    // Check a round trip for point with the matrix-constructed transform
+    point3 lpoint = {3., 4., 5.};
+    auto gpoint = trfm.point_to_global(lpoint);
+    auto lpoint_r = trfm.point_to_local(gpoint);
+    ASSERT_NEAR(lpoint[0], lpoint_r[0], isclose);
+    ASSERT_NEAR(lpoint[1], lpoint_r[1], isclose);
+    ASSERT_NEAR(lpoint[2], lpoint_r[2], isclose);
+
+    // Both transforms have the same inverse
+    auto lpoint_t = trf.point_to_local(gpoint);
+    ASSERT_NEAR(lpoint_t[0], lpoint_r[0], isclose);
+    ASSERT_NEAR(lpoint_t[1], lpoint_r[1], isclose);
+    ASSERT_NEAR(lpoint_t[2], lpoint_r[2], isclose);
+
+    auto lpoint_c = trfc.point_to_local(gpoint);
+    ASSERT_NEAR(lpoint_c[0], lpoint_r[0], isclose);
+    ASSERT_NEAR(lpoint_c[1], lpoint_r[1], isclose);
+    ASSERT_NEAR(lpoint_c[2], lpoint_r[2], isclose);
+
+    // Pure translation
+    transform3 ttrf(t);
+    auto lzero = ttrf.point_to_local(t);
+    ASSERT_NEAR(lzero[0], 0., isclose);
+    ASSERT_NEAR(lzero[1], 0., isclose);
+    ASSERT_NEAR(lzero[2], 0., isclose);
+
+#ifdef ALGEBRA_PLUGIN_VALIDATE_ISOMETRY
+    // A scaled and sheared matrix falls back to the general inverse:
+    // x = 2 u + v + 1, y = 4 v + 2, z = w / 2 + 3
+    const array_s<scalar, 16> ma = {2., 1., 0., 1.,
+                                    0., 4., 0., 2.,
+                                    0., 0., 0.5, 3.,
+                                    0., 0., 0., 1.};
+    transform3 gtrf(ma);
+    auto glocal = gtrf.point_to_local(point3{3., 6., 4.});
+    ASSERT_NEAR(glocal[0], 0.5, isclose);
+    ASSERT_NEAR(glocal[1], 1., isclose);
+    ASSERT_NEAR(glocal[2], 2., isclose);
+    auto gvlocal = gtrf.vector_to_local(vector3{2., 4., 1.});
+    ASSERT_NEAR(gvlocal[0], 0.5, isclose);
+    ASSERT_NEAR(gvlocal[1], 1., isclose);
+    ASSERT_NEAR(gvlocal[2], 2., isclose);
+#endif
+}
+
+// This tests the composition of transforms
+TEST(ALGEBRA_PLUGIN, transform_composition)
+{
+    vector3 z1 = vector::normalize(vector3{3., 2., 1.});
+    vector3 x1 = vector::normalize(vector3{2., -3., 0.});
+    transform3 trf1(point3{2., 3., 4.}, z1, x1);
+
+    vector3 z2 = vector::normalize(vector3{-1., 0.5, 2.});
+    vector3 x2 = vector::normalize(vector::cross(z2, vector3{0., 1., 0.}));
+    transform3 trf2(point3{-5., 1., 0.5}, z2, x2);
+
+    point3 lpoint = {3., 4., 5.};
+
+    // trf2 is applied first
+    transform3 trf12 = trf1 * trf2;
+    auto gpoint = trf12.point_to_global(lpoint);
+    auto gpoint_c = trf1.point_to_global(trf2.point_to_global(lpoint));
+    ASSERT_NEAR(gpoint[0], gpoint_c[0], isclose);
+    ASSERT_NEAR(gpoint[1], gpoint_c[1], isclose);
+    ASSERT_NEAR(gpoint[2], gpoint_c[2], isclose);
+
+    // The inverse is derived from the inverses of the factors
+    auto lpoint_r = trf12.point_to_local(gpoint);
+    ASSERT_NEAR(lpoint_r[0], lpoint[0], isclose);
+    ASSERT_NEAR(lpoint_r[1], lpoint[1], isclose);
+    ASSERT_NEAR(lpoint_r[2], lpoint[2], isclose);
+
+    vector3 gvector = trf12.vector_to_global(lpoint);
+    vector3 lvector = trf12.vector_to_local(gvector);
+    ASSERT_NEAR(lvector[0], lpoint[0], isclose);
+    ASSERT_NEAR(lvector[1], lpoint[1], isclose);
+    ASSERT_NEAR(lvector[2], lpoint[2], isclose);
+
+    // The relative placement of trf2 within trf1 is recovered
+    transform3 trf2_r = trf1.compose_inverse(trf12);
+    auto gpoint2 = trf2.point_to_global(lpoint);
+    auto gpoint2_r = trf2_r.point_to_global(lpoint);
+    ASSERT_NEAR(gpoint2_r[0], gpoint2[0], isclose);
+    ASSERT_NEAR(gpoint2_r[1], gpoint2[1], isclose);
+    ASSERT_NEAR(gpoint2_r[2], gpoint2[2], isclose);
+
+    auto lpoint2_r = trf2_r.point_to_local(gpoint2);
+    ASSERT_NEAR(lpoint2_r[0], lpoint[0], isclose);
+    ASSERT_NEAR(lpoint2_r[1], lpoint[1], isclose);
+    ASSERT_NEAR(lpoint2_r[2], lpoint[2], isclose);
+
+    // Composition with the identity
+    transform3 trf1_i = trf1 * transform3();
+    auto gpoint1 = trf1_i.point_to_global(lpoint);
+    auto gpoint1_c = trf1.point_to_global(lpoint);
+    ASSERT_NEAR(gpoint1[0], gpoint1_c[0], isclose);
+    ASSERT_NEAR(gpoint1[1], gpoint1_c[1], isclose);
+    ASSERT_NEAR(gpoint1[2], gpoint1_c[2], isclose);
+}
+
+// This tests the alignment corrections of a transform
+TEST(ALGEBRA_PLUGIN, alignment_delta)
+{
+    vector3 z = vector::normalize(vector3{3., 2., 1.});
+    vector3 x = vector::normalize(vector3{2., -3., 0.});
+    transform3 trf(point3{2., 3., 4.}, z, x);
+
+    // Rotation about the local z axis and a shift
+    const scalar angle = 0.01;
+    const vector3 dt{0.1, -0.2, 0.05};
+    transform3 atrf = trf;
+    atrf.apply_delta(vector3{0., 0., angle}, dt);
+
+    const point3 lpoint = {1., 0., 0.};
+    const point3 cpoint = {std::cos(angle) + dt[0], std::sin(angle) + dt[1], dt[2]};
+    auto gpoint = atrf.point_to_global(lpoint);
+    auto gpoint_c = trf.point_to_global(cpoint);
+    ASSERT_NEAR(gpoint[0], gpoint_c[0], isclose);
+    ASSERT_NEAR(gpoint[1], gpoint_c[1], isclose);
+    ASSERT_NEAR(gpoint[2], gpoint_c[2], isclose);
+
+    // The updated inverse matches a recomputed one
+    transform3 rtrf(atrf.matrix());
+    const point3 gtest = {-1., 5., 2.5};
+    auto lpoint_a = atrf.point_to_local(gtest);
+    auto lpoint_r = rtrf.point_to_local(gtest);
+    ASSERT_NEAR(lpoint_a[0], lpoint_r[0], isclose);
+    ASSERT_NEAR(lpoint_a[1], lpoint_r[1], isclose);
+    ASSERT_NEAR(lpoint_a[2], lpoint_r[2], isclose);
+
+    // A vanishing correction keeps the transform
+    transform3 ntrf = trf;
+    ntrf.apply_delta(vector3{0., 0., 0.}, vector3{0., 0., 0.});
+    auto npoint = ntrf.point_to_local(gtest);
+    auto tpoint = trf.point_to_local(gtest);
+    ASSERT_NEAR(npoint[0], tpoint[0], isclose);
+    ASSERT_NEAR(npoint[1], tpoint[1], isclose);
+    ASSERT_NEAR(npoint[2], tpoint[2], isclose);
+
+    // The rotation is orthonormal for large and tiny rotation vectors
+    for (scalar scale : {1., 1e-4})
+    {
+        const auto r = rotation_matrix<scalar>(0.3 * scale, -1.2 * scale, 0.7 * scale);
+        for (unsigned int a = 0; a < 3; ++a)
+        {
+            for (unsigned int b = 0; b < 3; ++b)
+            {
+                const scalar d = r[3 * a] * r[3 * b] + r[3 * a + 1] * r[3 * b + 1] + r[3 * a + 2] * r[3 * b + 2];
+                ASSERT_NEAR(d, a == b ? 1. : 0., isclose);
+            }
+        }
+    }
+}
+
+// This tests the kind of a transform and the kernels of the special kinds
+TEST(ALGEBRA_PLUGIN, transform_kinds)
+{
+    const point3 t = {2., -3., 4.};
+    const transform3 itrf;
+    const transform3 ttrf(t);
+    const transform3 atrf(t, vector3{0., 0., -1.}, vector3{1., 0., 0.});
+    const transform3 gtrf(t, vector::normalize(vector3{3., 2., 1.}), vector::normalize(vector3{2., -3., 0.}));
+
+    ASSERT_EQ(itrf.kind(), transform_kind::identity);
+    ASSERT_EQ(transform3(vector3{0., 0., 0.}).kind(), transform_kind::identity);
+    ASSERT_EQ(ttrf.kind(), transform_kind::translation);
+    ASSERT_EQ(atrf.kind(), transform_kind::axis_aligned);
+    ASSERT_EQ(gtrf.kind(), transform_kind::general);
+
+    // The kind is kept through construction from the matrix and through composition
+    ASSERT_EQ(transform3(ttrf.matrix()).kind(), transform_kind::translation);
+    ASSERT_EQ((ttrf * ttrf).kind(), transform_kind::translation);
+    ASSERT_EQ((ttrf * atrf).kind(), transform_kind::axis_aligned);
+    ASSERT_EQ((atrf * atrf).kind(), transform_kind::translation);
+    ASSERT_EQ((gtrf * ttrf).kind(), transform_kind::general);
+
+    // The kernels of the special kinds agree with the general one
+    const point3 p = {1., -7., 0.5};
+    const vector3 v = {-0.3, 0.4, 1.2};
+    for (const transform3 *trf : {&itrf, &ttrf, &atrf, &gtrf})
+    {
+        const point3 g = trf->point_to_global(p);
+        const point3 g_ref = trf->point_to_global<transform_kind::general>(p);
+        const point3 l = trf->point_to_local(p);
+        const point3 l_ref = trf->point_to_local<transform_kind::general>(p);
+        const vector3 vg = trf->vector_to_global(v);
+        const vector3 vg_ref = trf->vector_to_global<transform_kind::general>(v);
+        const vector3 vl = trf->vector_to_local(v);
+        const vector3 vl_ref = trf->vector_to_local<transform_kind::general>(v);
+        for (unsigned int i = 0; i < 3; ++i)
+        {
+            ASSERT_NEAR(g[i], g_ref[i], isclose);
+            ASSERT_NEAR(l[i], l_ref[i], isclose);
+            ASSERT_NEAR(vg[i], vg_ref[i], isclose);
+            ASSERT_NEAR(vl[i], vl_ref[i], isclose);
+        }
+        const auto l2 = trf->point_to_local2(p);
+        ASSERT_NEAR(l2[0], l_ref[0], isclose);
+        ASSERT_NEAR(l2[1], l_ref[1], isclose);
+
+        // The batched transformations dispatch once for all points
+        std::vector<point3> points = {p, p, p};
+        std::vector<point3> results(points.size());
+        trf->point_to_local(points, results);
+        for (const point3 &r : results)
+        {
+            ASSERT_NEAR(r[0], l_ref[0], isclose);
+            ASSERT_NEAR(r[1], l_ref[1], isclose);
+            ASSERT_NEAR(r[2], l_ref[2], isclose);
+        }
+    }
+
+    // Static dispatch with the known kind
+    const point3 tg = ttrf.point_to_global<transform_kind::translation>(p);
+    ASSERT_NEAR(tg[0], p[0] + t[0], epsilon);
+    ASSERT_NEAR(tg[1], p[1] + t[1], epsilon);
+    ASSERT_NEAR(tg[2], p[2] + t[2], epsilon);
+    const point3 al = atrf.point_to_local<transform_kind::axis_aligned>(p);
+    ASSERT_NEAR(al[0], p[0] - t[0], isclose);
+    ASSERT_NEAR(al[1], t[1] - p[1], isclose);
+    ASSERT_NEAR(al[2], t[2] - p[2], isclose);
+    const auto il2 = itrf.point_to_local2<transform_kind::identity>(p);
+    ASSERT_EQ(il2[0], p[0]);
+    ASSERT_EQ(il2[1], p[1]);
+}
+
+// This tests the quaternion rotations and the transforms built from them
+TEST(ALGEBRA_PLUGIN, quaternion_transformations)
+{
+    using quaternion = __plugin::quaternion;
+
+    const vector3 axis = vector::normalize(vector3{1., -2., 0.5});
+    const scalar angle = 0.7;
+    const quaternion q = quaternion::from_axis_angle(axis, angle);
+    const point3 t = {2., -3., 4.};
+
+    // Same rotation matrix as the rotation vector along the axis
+    const auto r = q.rotation_matrix();
+    const auto r_ref = rotation_matrix<scalar>(angle * axis[0], angle * axis[1], angle * axis[2]);
+    for (unsigned int i = 0; i < 9; ++i)
+    {
+        ASSERT_NEAR(r[i], r_ref[i], isclose);
+    }
+
+    // The round trip through the matrix gives the same rotation
+    const quaternion q_r = quaternion::from_rotation_matrix(r);
+    ASSERT_NEAR(std::abs(q_r.w * q.w + q_r.x * q.x + q_r.y * q.y + q_r.z * q.z), 1., isclose);
+
+    // The transform from the quaternion agrees with the one from the frame axes
+    const transform3 trf(t, q);
+    const transform3 trf_ref(t, vector3{r[6], r[7], r[8]}, vector3{r[0], r[1], r[2]});
+    const point3 p = {1., -7., 0.5};
+    const point3 g = trf.point_to_global(p);
+    const point3 g_ref = trf_ref.point_to_global(p);
+    const point3 l = trf.point_to_local(p);
+    const point3 l_ref = trf_ref.point_to_local(p);
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+        ASSERT_NEAR(g[i], g_ref[i], isclose);
+        ASSERT_NEAR(l[i], l_ref[i], isclose);
+    }
+    ASSERT_EQ(transform3(t, quaternion{}).kind(), transform_kind::translation);
+
+    // The quaternion transform applies points without a rotation matrix
+    const __plugin::quaternion_transform3 qtrf(t, q);
+    const point3 qg = qtrf.point_to_global(p);
+    const point3 ql = qtrf.point_to_local(qg);
+    const vector3 qv = qtrf.vector_to_local(qtrf.vector_to_global(p));
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+        ASSERT_NEAR(qg[i], g_ref[i], isclose);
+        ASSERT_NEAR(ql[i], p[i], isclose);
+        ASSERT_NEAR(qv[i], p[i], isclose);
+    }
+
+    // Composition matches the composition of the matrices
+    const quaternion q2 = quaternion::from_axis_angle(vector::normalize(vector3{0., 1., 1.}), -1.3);
+    const point3 t2 = {-1., 0.5, 2.};
+    const point3 cg = (qtrf * __plugin::quaternion_transform3(t2, q2)).point_to_global(p);
+    const point3 cg_ref = (trf * transform3(t2, q2)).point_to_global(p);
+    const point3 il = qtrf.inverse().point_to_global(p);
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+        ASSERT_NEAR(cg[i], cg_ref[i], isclose);
+        ASSERT_NEAR(il[i], l_ref[i], isclose);
+    }
+
+    // Interpolation: the end points and half the angle in the middle
+    const quaternion s0 = slerp(quaternion{}, q, scalar(0.));
+    const quaternion s1 = slerp(quaternion{}, q, scalar(1.));
+    const quaternion sh = slerp(quaternion{}, q, scalar(0.5));
+    const quaternion qh = quaternion::from_axis_angle(axis, 0.5 * angle);
+    ASSERT_NEAR(s0.w, 1., isclose);
+    ASSERT_NEAR(s1.w, q.w, isclose);
+    ASSERT_NEAR(s1.x, q.x, isclose);
+    ASSERT_NEAR(sh.w, qh.w, isclose);
+    ASSERT_NEAR(sh.x, qh.x, isclose);
+    ASSERT_NEAR(sh.y, qh.y, isclose);
+    ASSERT_NEAR(sh.z, qh.z, isclose);
+}
+
+// This test the compact transform against the full transform
+TEST(ALGEBRA_PLUGIN, compact_transformations)
+{
+    // Preparatioon work
+    vector3 z = vector::normalize(vector3{3., 2., 1.});
+    vector3 x = vector::normalize(vector3{2., -3., 0.});
+    point3 t = {2., 3., 4.};
+    transform3 trf(t, z, x);
+    compact_transform3 ctrf(t, z, x);
+
+    ASSERT_TRUE(ctrf == ctrf);
+    ASSERT_TRUE(ctrf == compact_transform3(trf));
+    ASSERT_TRUE(ctrf == compact_transform3(ctrf.matrix()));
+    ASSERT_LT(sizeof(compact_transform3), sizeof(transform3));
+
+    auto trn = ctrf.translation();
+    ASSERT_NEAR(trn[0], 2., epsilon);
+    ASSERT_NEAR(trn[1], 3., epsilon);
+    ASSERT_NEAR(trn[2], 4., epsilon);
+
+    // Check points and vectors in both directions
+    point3 lpoint = {3., 4., 5.};
+    auto gpoint = trf.point_to_global(lpoint);
+    auto cgpoint = ctrf.point_to_global(lpoint);
+    auto clpoint = ctrf.point_to_local(gpoint);
+    auto cgvector = ctrf.vector_to_global(lpoint);
+    auto clvector = ctrf.vector_to_local(lpoint);
+    auto lvector = trf.vector_to_local(lpoint);
+    auto gvector = trf.vector_to_global(lpoint);
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+        ASSERT_NEAR(cgpoint[i], gpoint[i], isclose);
+        ASSERT_NEAR(clpoint[i], lpoint[i], isclose);
+        ASSERT_NEAR(cgvector[i], gvector[i], isclose);
+        ASSERT_NEAR(clvector[i], lvector[i], isclose);
+    }
+
+    // Check the projections
+    auto p2 = cartesian2(trf, gpoint);
+    auto cp2 = cartesian2(ctrf, gpoint);
+    ASSERT_NEAR(p2[0], cp2[0], isclose);
+    ASSERT_NEAR(p2[1], cp2[1], isclose);
+
+    // Check the batched transforms
+    std::vector<point3> points = {point3{3., 4., 5.}, point3{-1., 0.5, 2.}};
+    std::vector<point3> gpoints(points.size()), lpoints(points.size());
+    ctrf.point_to_global(points, gpoints);
+    ctrf.point_to_local(gpoints, lpoints);
+    for (std::size_t i = 0; i < points.size(); ++i)
+    {
+        point3 gp = trf.point_to_global(points[i]);
+        for (unsigned int j = 0; j < 3; ++j)
+        {
+            ASSERT_NEAR(gpoints[i][j], gp[j], isclose);
+            ASSERT_NEAR(lpoints[i][j], points[i][j], isclose);
+        }
+    }
+
+    // Construction from a translation and from an array[16]
+    compact_transform3 ttrf(t);
+    auto lzero = ttrf.point_to_local(t);
+    ASSERT_NEAR(lzero[0], 0., isclose);
+    ASSERT_NEAR(lzero[1], 0., isclose);
+    ASSERT_NEAR(lzero[2], 0., isclose);
+
+    array_s<scalar, 16> matray = {1, 0, 0, 2, 0, 1, 0, 3, 0, 0, 1, 4, 0, 0, 0, 1};
+    ASSERT_TRUE(compact_transform3(matray) == ttrf);
+}
+
+// This test batched coordinate transforms
+TEST(ALGEBRA_PLUGIN, batched_transformations)
+{
+    // Preparatioon work
+    vector3 z = vector::normalize(vector3{3., 2., 1.});
+    vector3 x = vector::normalize(vector3{2., -3., 0.});
+    point3 t = {2., 3., 4.};
+    transform3 trf(t, z, x);
+
+    std::vector<point3> points = {point3{3., 4., 5.}, point3{-1., 0.5, 2.},
+                                  point3{0., 0., 0.}, point3{7., -8., 9.}};
+
+    // Check the batched point transforms against the single point ones
+    std::vector<point3> gpoints(points.size());
+    trf.point_to_global(points, gpoints);
+    for (std::size_t i = 0; i < points.size(); ++i)
+    {
+        point3 gpoint = trf.point_to_global(points[i]);
+        ASSERT_NEAR(gpoints[i][0], gpoint[0], isclose);
+        ASSERT_NEAR(gpoints[i][1], gpoint[1], isclose);
+        ASSERT_NEAR(gpoints[i][2], gpoint[2], isclose);
+    }
+
+    // Check a round trip for the points
+    std::vector<point3> lpoints(points.size());
+    trf.point_to_local(gpoints, lpoints);
+    for (std::size_t i = 0; i < points.size(); ++i)
+    {
+        ASSERT_NEAR(lpoints[i][0], points[i][0], isclose);
+        ASSERT_NEAR(lpoints[i][1], points[i][1], isclose);
+        ASSERT_NEAR(lpoints[i][2], points[i][2], isclose);
+    }
+
+    // Check the batched vector transforms against the single vector ones
+    std::vector<vector3> gvectors(points.size());
+    trf.vector_to_global(points, gvectors);
+    for (std::size_t i = 0; i < points.size(); ++i)
+    {
+        vector3 gvector = trf.vector_to_global(points[i]);
+        ASSERT_NEAR(gvectors[i][0], gvector[0], isclose);
+        ASSERT_NEAR(gvectors[i][1], gvector[1], isclose);
+        ASSERT_NEAR(gvectors[i][2], gvector[2], isclose);
+    }
+
+    // Check a round trip for the vectors
+    std::vector<vector3> lvectors(points.size());
+    trf.vector_to_local(gvectors, lvectors);
+    for (std::size_t i = 0; i < points.size(); ++i)
+    {
+        ASSERT_NEAR(lvectors[i][0], points[i][0], isclose);
+        ASSERT_NEAR(lvectors[i][1], points[i][1], isclose);
+        ASSERT_NEAR(lvectors[i][2], points[i][2], isclose);
+    }
+}
+
 // This test local coordinate transforms
 TEST(ALGEBRA_PLUGIN, local_transformations)
 {
@@ -284,6 +801,93 @@ TEST(ALGEBRA_PLUGIN, local_transformations)
     ASSERT_NEAR(polfrom2[1], polfrom3[1], epsilon);
 }
 
+// This tests the fused global to local 2D projections against the full local transformation
+TEST(ALGEBRA_PLUGIN, global_to_local2_projections)
+{
+    vector3 z = vector::normalize(vector3{3., 2., 1.});
+    vector3 x = vector::normalize(vector3{2., -3., 0.});
+    point3 t = {2., 3., 4.};
+    transform3 trf(t, z, x);
+    compact_transform3 ctrf(trf);
+
+    std::vector<point3> points;
+    for (int i = -5; i <= 5; ++i)
+    {
+        points.push_back(point3{scalar(1. + i), scalar(2. - 0.5 * i), scalar(0.3 * i)});
+    }
+
+    std::vector<point2cart> carts(points.size()), ccarts(points.size());
+    std::vector<point2pol> pols(points.size());
+    std::vector<point2cyl> cyls(points.size());
+    cartesian2(trf, points, carts);
+    cartesian2(ctrf, points, ccarts);
+    polar2(trf, points, pols);
+    cylindrical2(ctrf, points, cyls);
+
+    for (std::size_t i = 0; i < points.size(); ++i)
+    {
+        const point3 local = trf.point_to_local(points[i]);
+        const point2cart cart = cartesian2(local);
+        const point2pol pol = polar2(local);
+        const point2cyl cyl = cylindrical2(local);
+
+        const point2cart cart2 = cartesian2(trf, points[i]);
+        const point2cart ccart2 = cartesian2(ctrf, points[i]);
+        const point2pol pol2 = polar2(ctrf, points[i]);
+        for (unsigned int j = 0; j < 2; ++j)
+        {
+            ASSERT_NEAR(cart2[j], cart[j], isclose);
+            ASSERT_NEAR(ccart2[j], cart[j], isclose);
+            ASSERT_NEAR(pol2[j], pol[j], isclose);
+            ASSERT_NEAR(carts[i][j], cart[j], isclose);
+            ASSERT_NEAR(ccarts[i][j], cart[j], isclose);
+            ASSERT_NEAR(pols[i][j], pol[j], isclose);
+            ASSERT_NEAR(cyls[i][j], cyl[j], isclose);
+        }
+    }
+}
+
+// This tests the range projections against the single point projections for every transform kind
+TEST(ALGEBRA_PLUGIN, range_projections_kinds)
+{
+    const point3 t = {2., -3., 4.};
+    const std::vector<transform3> transforms = {
+        transform3(), transform3(t), transform3(t, vector3{0., 0., -1.}, vector3{1., 0., 0.}),
+        transform3(t, vector::normalize(vector3{3., 2., 1.}), vector::normalize(vector3{2., -3., 0.}))};
+
+    std::vector<point3> points;
+    for (int i = -5; i <= 5; ++i)
+    {
+        points.push_back(point3{scalar(1. + i), scalar(2. - 0.5 * i), scalar(0.3 * i)});
+    }
+
+    for (std::size_t k = 0; k < transforms.size(); ++k)
+    {
+        const transform3 &trf = transforms[k];
+        ASSERT_EQ(trf.kind(), static_cast<transform_kind>(k));
+
+        std::vector<point2cart> carts(points.size());
+        std::vector<point2pol> pols(points.size());
+        std::vector<point2cyl> cyls(points.size());
+        cartesian2(trf, points, carts);
+        polar2(trf, points, pols);
+        cylindrical2(trf, points, cyls);
+
+        for (std::size_t i = 0; i < points.size(); ++i)
+        {
+            const point2cart cart = cartesian2(trf, points[i]);
+            const point2pol pol = polar2(trf, points[i]);
+            const point2cyl cyl = cylindrical2(trf, points[i]);
+            for (unsigned int j = 0; j < 2; ++j)
+            {
+                ASSERT_NEAR(carts[i][j], cart[j], isclose);
+                ASSERT_NEAR(pols[i][j], pol[j], isclose);
+                ASSERT_NEAR(cyls[i][j], cyl[j], isclose);
+            }
+        }
+    }
+}
+
 
 int main(int argc, char **argv)
 {
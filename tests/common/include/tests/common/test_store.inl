@@ -0,0 +1,415 @@
+/** Algebra plugins library, part of the ACTS project
+ *
+ * (c) 2020 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#include "common/types.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+/// @note __plugin has to be defined with a preprocessor command
+using namespace algebra;
+
+// Three-dimensional definitions
+using transform3 = __plugin::transform3;
+using compact_transform3 = __plugin::compact_transform3;
+using vector3 = __plugin::vector3;
+using point3 = __plugin::point3;
+
+constexpr scalar isclose = 1e-5;
+
+namespace
+{
+    /** A set of distinct transforms
+     *
+     * @param n the number of transforms
+     **/
+    std::vector<transform3> test_transforms(std::size_t n)
+    {
+        std::vector<transform3> transforms;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            vector3 z = vector::normalize(vector3{3., 2., scalar(1. + i)});
+            vector3 x = vector::normalize(vector::cross(z, vector3{scalar(0.5 * i), -3., 1.}));
+            point3 t = {scalar(2. * i), 3., scalar(4. - i)};
+            transforms.push_back(transform3(t, z, x));
+        }
+        return transforms;
+    }
+
+    /** Check the batched kernels of a store against the transforms they were filled with */
+    template <typename store_type, typename transform_type>
+    void check_store(const store_type &store, const std::vector<transform_type> &transforms)
+    {
+        ASSERT_EQ(store.size(), transforms.size());
+
+        // Gather pattern: every point is transformed with a different transform
+        std::vector<std::size_t> indices = {3, 0, 0, 2, 4, 1, 3, 2, 4, 4, 0, 1};
+        std::vector<point3> points;
+        for (std::size_t i = 0; i < indices.size(); ++i)
+        {
+            points.push_back(point3{scalar(1. + i), scalar(2. - 0.5 * i), scalar(0.25 * i)});
+        }
+
+        std::vector<point3> gpoints(points.size()), lpoints(points.size());
+        std::vector<vector3> gvectors(points.size()), lvectors(points.size());
+        store.point_to_global(indices, points, gpoints);
+        store.point_to_local(indices, gpoints, lpoints);
+        store.vector_to_global(indices, points, gvectors);
+        store.vector_to_local(indices, gvectors, lvectors);
+
+        for (std::size_t i = 0; i < indices.size(); ++i)
+        {
+            const auto &trf = transforms[indices[i]];
+            const point3 gpoint = trf.point_to_global(points[i]);
+            const vector3 gvector = trf.vector_to_global(points[i]);
+            for (unsigned int j = 0; j < 3; ++j)
+            {
+                ASSERT_NEAR(gpoints[i][j], gpoint[j], isclose);
+                ASSERT_NEAR(lpoints[i][j], points[i][j], isclose);
+                ASSERT_NEAR(gvectors[i][j], gvector[j], isclose);
+                ASSERT_NEAR(lvectors[i][j], points[i][j], isclose);
+            }
+        }
+
+        // Access by index
+        for (std::size_t i = 0; i < store.size(); ++i)
+        {
+            store.prefetch(i);
+            const point3 &point = points[i % points.size()];
+            const point3 p = store[i].point_to_local(point);
+            const point3 q = transforms[i].point_to_local(point);
+            ASSERT_NEAR(p[0], q[0], isclose);
+            ASSERT_NEAR(p[1], q[1], isclose);
+            ASSERT_NEAR(p[2], q[2], isclose);
+        }
+    }
+} // namespace
+
+// This tests the array of structures transform store
+TEST(ALGEBRA_PLUGIN, transform_store_aos)
+{
+    const auto transforms = test_transforms(5);
+
+    __plugin::transform_store<aos_layout> store;
+    store.reserve(transforms.size());
+    for (const auto &trf : transforms)
+    {
+        store.push_back(trf);
+    }
+    check_store(store, transforms);
+    ASSERT_THROW(store.at(transforms.size()), std::out_of_range);
+
+    // The transforms start on a cache line
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(&store[0]) % cache_line_size, 0u);
+
+    // In-place construction returns the index
+    ASSERT_EQ(store.emplace_back(point3{1., 2., 3.}), transforms.size());
+    store.clear();
+    ASSERT_TRUE(store.empty());
+}
+
+// This tests the structure of arrays transform store
+TEST(ALGEBRA_PLUGIN, transform_store_soa)
+{
+    const auto transforms = test_transforms(5);
+
+    __plugin::transform_store<soa_layout> store;
+    for (const auto &trf : transforms)
+    {
+        store.push_back(trf);
+    }
+    check_store(store, transforms);
+    ASSERT_THROW(store.at(transforms.size()), std::out_of_range);
+
+    // The component arrays start on a cache line
+    for (const auto &component : store._components)
+    {
+        ASSERT_EQ(reinterpret_cast<std::uintptr_t>(component.data()) % cache_line_size, 0u);
+    }
+}
+
+// This tests a store of compact transforms
+TEST(ALGEBRA_PLUGIN, transform_store_compact)
+{
+    const auto transforms = test_transforms(5);
+    std::vector<compact_transform3> compact_transforms(transforms.begin(), transforms.end());
+
+    algebra::transform_store<compact_transform3, vector3, aos_layout> store;
+    algebra::transform_store<compact_transform3, vector3, soa_layout> soa_store;
+    for (const auto &trf : compact_transforms)
+    {
+        store.push_back(trf);
+        soa_store.push_back(trf);
+    }
+    check_store(store, compact_transforms);
+    check_store(soa_store, compact_transforms);
+}
+
+// This tests the batched alignment corrections
+TEST(ALGEBRA_PLUGIN, transform_store_apply_delta)
+{
+    auto transforms = test_transforms(5);
+
+    __plugin::transform_store<aos_layout> store;
+    __plugin::transform_store<soa_layout> soa_store;
+    for (const auto &trf : transforms)
+    {
+        store.push_back(trf);
+        soa_store.push_back(trf);
+    }
+
+    const std::vector<std::size_t> indices = {4, 1, 2};
+    std::vector<vector3> rotation_deltas, translation_deltas;
+    for (std::size_t i = 0; i < indices.size(); ++i)
+    {
+        rotation_deltas.push_back(vector3{scalar(1e-3 * i), -2e-3, scalar(0.5e-3 * i)});
+        translation_deltas.push_back(vector3{0.1, scalar(0.2 * i), -0.3});
+        transforms[indices[i]].apply_delta(rotation_deltas[i], translation_deltas[i]);
+    }
+    store.apply_delta(indices, rotation_deltas, translation_deltas);
+    soa_store.apply_delta(indices, rotation_deltas, translation_deltas);
+
+    check_store(store, transforms);
+    check_store(soa_store, transforms);
+}
+
+// This tests the bulk construction from a buffer of matrices
+TEST(ALGEBRA_PLUGIN, transform_store_append)
+{
+    // More transforms than fit into the blocks of the batched inversion
+    const auto transforms = test_transforms(19);
+
+    // The row major matrices of the transforms, with and without the last row
+    __plugin::transform_store<soa_layout> reference;
+    for (const auto &trf : transforms)
+    {
+        reference.push_back(trf);
+    }
+    std::vector<scalar> buffer16, buffer12;
+    for (std::size_t i = 0; i < reference.size(); ++i)
+    {
+        const auto ma = reference.matrix(i);
+        buffer16.insert(buffer16.end(), ma.begin(), ma.end());
+        buffer12.insert(buffer12.end(), ma.begin(), ma.begin() + 12);
+    }
+
+    for (unsigned int n_threads : {1u, 3u})
+    {
+        __plugin::transform_store<aos_layout> store;
+        __plugin::transform_store<soa_layout> soa_store;
+        algebra::transform_store<compact_transform3, vector3, aos_layout> compact_store;
+
+        // Append to a filled store
+        store.push_back(transforms[0]);
+        store.append(buffer16.data() + 16, transforms.size() - 1, 16, n_threads);
+        soa_store.append(buffer12.data(), transforms.size(), 12, n_threads);
+        compact_store.append(buffer16.data(), transforms.size(), 16, n_threads);
+
+        check_store(store, transforms);
+        check_store(soa_store, transforms);
+        check_store(compact_store, std::vector<compact_transform3>(transforms.begin(), transforms.end()));
+    }
+
+    // Unless the transform assumes rigid body transforms, bulk and per-transform
+    // construction agree for general matrices
+    if constexpr (not detail::assumes_isometry<transform3>::value)
+    {
+        // A last row other than (0, 0, 0, 1) is validated like in the transform constructor
+        buffer16[16 * 2 + 15] = 2.;
+        array_s<scalar, 16> ma;
+        std::copy_n(buffer16.data() + 16 * 2, 16, ma.begin());
+        __plugin::transform_store<aos_layout> store;
+        __plugin::transform_store<soa_layout> soa_store;
+        store.append(buffer16.data(), transforms.size(), 16);
+        soa_store.append(buffer16.data(), transforms.size(), 16);
+        const point3 p = {1., -2., 3.};
+        const point3 local_ref = transform3(ma).point_to_local(p);
+        const point3 local = store[2].point_to_local(p);
+        std::vector<point3> soa_local(1);
+        soa_store.point_to_local(std::vector<std::size_t>{2}, std::vector<point3>{p}, soa_local);
+        for (unsigned int j = 0; j < 3; ++j)
+        {
+            ASSERT_NEAR(local[j], local_ref[j], isclose);
+            ASSERT_NEAR(soa_local[0][j], local_ref[j], isclose);
+        }
+
+        // A scaled and sheared matrix is inverted like by the transform constructor, which
+        // is checked independently: x = 2 u + v + 1, y = 4 v + 2, z = w / 2 + 3
+        const array_s<scalar, 16> general = {2., 1., 0., 1., 0., 4., 0., 2., 0., 0., 0.5, 3., 0., 0., 0., 1.};
+        __plugin::transform_store<aos_layout> general_store;
+        __plugin::transform_store<soa_layout> general_soa_store;
+        general_store.append(general.data(), 1, 16);
+        general_soa_store.append(general.data(), 1, 16);
+        const point3 q = {3., 6., 4.};
+        const point3 general_ref = transform3(general).point_to_local(q);
+        const point3 general_local = general_store[0].point_to_local(q);
+        std::vector<point3> general_soa_local(1);
+        general_soa_store.point_to_local(std::vector<std::size_t>{0}, std::vector<point3>{q}, general_soa_local);
+        for (unsigned int j = 0; j < 3; ++j)
+        {
+            ASSERT_NEAR(general_ref[j], j == 0 ? 0.5 : scalar(j), isclose);
+            ASSERT_NEAR(general_local[j], general_ref[j], isclose);
+            ASSERT_NEAR(general_soa_local[0][j], general_ref[j], isclose);
+        }
+    }
+}
+
+// This tests the binary transform file in both data layouts
+TEST(ALGEBRA_PLUGIN, transform_file)
+{
+    const auto transforms = test_transforms(11);
+    __plugin::transform_store<soa_layout> store;
+    for (const auto &trf : transforms)
+    {
+        store.push_back(trf);
+    }
+
+    const std::string path = testing::TempDir() + "algebra_transform_file.bin";
+    for (std::uint32_t layout : {transform_file_header::aos, transform_file_header::soa})
+    {
+        ASSERT_TRUE(write_transform_file(path, store, layout));
+
+        __plugin::transform_file file(path);
+        ASSERT_TRUE(file.is_open());
+        ASSERT_EQ(file.size(), transforms.size());
+        ASSERT_TRUE(file.has_inverse());
+        for (std::size_t i = 0; i < file.size(); ++i)
+        {
+            ASSERT_EQ(file.matrix(i), store.matrix(i));
+            ASSERT_EQ(file.matrix(i, true), store.matrix(i, store.inverse_offset));
+        }
+
+        if (layout == transform_file_header::soa)
+        {
+            // The transforms are used in place
+            const __plugin::transform_view view = file.view<transform3, vector3>();
+            ASSERT_EQ(reinterpret_cast<std::uintptr_t>(file.component(0)) % cache_line_size, 0u);
+            check_store(view, transforms);
+        }
+        else
+        {
+            __plugin::transform_store<aos_layout> loaded;
+            loaded.append(file.matrices(), file.size(), 12);
+            check_store(loaded, transforms);
+        }
+    }
+
+    // Files without the inverses, in another scalar type or truncated are handled
+    ASSERT_TRUE(write_transform_file(path, store, transform_file_header::soa, false));
+    __plugin::transform_file file(path);
+    ASSERT_TRUE(file.is_open());
+    ASSERT_FALSE(file.has_inverse());
+    ASSERT_EQ(file.matrix(3), store.matrix(3));
+    check_store(file.view<transform3, vector3>(), transforms);
+
+    // Writing a view without the inverses writes the transforms only
+    const std::string view_path = testing::TempDir() + "algebra_transform_file_view.bin";
+    ASSERT_TRUE(write_transform_file(view_path, file.view<transform3, vector3>()));
+    __plugin::transform_file view_file(view_path);
+    ASSERT_TRUE(view_file.is_open());
+    ASSERT_FALSE(view_file.has_inverse());
+    for (std::size_t i = 0; i < view_file.size(); ++i)
+    {
+        ASSERT_EQ(view_file.matrix(i), store.matrix(i));
+    }
+    view_file.close();
+    std::remove(view_path.c_str());
+
+    using other_scalar = std::conditional_t<sizeof(scalar) == sizeof(double), float, double>;
+    ASSERT_FALSE(algebra::transform_file<other_scalar>(path).is_open());
+
+    // Corrupted headers: the stride does not cover the transforms or the size overflows
+    const auto corrupt = [&path](std::uint32_t layout, std::uint64_t size, std::uint64_t stride) {
+        transform_file_header header;
+        {
+            std::ifstream in(path, std::ios::binary);
+            in.read(reinterpret_cast<char *>(&header), sizeof(header));
+        }
+        header.layout = layout;
+        header.size = size;
+        header.stride = stride;
+        std::fstream out(path, std::ios::binary | std::ios::in | std::ios::out);
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    };
+    file.close();
+    ASSERT_TRUE(write_transform_file(path, store, transform_file_header::soa));
+    ASSERT_TRUE(file.open(path));
+    const std::uint64_t soa_stride = file.header().stride;
+    file.close();
+    corrupt(transform_file_header::soa, soa_stride + 1, soa_stride);
+    ASSERT_FALSE(file.open(path));
+    corrupt(transform_file_header::soa, 1, std::numeric_limits<std::uint64_t>::max() / 8 + 1);
+    ASSERT_FALSE(file.open(path));
+    corrupt(transform_file_header::aos, 1, 16);
+    ASSERT_FALSE(file.open(path));
+    corrupt(transform_file_header::aos, std::numeric_limits<std::uint64_t>::max() / 4, 12);
+    ASSERT_FALSE(file.open(path));
+    corrupt(transform_file_header::soa, transforms.size(), soa_stride);
+    ASSERT_TRUE(file.open(path));
+
+    std::ofstream(path, std::ios::binary | std::ios::trunc).write("ALGTRF", 6);
+    ASSERT_FALSE(file.open(path));
+    ASSERT_FALSE(__plugin::transform_file("no_such_file.bin").is_open());
+    std::remove(path.c_str());
+}
+
+// This tests the quaternion encoding of transforms, absolute and against nominal transforms
+TEST(ALGEBRA_PLUGIN, transform_codec)
+{
+    const auto nominal = test_transforms(11);
+    auto transforms = nominal;
+    for (std::size_t i = 0; i < transforms.size(); ++i)
+    {
+        transforms[i].apply_delta(vector3{scalar(1e-3 * i), -2e-3, 0.5e-3}, vector3{scalar(0.01 * i), -0.02, 0.03});
+    }
+
+    const auto check = [&transforms](const std::vector<transform3> &decoded, scalar tolerance) {
+        ASSERT_EQ(decoded.size(), transforms.size());
+        const point3 p = {1., -2., 3.};
+        for (std::size_t i = 0; i < transforms.size(); ++i)
+        {
+            const point3 g = decoded[i].point_to_global(p);
+            const point3 g_ref = transforms[i].point_to_global(p);
+            const point3 l = decoded[i].point_to_local(g_ref);
+            for (unsigned int j = 0; j < 3; ++j)
+            {
+                ASSERT_NEAR(g[j], g_ref[j], tolerance);
+                ASSERT_NEAR(l[j], p[j], tolerance);
+            }
+        }
+    };
+
+    // 7 values per transform, in any precision
+    const std::vector<double> data = __plugin::transform_codec::encode<double>(transforms);
+    ASSERT_EQ(data.size(), 7 * transforms.size());
+    std::vector<transform3> decoded;
+    __plugin::transform_codec::decode(data.data(), transforms.size(), std::back_inserter(decoded));
+    check(decoded, isclose);
+
+    const std::vector<float> data_f = __plugin::transform_codec::encode<float>(transforms);
+    decoded.clear();
+    __plugin::transform_codec::decode(data_f.data(), transforms.size(), std::back_inserter(decoded));
+    check(decoded, 1e-4);
+
+    // The corrections are small, so that float storage keeps their precision
+    const std::vector<float> delta_f = __plugin::transform_codec::encode<float>(transforms, nominal);
+    ASSERT_NEAR(delta_f[0], 1., 1e-5);
+    decoded.clear();
+    __plugin::transform_codec::decode(delta_f.data(), transforms.size(), nominal, std::back_inserter(decoded));
+    check(decoded, isclose);
+}
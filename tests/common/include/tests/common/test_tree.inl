@@ -0,0 +1,143 @@
+/** Algebra plugins library, part of the ACTS project
+ *
+ * (c) 2020 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#include "common/types.hpp"
+
+#include <cmath>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+/// @note __plugin has to be defined with a preprocessor command
+using namespace algebra;
+
+// Three-dimensional definitions
+using transform3 = __plugin::transform3;
+using vector3 = __plugin::vector3;
+using point3 = __plugin::point3;
+
+constexpr scalar isclose = 1e-5;
+
+namespace
+{
+    /** A transform with a rotation and a translation that depend on a parameter
+     *
+     * @param i the parameter
+     **/
+    transform3 test_transform(scalar i)
+    {
+        vector3 z = vector::normalize(vector3{1., scalar(0.2 * i), 2.});
+        vector3 x = vector::normalize(vector::cross(z, vector3{scalar(0.3 * i), 1., -0.5}));
+        return transform3(point3{i, scalar(2. - i), scalar(0.5 * i)}, z, x);
+    }
+
+    /** Check the global transform of a tree node against the product of the local transforms
+     *
+     * @param tree the transform tree
+     * @param index the node index
+     **/
+    void check_global(const __plugin::transform_tree &tree, std::size_t index)
+    {
+        const point3 lpoint = {1., -2., 3.};
+
+        // Apply the local transforms from the node up to the root
+        point3 gpoint = lpoint;
+        for (std::size_t i = index; i != __plugin::transform_tree::no_node; i = tree.parent(i))
+        {
+            gpoint = tree.local(i).point_to_global(gpoint);
+        }
+
+        const transform3 &trf = tree.global(index);
+        const point3 gpoint_t = trf.point_to_global(lpoint);
+        ASSERT_NEAR(gpoint_t[0], gpoint[0], isclose);
+        ASSERT_NEAR(gpoint_t[1], gpoint[1], isclose);
+        ASSERT_NEAR(gpoint_t[2], gpoint[2], isclose);
+
+        // The cached inverse is consistent
+        const point3 lpoint_r = trf.point_to_local(gpoint);
+        ASSERT_NEAR(lpoint_r[0], lpoint[0], isclose);
+        ASSERT_NEAR(lpoint_r[1], lpoint[1], isclose);
+        ASSERT_NEAR(lpoint_r[2], lpoint[2], isclose);
+    }
+} // namespace
+
+// This tests the lazy composition of the global transforms
+TEST(ALGEBRA_PLUGIN, transform_tree)
+{
+    // One volume with two layers of three modules
+    __plugin::transform_tree tree;
+    const std::size_t volume = tree.add(test_transform(1.));
+    std::vector<std::size_t> layers, modules;
+    for (unsigned int l = 0; l < 2; ++l)
+    {
+        layers.push_back(tree.add(test_transform(2. + l), volume));
+        for (unsigned int m = 0; m < 3; ++m)
+        {
+            modules.push_back(tree.add(test_transform(-1. - m), layers.back()));
+        }
+    }
+    ASSERT_EQ(tree.size(), 9u);
+    ASSERT_EQ(tree.parent(volume), __plugin::transform_tree::no_node);
+    ASSERT_EQ(tree.parent(modules[4]), layers[1]);
+
+    // Only the root is known before the first use
+    ASSERT_TRUE(tree.is_valid(volume));
+    ASSERT_FALSE(tree.is_valid(layers[0]));
+
+    // A module pulls in its layer, but not the other layer
+    check_global(tree, modules[1]);
+    ASSERT_TRUE(tree.is_valid(layers[0]));
+    ASSERT_FALSE(tree.is_valid(layers[1]));
+    ASSERT_FALSE(tree.is_valid(modules[0]));
+
+    tree.flatten();
+    for (std::size_t i = 0; i < tree.size(); ++i)
+    {
+        ASSERT_TRUE(tree.is_valid(i));
+        check_global(tree, i);
+    }
+}
+
+// This tests the invalidation of a subtree after an alignment update
+TEST(ALGEBRA_PLUGIN, transform_tree_update)
+{
+    __plugin::transform_tree tree;
+    const std::size_t volume = tree.add(test_transform(1.));
+    const std::size_t layer0 = tree.add(test_transform(2.), volume);
+    const std::size_t layer1 = tree.add(test_transform(3.), volume);
+    const std::size_t module0 = tree.add(test_transform(-1.), layer0);
+    const std::size_t module1 = tree.add(test_transform(-2.), layer1);
+    const std::size_t sensor0 = tree.add(test_transform(0.5), module0);
+    tree.flatten();
+
+    // Only the subtree of the updated layer is recomputed
+    tree.set_local(layer0, test_transform(4.));
+    ASSERT_TRUE(tree.is_valid(volume));
+    ASSERT_FALSE(tree.is_valid(layer0));
+    ASSERT_FALSE(tree.is_valid(module0));
+    ASSERT_FALSE(tree.is_valid(sensor0));
+    ASSERT_TRUE(tree.is_valid(layer1));
+    ASSERT_TRUE(tree.is_valid(module1));
+
+    check_global(tree, sensor0);
+    check_global(tree, module1);
+
+    // An update of the root reaches all nodes
+    tree.set_local(volume, test_transform(5.));
+    for (std::size_t i = 0; i < tree.size(); ++i)
+    {
+        ASSERT_FALSE(tree.is_valid(i));
+    }
+    tree.flatten();
+    for (std::size_t i = 0; i < tree.size(); ++i)
+    {
+        check_global(tree, i);
+    }
+
+    tree.clear();
+    ASSERT_TRUE(tree.empty());
+}
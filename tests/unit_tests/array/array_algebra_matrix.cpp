@@ -0,0 +1,161 @@
+/** Algebra plugins library, part of the ACTS project
+ *
+ * (c) 2020 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#include "algebra/definitions/array.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+using namespace algebra;
+
+template <unsigned int kROWS, unsigned int kCOLS>
+using array_matrix = array::matrix<kROWS, kCOLS>;
+
+constexpr scalar isclose = 1e-5;
+
+namespace
+{
+    /** A matrix with distinct elements
+     *
+     * @param offset added to all elements
+     **/
+    template <unsigned int kROWS, unsigned int kCOLS>
+    array_matrix<kROWS, kCOLS> test_matrix(scalar offset = 0.)
+    {
+        array_matrix<kROWS, kCOLS> m;
+        for (unsigned int r = 0; r < kROWS; ++r)
+        {
+            for (unsigned int c = 0; c < kCOLS; ++c)
+            {
+                m(r, c) = offset + 0.5 * r - 0.25 * c + 0.1 * r * c;
+            }
+        }
+        return m;
+    }
+} // namespace
+
+// This tests the element access and the column major layout
+TEST(array, matrix_access)
+{
+    auto m = array_matrix<6, 8>::zero();
+    m(2, 5) = 3.;
+    ASSERT_EQ(m._data[5 * 6 + 2], 3.);
+    ASSERT_EQ(m.column(5)[2], 3.);
+
+    const auto one = array_matrix<8, 6>::identity();
+    for (unsigned int r = 0; r < 8; ++r)
+    {
+        for (unsigned int c = 0; c < 6; ++c)
+        {
+            ASSERT_EQ(one(r, c), r == c ? 1. : 0.);
+        }
+    }
+
+    array_matrix<6, 1> v = array_matrix<6, 1>::zero();
+    v[4] = 2.;
+    ASSERT_EQ(v(4, 0), 2.);
+}
+
+// This tests the arithmetic operators against explicit loops
+TEST(array, matrix_arithmetic)
+{
+    const auto a = test_matrix<6, 8>();
+    const auto b = test_matrix<6, 8>(1.);
+
+    const auto sum = a + b;
+    const auto diff = a - b;
+    const auto scaled = 2. * a / 4.;
+    const auto neg = -a;
+    for (unsigned int r = 0; r < 6; ++r)
+    {
+        for (unsigned int c = 0; c < 8; ++c)
+        {
+            ASSERT_NEAR(sum(r, c), a(r, c) + b(r, c), isclose);
+            ASSERT_NEAR(diff(r, c), -1., isclose);
+            ASSERT_NEAR(scaled(r, c), 0.5 * a(r, c), isclose);
+            ASSERT_EQ(neg(r, c), -a(r, c));
+        }
+    }
+
+    // Free to bound jacobian times free covariance times its transpose
+    const auto j = test_matrix<6, 8>();
+    const auto cov = test_matrix<8, 8>(2.);
+    const array_matrix<8, 6> jt = j.transpose();
+    const array_matrix<6, 6> bound = j * cov * jt;
+    for (unsigned int r = 0; r < 6; ++r)
+    {
+        for (unsigned int c = 0; c < 6; ++c)
+        {
+            scalar expected = 0.;
+            for (unsigned int k = 0; k < 8; ++k)
+            {
+                for (unsigned int l = 0; l < 8; ++l)
+                {
+                    expected += j(r, k) * cov(k, l) * j(c, l);
+                }
+            }
+            ASSERT_NEAR(bound(r, c), expected, isclose * std::abs(expected));
+            ASSERT_EQ(jt(c, r), j(r, c));
+        }
+    }
+
+    // The identity is neutral
+    using identity6 = array_matrix<6, 6>;
+    using identity8 = array_matrix<8, 8>;
+    ASSERT_TRUE(identity6::identity() * j == j);
+    ASSERT_TRUE(j * identity8::identity() == j);
+}
+
+// This tests the block extraction and insertion
+TEST(array, matrix_blocks)
+{
+    const auto m = test_matrix<8, 8>();
+    const array_matrix<3, 2> b = m.block<3, 2>(4, 5);
+    for (unsigned int r = 0; r < 3; ++r)
+    {
+        for (unsigned int c = 0; c < 2; ++c)
+        {
+            ASSERT_EQ(b(r, c), m(4 + r, 5 + c));
+        }
+    }
+
+    auto n = array_matrix<8, 8>::zero();
+    n.set_block(4, 5, b);
+    const array_matrix<3, 2> nb = n.block<3, 2>(4, 5);
+    ASSERT_TRUE(nb == b);
+    ASSERT_EQ(n(3, 5), 0.);
+    ASSERT_EQ(n(4, 7), 0.);
+
+    // A column vector
+    const array_matrix<8, 1> col = m.block<8, 1>(0, 2);
+    ASSERT_EQ(col[6], m(6, 2));
+}
+
+// This tests the packed storage of the symmetric matrices
+TEST(array, symmetric_matrix_storage)
+{
+    static_assert(sizeof(array::symmetric_matrix<6>) == 21 * sizeof(scalar), "Only the lower triangle is stored");
+
+    auto a = test_matrix<5, 5>();
+    a = a + a.transpose();
+    const auto s = array::symmetric_matrix<5>::from_lower(a);
+    ASSERT_TRUE(s.full() == a);
+    ASSERT_EQ(s(1, 3), a(3, 1));
+
+    // The similarity transform agrees with the full matrix products
+    const auto j = test_matrix<3, 5>();
+    const array_matrix<3, 3> expected = j * a * j.transpose();
+    const auto bound = matrix::similarity(j, s);
+    for (unsigned int r = 0; r < 3; ++r)
+    {
+        for (unsigned int c = 0; c < 3; ++c)
+        {
+            ASSERT_NEAR(bound(r, c), expected(r, c), isclose * std::abs(expected(r, c)));
+        }
+    }
+}
@@ -0,0 +1,9 @@
+/** Algebra plugin library, part of the ACTS project
+ * 
+ * (c) 2020 CERN for the benefit of the ACTS project
+ * 
+ * Mozilla Public License Version 2.0
+ */
+
+#include "algebra/definitions/array.hpp"
+#include "tests/common/test_tree.inl"
@@ -7,3 +7,44 @@
 
 #include "algebra/definitions/vc_array.hpp"
 #include "tests/common/test_plugin.inl"
+
+// This tests the column-wise rotation and submatrix access of the vc_array plugin
+TEST(vc_array, rotation_block)
+{
+    vector3 z = vector::normalize(vector3{3., 2., 1.});
+    vector3 x = vector::normalize(vector3{2., -3., 0.});
+    vector3 y = vector::cross(z, x);
+    point3 t = {2., 3., 4.};
+    transform3 trf(t, z, x);
+
+    const transform3::matrix33 rot = trf.rotation();
+    const auto m = trf.matrix();
+    const auto blk = getter::block<2, 2>(m, 1, 2);
+    const auto col = getter::vector<3>(m, 1, 3);
+
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+        ASSERT_NEAR(rot.x[i], x[i], isclose);
+        ASSERT_NEAR(rot.y[i], y[i], isclose);
+        ASSERT_NEAR(rot.z[i], z[i], isclose);
+    }
+
+    // Rows 1, 2 of columns 2, 3
+    ASSERT_NEAR(blk.x[0], z[1], isclose);
+    ASSERT_NEAR(blk.x[1], z[2], isclose);
+    ASSERT_NEAR(blk.y[0], t[1], isclose);
+    ASSERT_NEAR(blk.y[1], t[2], isclose);
+    for (unsigned int i = 2; i < 4; ++i)
+    {
+        ASSERT_EQ(blk.x[i], 0.);
+        ASSERT_EQ(blk.y[i], 0.);
+        ASSERT_EQ(blk.z[i], 0.);
+        ASSERT_EQ(blk.t[i], 0.);
+    }
+
+    // Rows 1, 2, 3 of the translation column
+    ASSERT_NEAR(col[0], t[1], isclose);
+    ASSERT_NEAR(col[1], t[2], isclose);
+    ASSERT_NEAR(col[2], 1., isclose);
+    ASSERT_EQ(col[3], 0.);
+}
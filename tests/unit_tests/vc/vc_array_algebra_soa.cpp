@@ -0,0 +1,237 @@
+/** Algebra plugins library, part of the ACTS project
+ *
+ * (c) 2020 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#include "algebra/definitions/vc_array.hpp"
+
+#include <cmath>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace algebra;
+
+using transform3 = vc_array::transform3;
+using vector3 = vc_array::vector3;
+using point3 = vc_array::point3;
+
+constexpr scalar isclose = 1e-5;
+constexpr std::size_t n_lanes = simd::scalar_v::size();
+
+namespace
+{
+    /** One point per simd lane, all of them different */
+    std::vector<point3> lane_points()
+    {
+        std::vector<point3> points;
+        for (std::size_t i = 0; i < n_lanes; ++i)
+        {
+            points.push_back(point3{scalar(1. + i), scalar(2. - 0.5 * i), scalar(0.25 * i - 1.)});
+        }
+        return points;
+    }
+} // namespace
+
+// This defines the structure-of-arrays vector test suite
+TEST(vc_array, soa_vector3)
+{
+    const auto points = lane_points();
+    const simd::vector3_v v = simd::load3(points, 0);
+    const simd::vector3_v w = v * 2. - v;
+
+    const auto dots = vector::dot(v, w);
+    const auto crosses = vector::cross(v, simd::vector3_v{v.y, v.z, v.x});
+    const auto normalized = vector::normalize(v);
+    const auto phis = getter::phi(v);
+    const auto thetas = getter::theta(v);
+    const auto etas = getter::eta(v);
+    const auto phis_fast = getter::phi(v, math::fast_precision{});
+    const auto thetas_fast = getter::theta(v, math::fast_precision{});
+    const auto etas_fast = getter::eta(v, math::fast_precision{});
+    const auto perps = getter::perp(v);
+    const auto norms = getter::norm(v);
+
+    for (std::size_t i = 0; i < n_lanes; ++i)
+    {
+        const point3 &p = points[i];
+        const vector3 rotated{p[1], p[2], p[0]};
+        const vector3 cross = vector::cross(p, rotated);
+        const vector3 unit = vector::normalize(p);
+
+        ASSERT_NEAR(dots[i], vector::dot(p, p), isclose);
+        ASSERT_NEAR(crosses.x[i], cross[0], isclose);
+        ASSERT_NEAR(crosses.y[i], cross[1], isclose);
+        ASSERT_NEAR(crosses.z[i], cross[2], isclose);
+        ASSERT_NEAR(normalized.x[i], unit[0], isclose);
+        ASSERT_NEAR(normalized.y[i], unit[1], isclose);
+        ASSERT_NEAR(normalized.z[i], unit[2], isclose);
+        ASSERT_NEAR(phis[i], getter::phi(p), isclose);
+        ASSERT_NEAR(thetas[i], getter::theta(p), isclose);
+        ASSERT_NEAR(etas[i], getter::eta(p), isclose);
+        ASSERT_NEAR(phis_fast[i], getter::phi(p), isclose);
+        ASSERT_NEAR(thetas_fast[i], getter::theta(p), isclose);
+        ASSERT_NEAR(etas_fast[i], getter::eta(p), isclose);
+        ASSERT_NEAR(perps[i], getter::perp(p), isclose);
+        ASSERT_NEAR(norms[i], getter::norm(p), isclose);
+    }
+}
+
+// This tests the structure-of-arrays transforms
+TEST(vc_array, soa_transformations)
+{
+    vector3 z = vector::normalize(vector3{3., 2., 1.});
+    vector3 x = vector::normalize(vector3{2., -3., 0.});
+    point3 t = {2., 3., 4.};
+    transform3 trf(t, z, x);
+
+    const auto points = lane_points();
+    const simd::point3_v v = simd::load3(points, 0);
+
+    std::vector<point3> gpoints(n_lanes), lpoints(n_lanes), gvectors(n_lanes);
+    simd::store3(trf.point_to_global(v), gpoints, 0);
+    simd::store3(trf.point_to_local(trf.point_to_global(v)), lpoints, 0);
+    simd::store3(trf.vector_to_global(v), gvectors, 0);
+
+    for (std::size_t i = 0; i < n_lanes; ++i)
+    {
+        const point3 gpoint = trf.point_to_global(points[i]);
+        const vector3 gvector = trf.vector_to_global(points[i]);
+        for (unsigned int j = 0; j < 3; ++j)
+        {
+            ASSERT_NEAR(gpoints[i][j], gpoint[j], isclose);
+            ASSERT_NEAR(lpoints[i][j], points[i][j], isclose);
+            ASSERT_NEAR(gvectors[i][j], gvector[j], isclose);
+        }
+    }
+
+    // Partially filled simd vectors
+    const simd::point3_v partial = simd::load3(points, 0, 1);
+    ASSERT_NEAR(partial.x[0], points[0][0], isclose);
+    for (std::size_t i = 1; i < n_lanes; ++i)
+    {
+        ASSERT_EQ(partial.x[i], 0.);
+    }
+}
+
+// This tests the elementary functions on simd vectors against their scalar versions
+TEST(vc_array, soa_math)
+{
+    const auto points = lane_points();
+    const simd::vector3_v v = simd::load3(points, 0);
+
+    const simd::scalar_v atan2_fast = math::atan2(v.y, v.x, math::fast_precision{});
+    const simd::scalar_v atan2_full = math::atan2(v.y, v.x, math::full_precision{});
+    const simd::scalar_v cos_theta = v.z / getter::norm(v);
+    const simd::scalar_v atanh_fast = math::atanh(cos_theta, math::fast_precision{});
+    const simd::scalar_v rsqrt_fast = math::rsqrt(v.x, math::fast_precision{});
+    simd::scalar_v s, c;
+    math::sincos(v.x, s, c, math::fast_precision{});
+
+    for (std::size_t i = 0; i < n_lanes; ++i)
+    {
+        const point3 &p = points[i];
+        const scalar ct = p[2] / getter::norm(p);
+        ASSERT_NEAR(atan2_fast[i], std::atan2(p[1], p[0]), isclose);
+        ASSERT_NEAR(atan2_full[i], std::atan2(p[1], p[0]), isclose);
+        ASSERT_NEAR(atanh_fast[i], std::atanh(ct), isclose);
+        ASSERT_NEAR(rsqrt_fast[i], 1. / std::sqrt(p[0]), isclose);
+        ASSERT_NEAR(s[i], std::sin(p[0]), isclose);
+        ASSERT_NEAR(c[i], std::cos(p[0]), isclose);
+    }
+}
+
+// This tests the fused spherical coordinates getter on structure-of-arrays vectors
+TEST(vc_array, soa_spherical)
+{
+    const auto points = lane_points();
+    const simd::vector3_v v = simd::load3(points, 0);
+    const auto sph = getter::spherical(v);
+
+    for (std::size_t i = 0; i < n_lanes; ++i)
+    {
+        const point3 &p = points[i];
+        ASSERT_NEAR(sph.phi[i], getter::phi(p), isclose);
+        ASSERT_NEAR(sph.theta[i], getter::theta(p), isclose);
+        ASSERT_NEAR(sph.eta[i], getter::eta(p), isclose);
+        ASSERT_NEAR(sph.perp[i], getter::perp(p), isclose);
+        ASSERT_NEAR(sph.norm[i], getter::norm(p), isclose);
+    }
+}
+
+// This tests the matrices of several tracks against the matrices of single tracks
+TEST(vc_array, soa_matrix)
+{
+    using jacobian = vc_array::matrix<6, 6>;
+    using covariance = vc_array::symmetric_matrix<6>;
+
+    std::vector<jacobian> jacobians(n_lanes);
+    std::vector<covariance> covariances(n_lanes);
+    for (std::size_t i = 0; i < n_lanes; ++i)
+    {
+        for (unsigned int r = 0; r < 6; ++r)
+        {
+            for (unsigned int c = 0; c < 6; ++c)
+            {
+                jacobians[i](r, c) = r == c ? 1. : 0.1 * (1. + i) / (1. + r + c);
+            }
+            for (unsigned int c = 0; c <= r; ++c)
+            {
+                covariances[i](r, c) = r == c ? 4. + i + r : 0.5 / (1. + r + c + i);
+            }
+        }
+    }
+
+    const simd::matrix_v<6, 6> j = simd::load_matrix(jacobians, 0);
+    const simd::symmetric_matrix_v<6> cov = simd::load_matrix(covariances, 0);
+    const simd::matrix_v<6, 6> jj = j * j;
+    const simd::symmetric_matrix_v<6> transported = matrix::similarity(j, cov);
+    const simd::symmetric_matrix_v<6> cov_inv = matrix::invert(cov);
+
+    std::vector<jacobian> jjs(n_lanes);
+    std::vector<covariance> transporteds(n_lanes), cov_invs(n_lanes);
+    simd::store_matrix(jj, jjs, 0);
+    simd::store_matrix(transported, transporteds, 0);
+    simd::store_matrix(cov_inv, cov_invs, 0);
+    for (std::size_t i = 0; i < n_lanes; ++i)
+    {
+        const jacobian jj_expected = jacobians[i] * jacobians[i];
+        const covariance transported_expected = matrix::similarity(jacobians[i], covariances[i]);
+        const covariance cov_inv_expected = matrix::invert(covariances[i]);
+        for (unsigned int r = 0; r < 6; ++r)
+        {
+            for (unsigned int c = 0; c < 6; ++c)
+            {
+                ASSERT_NEAR(jjs[i](r, c), jj_expected(r, c), isclose);
+                ASSERT_NEAR(transporteds[i](r, c), transported_expected(r, c), isclose);
+                ASSERT_NEAR(cov_invs[i](r, c), cov_inv_expected(r, c), isclose);
+            }
+        }
+    }
+
+    // Only the active tracks are updated
+    const simd::scalar_v lanes = simd::scalar_v::generate([](auto i) { return scalar(i); });
+    const simd::mask_v active = lanes < scalar(n_lanes / 2);
+    simd::symmetric_matrix_v<6> updated = cov;
+    simd::assign(active, updated, transported);
+    const simd::symmetric_matrix_v<6> selected = simd::select(active, transported, cov);
+    for (std::size_t i = 0; i < n_lanes; ++i)
+    {
+        for (unsigned int k = 0; k < covariance::size; ++k)
+        {
+            const scalar expected = i < n_lanes / 2 ? transported._data[k][i] : cov._data[k][i];
+            ASSERT_EQ(updated._data[k][i], expected);
+            ASSERT_EQ(selected._data[k][i], expected);
+        }
+    }
+
+    // Partially filled batches hold the identity in the unused lanes
+    const simd::symmetric_matrix_v<6> partial = simd::load_matrix(covariances, 0, 1);
+    for (std::size_t i = 1; i < n_lanes; ++i)
+    {
+        ASSERT_EQ(partial(0, 0)[i], 1.);
+        ASSERT_EQ(partial(1, 0)[i], 0.);
+    }
+}